@@ -0,0 +1,110 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include "smooth/core/network/IPacketAssembly.h"
+#include "smooth/core/network/IPacketDisassembly.h"
+
+namespace smooth::benchmark::socket_soak
+{
+    class EchoProtocol;
+
+    /// A fixed size message carrying the time it was sent, echoed back unchanged by the server.
+    class EchoPacket
+        : public smooth::core::network::IPacketDisassembly
+    {
+        public:
+            static constexpr int Size = 64;
+
+            using Clock = std::chrono::steady_clock;
+
+            int get_send_length() override
+            {
+                return Size;
+            }
+
+            const uint8_t* get_data() override
+            {
+                return data.data();
+            }
+
+            void set_timestamp(Clock::time_point t)
+            {
+                auto ticks = t.time_since_epoch().count();
+                std::memcpy(data.data(), &ticks, sizeof(ticks));
+            }
+
+            Clock::time_point get_timestamp() const
+            {
+                Clock::rep ticks{};
+                std::memcpy(&ticks, data.data(), sizeof(ticks));
+
+                return Clock::time_point{ Clock::duration{ ticks } };
+            }
+
+        private:
+            friend EchoProtocol;
+
+            std::array<uint8_t, Size> data{};
+            int received{ 0 };
+    };
+
+    class EchoProtocol
+        : public smooth::core::network::IPacketAssembly<EchoProtocol, EchoPacket>
+    {
+        public:
+            using packet_type = EchoPacket;
+
+            int get_wanted_amount(packet_type& packet) override
+            {
+                return EchoPacket::Size - packet.received;
+            }
+
+            void data_received(packet_type& packet, int length) override
+            {
+                packet.received += length;
+            }
+
+            uint8_t* get_write_pos(packet_type& packet) override
+            {
+                return packet.data.data() + packet.received;
+            }
+
+            bool is_complete(packet_type& packet) const override
+            {
+                return packet.received == EchoPacket::Size;
+            }
+
+            bool is_error() override
+            {
+                return false;
+            }
+
+            void packet_consumed() override
+            {
+            }
+
+            void reset() override
+            {
+            }
+    };
+}
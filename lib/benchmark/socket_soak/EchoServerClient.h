@@ -0,0 +1,72 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include "smooth/core/network/ServerClient.h"
+#include "EchoProtocol.h"
+
+namespace smooth::benchmark::socket_soak
+{
+    /// Server side of a soak connection; sends every received message straight back.
+    class EchoServerClient
+        : public smooth::core::network::ServerClient<EchoServerClient, EchoProtocol, void>
+    {
+        public:
+            EchoServerClient(smooth::core::Task& task,
+                             smooth::core::network::ClientPool<EchoServerClient>& pool)
+                    : smooth::core::network::ServerClient<EchoServerClient, EchoProtocol, void>(
+                        task,
+                        pool,
+                        std::make_unique<EchoProtocol>())
+            {
+            }
+
+            void event(const smooth::core::network::event::DataAvailableEvent<EchoProtocol>& event) override
+            {
+                EchoPacket packet;
+
+                if (event.get(packet))
+                {
+                    container->get_tx_buffer().put(packet);
+                }
+            }
+
+            void event(const smooth::core::network::event::TransmitBufferEmptyEvent& /*event*/) override
+            {
+            }
+
+            void connected() override
+            {
+            }
+
+            void disconnected() override
+            {
+            }
+
+            void reset_client() override
+            {
+            }
+
+            std::chrono::milliseconds get_send_timeout() override
+            {
+                return std::chrono::seconds{ 5 };
+            }
+    };
+}
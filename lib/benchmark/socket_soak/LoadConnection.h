@@ -0,0 +1,122 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include "smooth/core/Task.h"
+#include "smooth/core/network/BufferContainer.h"
+#include "smooth/core/network/Socket.h"
+#include "smooth/core/network/SecureSocket.h"
+#include "smooth/core/network/MbedTLSContext.h"
+#include "EchoProtocol.h"
+#include "SoakStatistics.h"
+
+namespace smooth::benchmark::socket_soak
+{
+    /// Client side of a soak connection. Keeps exactly one message in flight (ping-pong), so the
+    /// message rate is limited by the round-trip time through the SocketDispatcher.
+    class LoadConnection
+        : public smooth::core::ipc::IEventListener<smooth::core::network::event::DataAvailableEvent<EchoProtocol>>,
+        public smooth::core::ipc::IEventListener<smooth::core::network::event::TransmitBufferEmptyEvent>,
+        public smooth::core::ipc::IEventListener<smooth::core::network::event::ConnectionStatusEvent>
+    {
+        public:
+            LoadConnection(smooth::core::Task& task, SoakStatistics& stats)
+                    : stats(stats),
+                      container(std::make_shared<smooth::core::network::BufferContainer<EchoProtocol>>(
+                                    task, *this, *this, *this, std::make_unique<EchoProtocol>()))
+            {
+            }
+
+            /// Connects to the server, using TLS when a client configuration is given.
+            void start(std::shared_ptr<smooth::core::network::InetAddress> address,
+                       const std::shared_ptr<smooth::core::network::MBedTLSContext>& tls)
+            {
+                running = true;
+
+                if (tls)
+                {
+                    socket = smooth::core::network::SecureSocket<EchoProtocol>::create(container,
+                                                                                      tls->create_context());
+                }
+                else
+                {
+                    socket = smooth::core::network::Socket<EchoProtocol>::create(container);
+                }
+
+                socket->start(std::move(address));
+            }
+
+            void stop()
+            {
+                running = false;
+
+                if (socket)
+                {
+                    socket->stop("Soak round complete");
+                }
+            }
+
+            void event(const smooth::core::network::event::DataAvailableEvent<EchoProtocol>& event) override
+            {
+                EchoPacket packet;
+
+                if (event.get(packet))
+                {
+                    stats.round_trip(EchoPacket::Clock::now() - packet.get_timestamp());
+
+                    if (running)
+                    {
+                        send_next();
+                    }
+                }
+            }
+
+            void event(const smooth::core::network::event::TransmitBufferEmptyEvent& /*event*/) override
+            {
+            }
+
+            void event(const smooth::core::network::event::ConnectionStatusEvent& event) override
+            {
+                if (event.is_connected())
+                {
+                    stats.connected();
+                    send_next();
+                }
+                else if (running)
+                {
+                    // Lost before the round was over.
+                    stats.disconnected();
+                }
+            }
+
+        private:
+            void send_next()
+            {
+                EchoPacket packet;
+                packet.set_timestamp(EchoPacket::Clock::now());
+                socket->send(packet);
+            }
+
+            SoakStatistics& stats;
+            std::shared_ptr<smooth::core::network::BufferContainer<EchoProtocol>> container;
+            std::shared_ptr<smooth::core::network::Socket<EchoProtocol>> socket{};
+            std::atomic<bool> running{ false };
+    };
+}
@@ -0,0 +1,119 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace smooth::benchmark::socket_soak
+{
+    /// Collects connection and round-trip figures reported by the load connections.
+    /// Written from the client task, read from the main thread.
+    class SoakStatistics
+    {
+        public:
+            struct Summary
+            {
+                std::size_t connected{ 0 };
+                std::size_t disconnected{ 0 };
+                std::size_t messages{ 0 };
+                std::chrono::nanoseconds p50{ 0 };
+                std::chrono::nanoseconds p99{ 0 };
+                std::chrono::nanoseconds p999{ 0 };
+            };
+
+            void reset()
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                connected_count = 0;
+                disconnected_count = 0;
+                round_trips.clear();
+            }
+
+            /// Starts a new measurement window; round trips recorded so far are discarded.
+            void begin_window()
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                round_trips.clear();
+            }
+
+            void connected()
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                ++connected_count;
+            }
+
+            void disconnected()
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                ++disconnected_count;
+            }
+
+            void round_trip(std::chrono::nanoseconds duration)
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                round_trips.push_back(duration.count());
+            }
+
+            std::size_t get_connected() const
+            {
+                std::lock_guard<std::mutex> lock(guard);
+
+                return connected_count;
+            }
+
+            Summary summarize()
+            {
+                std::lock_guard<std::mutex> lock(guard);
+
+                Summary res{};
+                res.connected = connected_count;
+                res.disconnected = disconnected_count;
+                res.messages = round_trips.size();
+
+                std::sort(round_trips.begin(), round_trips.end());
+                res.p50 = percentile(0.5);
+                res.p99 = percentile(0.99);
+                res.p999 = percentile(0.999);
+
+                return res;
+            }
+
+        private:
+            std::chrono::nanoseconds percentile(double p) const
+            {
+                std::chrono::nanoseconds res{ 0 };
+
+                if (!round_trips.empty())
+                {
+                    auto index = static_cast<std::size_t>(p * static_cast<double>(round_trips.size() - 1));
+                    res = std::chrono::nanoseconds{ round_trips[index] };
+                }
+
+                return res;
+            }
+
+            mutable std::mutex guard{};
+            std::size_t connected_count{ 0 };
+            std::size_t disconnected_count{ 0 };
+            std::vector<int64_t> round_trips{};
+    };
+}
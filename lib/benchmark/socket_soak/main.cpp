@@ -0,0 +1,366 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/// Loopback soak benchmark for ServerSocket/Socket/SocketDispatcher.
+///
+/// Starts an echo server and, for each requested connection count, connects that many clients over
+/// loopback, each keeping one message in flight. Reports connections per second, messages per second,
+/// round-trip percentiles, SocketDispatcher CPU time and peak RSS per connection count.
+///
+/// The client connections are serviced by the same SocketDispatcher as the server, so the dispatcher
+/// CPU time is that of the whole dispatcher thread, covering both ends of each connection. The peak RSS
+/// is that of the round only: the kernel's high-water mark is reset before each round where possible,
+/// otherwise the resident set is sampled during the round.
+///
+/// Usage: socket_soak [--connections 1,10,100] [--duration seconds] [--port port]
+///                    [--tls cert.pem key.pem] [--handshake-workers count]
+///
+/// With --tls, the server uses the given certificate and key (PEM); a self-signed pair will do:
+///   openssl req -x509 -newkey ec -pkeyopt ec_paramgen_curve:prime256v1 -nodes -subj /CN=localhost
+///               -keyout key.pem -out cert.pem
+///
+/// Note that server and client sockets share the dispatcher's select() set, which limits the number
+/// of connections to roughly FD_SETSIZE / 2.
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fmt/format.h>
+#include "smooth/core/Task.h"
+#include "smooth/core/task_priorities.h"
+#include "smooth/core/ipc/Publisher.h"
+#include "smooth/core/network/IPv4.h"
+#include "smooth/core/network/NetworkStatus.h"
+#include "smooth/core/network/ServerSocket.h"
+#include "smooth/core/network/SecureServerSocket.h"
+#include "smooth/core/network/CryptoWorkerPool.h"
+#include "smooth/core/network/SocketDispatcher.h"
+#include "EchoServerClient.h"
+#include "LoadConnection.h"
+#include "SoakStatistics.h"
+
+using namespace std::chrono;
+using namespace smooth::core;
+using namespace smooth::core::network;
+using namespace smooth::benchmark::socket_soak;
+
+namespace
+{
+    class SoakTask
+        : public Task
+    {
+        public:
+            explicit SoakTask(std::string task_name)
+                    : Task(std::move(task_name), 16384, APPLICATION_BASE_PRIO, seconds{ 1 })
+            {
+            }
+    };
+
+    struct Settings
+    {
+        std::vector<std::size_t> connections{ 1, 10, 50, 100, 250 };
+        seconds duration{ 5 };
+        uint16_t port{ 8555 };
+        std::string certificate{};
+        std::string key{};
+        std::size_t handshake_workers{ 0 };
+    };
+
+    bool parse_arguments(int argc, char* argv[], Settings& settings)
+    {
+        bool res = true;
+
+        for (int i = 1; res && i < argc; ++i)
+        {
+            std::string arg{ argv[i] };
+            bool has_value = i + 1 < argc;
+
+            if (arg == "--connections" && has_value)
+            {
+                settings.connections.clear();
+                std::stringstream list{ argv[++i] };
+                std::string item;
+
+                while (std::getline(list, item, ','))
+                {
+                    settings.connections.push_back(std::stoul(item));
+                }
+            }
+            else if (arg == "--duration" && has_value)
+            {
+                settings.duration = seconds{ std::stol(argv[++i]) };
+            }
+            else if (arg == "--port" && has_value)
+            {
+                settings.port = static_cast<uint16_t>(std::stoul(argv[++i]));
+            }
+            else if (arg == "--tls" && i + 2 < argc)
+            {
+                settings.certificate = argv[++i];
+                settings.key = argv[++i];
+            }
+            else if (arg == "--handshake-workers" && has_value)
+            {
+                settings.handshake_workers = std::stoul(argv[++i]);
+            }
+            else
+            {
+                fmt::print(stderr, "Unknown or incomplete argument: {}\n", arg);
+                res = false;
+            }
+        }
+
+        return res && !settings.connections.empty();
+    }
+
+    std::vector<unsigned char> read_pem(const std::string& path)
+    {
+        std::ifstream file{ path, std::ios::binary };
+        std::vector<unsigned char> res{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+
+        // mbedTLS requires PEM data to be null terminated.
+        res.push_back(0);
+
+        return res;
+    }
+
+    /// Reads a memory figure, in KiB, from /proc/self/status, e.g. "VmRSS".
+    long read_memory_status(const std::string& name)
+    {
+        std::ifstream status{ "/proc/self/status" };
+        std::string line{};
+        long res = 0;
+
+        while (res == 0 && std::getline(status, line))
+        {
+            if (line.compare(0, name.size() + 1, name + ":") == 0)
+            {
+                res = std::stol(line.substr(name.size() + 1));
+            }
+        }
+
+        return res;
+    }
+
+    /// Tracks the peak RSS of a single round. getrusage()'s ru_maxrss only ever grows within the
+    /// process, so the high-water mark (VmHWM) is reset instead, which requires Linux 4.0 or later.
+    /// Without that, the peak is the largest of the samples taken during the round.
+    class PeakRSS
+    {
+        public:
+            void reset()
+            {
+                std::ofstream clear_refs{ "/proc/self/clear_refs" };
+                clear_refs << "5";
+                clear_refs.flush();
+                high_water_mark_reset = clear_refs.good();
+                sampled = 0;
+                sample();
+            }
+
+            void sample()
+            {
+                sampled = std::max(sampled, read_memory_status("VmRSS"));
+            }
+
+            long get() const
+            {
+                return high_water_mark_reset ? read_memory_status("VmHWM") : sampled;
+            }
+
+        private:
+            bool high_water_mark_reset{ false };
+            long sampled{ 0 };
+    };
+
+    /// Sleeps for the given time, sampling the RSS meanwhile.
+    void sleep_sampling(steady_clock::duration time, PeakRSS& rss)
+    {
+        auto end = steady_clock::now() + time;
+
+        for (auto now = steady_clock::now(); now < end; now = steady_clock::now())
+        {
+            std::this_thread::sleep_for(std::min<steady_clock::duration>(end - now, milliseconds{ 50 }));
+            rss.sample();
+        }
+    }
+
+    double per_second(std::size_t count, steady_clock::duration elapsed)
+    {
+        auto s = duration_cast<duration<double>>(elapsed).count();
+
+        return s > 0 ? static_cast<double>(count) / s : 0.0;
+    }
+
+    double to_us(nanoseconds ns)
+    {
+        return static_cast<double>(ns.count()) / 1000.0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Settings settings{};
+
+    if (!parse_arguments(argc, argv, settings))
+    {
+        return EXIT_FAILURE;
+    }
+
+    bool tls = !settings.certificate.empty();
+    std::size_t max_connections = 0;
+
+    for (auto c : settings.connections)
+    {
+        max_connections = std::max(max_connections, c);
+    }
+
+    // The dispatcher only starts sockets once the network is up.
+    SocketDispatcher::instance();
+    ipc::Publisher<NetworkStatus>::publish(NetworkStatus(NetworkEvent::GOT_IP, true));
+
+    SoakTask server_task{ "SoakServer" };
+    SoakTask client_task{ "SoakClients" };
+    server_task.start();
+    client_task.start();
+
+    using PlainServer = ServerSocket<EchoServerClient, EchoProtocol, void>;
+    using TLSServer = SecureServerSocket<EchoServerClient, EchoProtocol, void>;
+
+    auto max_clients = static_cast<int>(max_connections);
+    auto backlog = std::max(max_clients, 128);
+    std::shared_ptr<PlainServer> server{};
+    std::shared_ptr<MBedTLSContext> client_tls{};
+    std::shared_ptr<CryptoWorkerPool> handshake_pool{};
+
+    if (tls)
+    {
+        auto server_tls = std::make_shared<MBedTLSContext>();
+        auto cert = read_pem(settings.certificate);
+
+        if (!server_tls->init_server(cert, cert, read_pem(settings.key), {}))
+        {
+            fmt::print(stderr, "Could not load certificate/key\n");
+
+            return EXIT_FAILURE;
+        }
+
+        client_tls = std::make_shared<MBedTLSContext>();
+        client_tls->init_client({});
+
+        auto s = TLSServer::create(server_task, max_clients, backlog, server_tls);
+
+        if (settings.handshake_workers > 0)
+        {
+            handshake_pool = std::make_shared<CryptoWorkerPool>(settings.handshake_workers,
+                                                                settings.handshake_workers * 4);
+
+            // create() hands out the ServerSocket base; the concrete type is known here.
+            static_cast<TLSServer*>(s.get())->set_handshake_pool(handshake_pool);
+        }
+
+        server = s;
+    }
+    else
+    {
+        server = PlainServer::create(server_task, max_clients, backlog);
+    }
+
+    server->start(std::make_shared<IPv4>("127.0.0.1", settings.port));
+    std::this_thread::sleep_for(milliseconds{ 500 });
+
+    fmt::print("# {} echo over loopback, {} byte messages, {} s per round\n",
+               tls ? "TLS" : "Plain", EchoPacket::Size, settings.duration.count());
+    fmt::print("# dispatcher thread ms: CPU time of the thread serving both server and client sockets\n");
+    fmt::print("{:>11} {:>10} {:>12} {:>10} {:>10} {:>10} {:>20} {:>13} {:>6}\n",
+               "connections", "conn/s", "msg/s", "p50 us", "p99 us", "p999 us", "dispatcher thread ms", "peak RSS KiB",
+               "lost");
+
+    SoakStatistics stats{};
+    PeakRSS rss{};
+
+    for (auto count : settings.connections)
+    {
+        stats.reset();
+        rss.reset();
+        auto cpu_before = SocketDispatcher::instance().get_cpu_time();
+
+        std::vector<std::unique_ptr<LoadConnection>> connections{};
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            connections.emplace_back(std::make_unique<LoadConnection>(client_task, stats));
+        }
+
+        auto connect_start = steady_clock::now();
+
+        for (auto& c : connections)
+        {
+            c->start(std::make_shared<IPv4>("127.0.0.1", settings.port), client_tls);
+        }
+
+        auto deadline = connect_start + seconds{ 30 };
+
+        while (stats.get_connected() < count && steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(milliseconds{ 1 });
+        }
+
+        rss.sample();
+
+        auto connect_time = steady_clock::now() - connect_start;
+        auto connected = stats.get_connected();
+
+        stats.begin_window();
+        auto window_start = steady_clock::now();
+        sleep_sampling(settings.duration, rss);
+        auto summary = stats.summarize();
+        auto window = steady_clock::now() - window_start;
+
+        for (auto& c : connections)
+        {
+            c->stop();
+        }
+
+        auto cpu = SocketDispatcher::instance().get_cpu_time() - cpu_before;
+
+        fmt::print("{:>11} {:>10.0f} {:>12.0f} {:>10.1f} {:>10.1f} {:>10.1f} {:>20} {:>13} {:>6}\n",
+                   count,
+                   per_second(connected, connect_time),
+                   per_second(summary.messages, window),
+                   to_us(summary.p50),
+                   to_us(summary.p99),
+                   to_us(summary.p999),
+                   duration_cast<milliseconds>(cpu).count(),
+                   rss.get(),
+                   summary.disconnected + (count - connected));
+
+        // Let the connections close and the server return its clients to the pool.
+        std::this_thread::sleep_for(seconds{ 1 });
+    }
+
+    std::fflush(stdout);
+
+    // Tasks, including the SocketDispatcher, run for the lifetime of the process.
+    std::quick_exit(EXIT_SUCCESS);
+}
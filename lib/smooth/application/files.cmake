@@ -14,17 +14,30 @@ set(SMOOTH_SOURCES
         ${smooth_dir}/application/io/spi/BME280SPI.cpp
         ${smooth_dir}/application/io/spi/BME280Core.cpp
         ${smooth_dir}/application/io/wiegand/Wiegand.cpp
+        ${smooth_dir}/application/network/http/HTTPAccessLog.cpp
+        ${smooth_dir}/application/network/http/HTTPClient.cpp
+        ${smooth_dir}/application/network/http/HTTPClientConnection.cpp
+        ${smooth_dir}/application/network/http/HTTPMetrics.cpp
         ${smooth_dir}/application/network/http/HTTPProtocol.cpp
         ${smooth_dir}/application/network/http/HTTPServerClient.cpp
         ${smooth_dir}/application/network/http/http_utils.cpp
+        ${smooth_dir}/application/network/http/regular/HeaderFields.cpp
         ${smooth_dir}/application/network/http/regular/HTTPHeaderDef.cpp
+        ${smooth_dir}/application/network/http/regular/HTTPHeaderParser.cpp
         ${smooth_dir}/application/network/http/regular/HTTPPacket.cpp
         ${smooth_dir}/application/network/http/regular/MIMEParser.cpp
+        ${smooth_dir}/application/network/http/regular/QueryParameters.cpp
         ${smooth_dir}/application/network/http/regular/RegularHTTPProtocol.cpp
+        ${smooth_dir}/application/network/http/regular/Router.cpp
+        ${smooth_dir}/application/network/http/regular/responses/CachedAssetResponse.cpp
+        ${smooth_dir}/application/network/http/regular/responses/ChunkedResponse.cpp
+        ${smooth_dir}/application/network/http/regular/responses/CompressedResponse.cpp
         ${smooth_dir}/application/network/http/regular/responses/ErrorResponse.cpp
         ${smooth_dir}/application/network/http/regular/responses/FileContentResponse.cpp
         ${smooth_dir}/application/network/http/regular/responses/HeaderOnlyResponse.cpp
         ${smooth_dir}/application/network/http/regular/responses/StringResponse.cpp
+        ${smooth_dir}/application/network/http/regular/responses/TemplateResponse.cpp
+        ${smooth_dir}/application/network/http/regular/StaticAssetCache.cpp
         ${smooth_dir}/application/network/http/regular/TemplateProcessor.cpp
         ${smooth_dir}/application/network/http/URLEncoding.cpp
         ${smooth_dir}/application/network/http/websocket/responses/WSResponse.cpp
@@ -64,6 +77,7 @@ set(SMOOTH_SOURCES
         ${smooth_dir}/core/filesystem/filesystem.cpp
         ${smooth_dir}/core/filesystem/FSLock.cpp
         ${smooth_dir}/core/filesystem/MMCSDCard.cpp
+        ${smooth_dir}/core/filesystem/OpenFile.cpp
         ${smooth_dir}/core/filesystem/Path.cpp
         ${smooth_dir}/core/filesystem/SDCard.cpp
         ${smooth_dir}/core/filesystem/SPIFlash.cpp
@@ -81,10 +95,14 @@ set(SMOOTH_SOURCES
         ${smooth_dir}/core/json/JsonFile.cpp
         ${smooth_dir}/core/logging/log.cpp
         ${smooth_dir}/core/network/CommonSocket.cpp
+        ${smooth_dir}/core/network/CryptoWorkerPool.cpp
+        ${smooth_dir}/core/network/DescriptorChannel.cpp
         ${smooth_dir}/core/network/IPv4.cpp
         ${smooth_dir}/core/network/IPv6.cpp
         ${smooth_dir}/core/network/MbedTLSContext.cpp
         ${smooth_dir}/core/network/SocketDispatcher.cpp
+        ${smooth_dir}/core/network/SocketOptions.cpp
+        ${smooth_dir}/core/network/UnixAddress.cpp
         ${smooth_dir}/core/network/Wifi.cpp
         ${smooth_dir}/core/sntp/Sntp.cpp
         ${smooth_dir}/core/SystemStatistics.cpp
@@ -99,17 +117,34 @@ set(SMOOTH_SOURCES
         ${smooth_inc_dir}/application/io/spi/BME280Core.h
         ${smooth_inc_dir}/application/io/i2c/ADS1115.h
         ${smooth_inc_dir}/application/io/i2c/MCP23017.h
+        ${smooth_inc_dir}/application/network/http/HTTPAccessLog.h
+        ${smooth_inc_dir}/application/network/http/HTTPClient.h
+        ${smooth_inc_dir}/application/network/http/HTTPClientConnection.h
+        ${smooth_inc_dir}/application/network/http/HTTPClientResponse.h
+        ${smooth_inc_dir}/application/network/http/HTTPMetrics.h
         ${smooth_inc_dir}/application/network/http/HTTPProtocol.h
         ${smooth_inc_dir}/application/network/http/HTTPServer.h
         ${smooth_inc_dir}/application/network/http/HTTPServerClient.h
         ${smooth_inc_dir}/application/network/http/HTTPServerConfig.h
         ${smooth_inc_dir}/application/network/http/http_utils.h
         ${smooth_inc_dir}/application/network/http/IResponseOperation.h
+        ${smooth_inc_dir}/application/network/http/regular/CompiledTemplate.h
+        ${smooth_inc_dir}/application/network/http/regular/HeaderFields.h
+        ${smooth_inc_dir}/application/network/http/regular/HTTPHeaderParser.h
         ${smooth_inc_dir}/application/network/http/regular/ITemplateDataRetriever.h
+        ${smooth_inc_dir}/application/network/http/regular/QueryParameters.h
         ${smooth_inc_dir}/application/network/http/regular/RegularHTTPProtocol.h
+        ${smooth_inc_dir}/application/network/http/regular/RequestRecord.h
+        ${smooth_inc_dir}/application/network/http/regular/Router.h
+        ${smooth_inc_dir}/application/network/http/regular/StatusLines.h
+        ${smooth_inc_dir}/application/network/http/regular/responses/CachedAssetResponse.h
+        ${smooth_inc_dir}/application/network/http/regular/responses/ChunkedResponse.h
+        ${smooth_inc_dir}/application/network/http/regular/responses/CompressedResponse.h
         ${smooth_inc_dir}/application/network/http/regular/responses/ErrorResponse.h
         ${smooth_inc_dir}/application/network/http/regular/responses/FileContentResponse.h
         ${smooth_inc_dir}/application/network/http/regular/responses/StringResponse.h
+        ${smooth_inc_dir}/application/network/http/regular/responses/TemplateResponse.h
+        ${smooth_inc_dir}/application/network/http/regular/StaticAssetCache.h
         ${smooth_inc_dir}/application/network/http/regular/TemplateProcessor.h
         ${smooth_inc_dir}/application/network/http/URLEncoding.h
         ${smooth_inc_dir}/application/network/http/websocket/WebsocketProtocol.h
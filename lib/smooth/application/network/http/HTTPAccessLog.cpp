@@ -0,0 +1,88 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/network/http/HTTPAccessLog.h"
+#include <algorithm>
+#include <limits>
+
+namespace smooth::application::network::http
+{
+    using namespace std::chrono;
+
+    template<typename T, typename V>
+    static T saturate(V value)
+    {
+        return static_cast<T>(std::min(value, static_cast<V>(std::numeric_limits<T>::max())));
+    }
+
+    HTTPAccessLog::HTTPAccessLog(std::size_t size)
+            : entries(size)
+    {
+    }
+
+    void HTTPAccessLog::add(const regular::RequestRecord& record,
+                            microseconds latency,
+                            system_clock::time_point completed)
+    {
+        Entry e{};
+        e.time = saturate<uint32_t>(duration_cast<seconds>(completed.time_since_epoch()).count());
+        e.latency_us = saturate<uint32_t>(latency.count());
+        e.bytes_in = saturate<uint32_t>(record.bytes_in);
+        e.bytes_out = saturate<uint32_t>(record.bytes_out);
+        e.route = record.route == regular::RequestRecord::NoRoute
+                  ? Entry::NoRoute
+                  : saturate<uint32_t>(record.route);
+        e.status = static_cast<uint16_t>(record.code);
+        e.method = static_cast<uint8_t>(record.method);
+
+        std::lock_guard<std::mutex> lock{ guard };
+
+        if (!entries.empty())
+        {
+            entries[total % entries.size()] = e;
+            ++total;
+        }
+    }
+
+    std::vector<HTTPAccessLog::Entry> HTTPAccessLog::get_entries() const
+    {
+        std::vector<Entry> res{};
+
+        std::lock_guard<std::mutex> lock{ guard };
+
+        if (total > entries.size())
+        {
+            auto oldest = static_cast<std::ptrdiff_t>(total % entries.size());
+            res.reserve(entries.size());
+            res.insert(res.end(), entries.begin() + oldest, entries.end());
+            res.insert(res.end(), entries.begin(), entries.begin() + oldest);
+        }
+        else
+        {
+            res.assign(entries.begin(), entries.begin() + static_cast<std::ptrdiff_t>(total));
+        }
+
+        return res;
+    }
+
+    uint64_t HTTPAccessLog::get_total() const
+    {
+        std::lock_guard<std::mutex> lock{ guard };
+
+        return total;
+    }
+}
@@ -0,0 +1,272 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include <algorithm>
+#include <iterator>
+#include "smooth/application/network/http/HTTPClient.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+#include "smooth/core/logging/log.h"
+
+namespace smooth::application::network::http
+{
+    using namespace smooth::core;
+    using namespace smooth::core::network;
+    using namespace smooth::application::network::http::regular;
+
+    static const char* tag = "HTTPClient";
+
+    HTTPClient::HTTPClient(Task& task,
+                           std::weak_ptr<ipc::TaskEventQueue<HTTPClientResponse>> response_queue,
+                           std::size_t max_connections_per_host,
+                           std::size_t pipeline_depth,
+                           int max_header_size,
+                           int content_chunk_size,
+                           std::chrono::milliseconds idle_timeout)
+            : task(task),
+              response_queue(std::move(response_queue)),
+              max_connections_per_host(std::max(max_connections_per_host, static_cast<std::size_t>(1))),
+              pipeline_depth(std::max(pipeline_depth, static_cast<std::size_t>(1))),
+              max_header_size(max_header_size),
+              content_chunk_size(content_chunk_size),
+              idle_timeout(idle_timeout)
+    {
+    }
+
+    HTTPClient::~HTTPClient() = default;
+
+    bool HTTPClient::load_certificate(const std::vector<unsigned char>& ca_cert)
+    {
+        tls_context = std::make_unique<MBedTLSContext>();
+        auto res = tls_context->init_client(ca_cert);
+
+        for (auto& host : hosts)
+        {
+            if (host.second.tls_session)
+            {
+                host.second.tls_session->clear();
+            }
+        }
+
+        return res;
+    }
+
+    uint32_t HTTPClient::request(const std::shared_ptr<InetAddress>& address,
+                                 HTTPMethod method,
+                                 const std::string& url,
+                                 const std::unordered_map<std::string, std::string>& headers,
+                                 const std::vector<uint8_t>& content)
+    {
+        uint32_t res = 0;
+
+        if (method == HTTPMethod::HEAD)
+        {
+            // The response would announce content that never follows.
+            Log::error(tag, "HEAD requests are not supported");
+        }
+        else
+        {
+            const auto secure = tls_context != nullptr;
+            auto host_name = address->get_host();
+
+            if (address->get_port() != (secure ? 443 : 80))
+            {
+                host_name.append(":").append(std::to_string(address->get_port()));
+            }
+
+            const auto key = (secure ? "https://" : "http://") + host_name;
+            auto& host = hosts[key];
+
+            if (!host.address)
+            {
+                host.address = address;
+                host.tls_session = std::make_shared<TLSSession>();
+            }
+
+            const auto has_header = [&headers](const char* name) {
+                                        return std::any_of(headers.begin(), headers.end(), [name](const auto& h) {
+                                                               return HeaderFields::equal_names(h.first, name);
+                                                           });
+                                    };
+
+            auto request_headers = headers;
+
+            if (!has_header(HOST))
+            {
+                request_headers.emplace(HOST, host_name);
+            }
+
+            if (!has_header(CONTENT_LENGTH) && (!content.empty() || method == HTTPMethod::POST
+                                                || method == HTTPMethod::PUT))
+            {
+                request_headers.emplace(CONTENT_LENGTH, std::to_string(content.size()));
+            }
+
+            res = next_id++;
+
+            if (next_id == 0)
+            {
+                next_id = 1;
+            }
+
+            host.waiting.emplace_back(HTTPClientRequest{ res,
+                                                         method,
+                                                         HTTPPacket{ method, url, request_headers, content },
+                                                         false });
+            dispatch(key);
+        }
+
+        return res;
+    }
+
+    void HTTPClient::close_all()
+    {
+        closing_all = true;
+
+        for (auto& host : hosts)
+        {
+            for (const auto& request : host.second.waiting)
+            {
+                deliver(HTTPClientResponse::failure(request.id));
+            }
+
+            host.second.waiting.clear();
+
+            for (auto& connection : host.second.connections)
+            {
+                connection->close("HTTP client closed");
+            }
+        }
+
+        closing_all = false;
+    }
+
+    void HTTPClient::dispatch(const std::string& host_key)
+    {
+        auto& host = hosts.at(host_key);
+        auto blocked = false;
+
+        // Requests are sent in order; a request that can't be sent holds back those after it.
+        while (!blocked && !host.waiting.empty())
+        {
+            HTTPClientConnection* best = nullptr;
+
+            for (auto& connection : host.connections)
+            {
+                if (connection->can_send(host.waiting.front())
+                    && (best == nullptr || connection->get_in_flight() < best->get_in_flight()))
+                {
+                    best = connection.get();
+                }
+            }
+
+            if (best)
+            {
+                auto request = std::move(host.waiting.front());
+                host.waiting.pop_front();
+                best->send(std::move(request));
+            }
+            else
+            {
+                blocked = true;
+            }
+        }
+
+        auto connecting = std::any_of(host.connections.begin(), host.connections.end(), [](const auto& c) {
+                                          return !c->is_closed() && !c->is_connected();
+                                      });
+
+        // Open one more connection at a time; once it is up, any requests still waiting open the next one.
+        if (blocked && !connecting)
+        {
+            auto closed = std::find_if(host.connections.begin(), host.connections.end(), [](const auto& c) {
+                                           return c->is_closed();
+                                       });
+
+            HTTPClientConnection* connection = nullptr;
+
+            if (closed != host.connections.end())
+            {
+                connection = closed->get();
+            }
+            else if (host.connections.size() < max_connections_per_host)
+            {
+                host.connections.emplace_back(std::make_unique<HTTPClientConnection>(*this, host_key, host.address));
+                connection = host.connections.back().get();
+            }
+
+            if (connection && !connection->connect())
+            {
+                connection_failed(host_key);
+            }
+        }
+    }
+
+    void HTTPClient::connection_failed(const std::string& host_key)
+    {
+        auto& host = hosts.at(host_key);
+
+        // Unless already connected otherwise, there is no way to send the waiting requests.
+        if (std::none_of(host.connections.begin(), host.connections.end(), [](const auto& c) {
+                             return c->is_connected();
+                         }))
+        {
+            for (const auto& request : host.waiting)
+            {
+                deliver(HTTPClientResponse::failure(request.id));
+            }
+
+            host.waiting.clear();
+        }
+    }
+
+    void HTTPClient::unanswered(const std::string& host_key,
+                                std::deque<HTTPClientRequest>& requests,
+                                bool partial_first)
+    {
+        // The server may close a keep-alive connection at any time, so requests are resent once on
+        // another connection unless that could repeat their effect or part of the response was delivered.
+        std::deque<HTTPClientRequest> resend{};
+
+        for (auto& request : requests)
+        {
+            if (closing_all
+                || request.retried
+                || !HTTPClientConnection::is_idempotent(request.method)
+                || (partial_first && &request == &requests.front()))
+            {
+                deliver(HTTPClientResponse::failure(request.id));
+            }
+            else
+            {
+                request.retried = true;
+                resend.emplace_back(std::move(request));
+            }
+        }
+
+        auto& waiting = hosts.at(host_key).waiting;
+        waiting.insert(waiting.begin(), std::make_move_iterator(resend.begin()), std::make_move_iterator(resend.end()));
+    }
+
+    void HTTPClient::deliver(const HTTPClientResponse& response)
+    {
+        auto queue = response_queue.lock();
+
+        if (!queue || !queue->push(response))
+        {
+            Log::warning(tag, "Response to request {} dropped", response.get_request_id());
+        }
+    }
+}
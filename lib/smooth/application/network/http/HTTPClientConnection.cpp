@@ -0,0 +1,309 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "smooth/application/network/http/HTTPClientConnection.h"
+#include "smooth/application/network/http/HTTPClient.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+#include "smooth/core/network/SecureSocket.h"
+#include "smooth/core/logging/log.h"
+
+namespace smooth::application::network::http
+{
+    using namespace std::chrono;
+    using namespace smooth::core;
+    using namespace smooth::core::network;
+    using namespace smooth::core::network::event;
+    using namespace smooth::application::network::http::regular;
+
+    static const char* tag = "HTTPClient";
+
+    HTTPClientConnection::HTTPClientConnection(HTTPClient& client,
+                                               std::string host_key,
+                                               std::shared_ptr<InetAddress> address)
+            : client(client),
+              host_key(std::move(host_key)),
+              address(std::move(address)),
+              buff(std::make_shared<BufferContainer<HTTPProtocol>>(client.task,
+                                                                   *this,
+                                                                   *this,
+                                                                   *this,
+                                                                   std::make_unique<HTTPProtocol>(
+                                                                           client.max_header_size,
+                                                                           client.content_chunk_size,
+                                                                           *this)))
+    {
+    }
+
+    HTTPClientConnection::~HTTPClientConnection()
+    {
+        if (socket)
+        {
+            socket->stop("HTTP client connection destroyed");
+        }
+    }
+
+    bool HTTPClientConnection::connect()
+    {
+        auto res = state != State::Closed;
+
+        if (!res)
+        {
+            buff->clear();
+            closing = false;
+            receiving = false;
+            until_close = false;
+
+            // The receive timeout closes idle connections.
+            if (client.tls_context)
+            {
+                auto secure = SecureSocket<HTTPProtocol>::create(buff,
+                                                                 client.tls_context->create_context(),
+                                                                 DefaultSendTimeout,
+                                                                 client.idle_timeout);
+
+                if (secure)
+                {
+                    // Resume the session of earlier connections to the host to avoid full handshakes.
+                    secure->set_tls_session(client.hosts.at(host_key).tls_session);
+                }
+
+                socket = secure;
+            }
+            else
+            {
+                socket = Socket<HTTPProtocol>::create(buff, DefaultSendTimeout, client.idle_timeout);
+            }
+
+            res = socket && socket->start(address);
+
+            if (res)
+            {
+                state = State::Connecting;
+            }
+            else
+            {
+                socket.reset();
+            }
+        }
+
+        return res;
+    }
+
+    void HTTPClientConnection::close(const char* reason)
+    {
+        if (socket)
+        {
+            socket->stop(reason);
+        }
+
+        connection_lost();
+    }
+
+    bool HTTPClientConnection::can_send(const HTTPClientRequest& request) const
+    {
+        // Non-idempotent requests are not pipelined, https://tools.ietf.org/html/rfc7230#section-6.3.2,
+        // since they can't be safely resent if the connection is lost.
+        return state == State::Connected
+               && !closing
+               && in_flight.size() < client.pipeline_depth
+               && (in_flight.empty()
+                   || (is_idempotent(request.method) && is_idempotent(in_flight.back().method)));
+    }
+
+    void HTTPClientConnection::send(HTTPClientRequest request)
+    {
+        if (socket->send(request.packet))
+        {
+            in_flight.emplace_back(std::move(request));
+        }
+        else
+        {
+            Log::error(tag, "Transmit buffer full, request to {} failed", host_key);
+            client.deliver(HTTPClientResponse::failure(request.id));
+        }
+    }
+
+    void HTTPClientConnection::event(const TransmitBufferEmptyEvent& /*event*/)
+    {
+        // Requests are only sent when there is room for them in the transmit buffer.
+    }
+
+    void HTTPClientConnection::event(const DataAvailableEvent<HTTPProtocol>& event)
+    {
+        HTTPPacket packet;
+
+        if (event.get(packet))
+        {
+            receive(packet);
+        }
+    }
+
+    void HTTPClientConnection::receive(HTTPPacket& packet)
+    {
+        if (in_flight.empty())
+        {
+            Log::error(tag, "Unsolicited response from {}", host_key);
+            close("Unsolicited response");
+        }
+        else
+        {
+            const auto first = !packet.is_continuation();
+            const auto last = !packet.is_continued();
+
+            if (first)
+            {
+                current_code = packet.response_code();
+            }
+
+            const auto code = static_cast<int>(current_code);
+
+            // Interim responses, such as 100 Continue, precede the final response and are not delivered.
+            if (code < 100 || code >= 200)
+            {
+                const auto id = in_flight.front().id;
+
+                if (first)
+                {
+                    const auto& headers = packet.headers();
+                    const auto connection = headers.get(CONNECTION);
+
+                    // Without a length, the content ends when the server closes the connection.
+                    until_close = !last
+                                  && headers.get(CONTENT_LENGTH).empty()
+                                  && headers.get(TRANSFER_ENCODING).empty();
+
+                    // HTTP/1.0 connections are only kept alive when asked for,
+                    // https://tools.ietf.org/html/rfc7230#section-6.3
+                    closing = until_close
+                              || HeaderFields::equal_names(connection, "close")
+                              || (packet.response_version() == "1.0"
+                                  && !HeaderFields::equal_names(connection, "keep-alive"));
+                }
+
+                receiving = !last;
+                client.deliver(HTTPClientResponse{ id,
+                                                   current_code,
+                                                   first ? packet.headers() : HeaderFields{},
+                                                   std::move(packet.data()),
+                                                   first,
+                                                   last });
+
+                if (last)
+                {
+                    in_flight.pop_front();
+
+                    if (closing)
+                    {
+                        close("Connection: close");
+                    }
+                    else
+                    {
+                        client.dispatch(host_key);
+                    }
+                }
+            }
+        }
+    }
+
+    void HTTPClientConnection::event(const ConnectionStatusEvent& event)
+    {
+        // Events from a socket replaced by a later connect() are ignored.
+        if (socket && event.get_socket() == socket)
+        {
+            if (event.is_connected())
+            {
+                state = State::Connected;
+                client.dispatch(host_key);
+            }
+            else
+            {
+                connection_lost();
+            }
+        }
+    }
+
+    void HTTPClientConnection::reply(std::unique_ptr<IResponseOperation> /*response*/, bool /*place_first*/)
+    {
+    }
+
+    void HTTPClientConnection::reply_error(std::unique_ptr<IResponseOperation> /*response*/)
+    {
+        // Called from the socket while assembling an invalid response; the socket closes the
+        // connection because of the assembly error, which fails the outstanding requests.
+    }
+
+    Task& HTTPClientConnection::get_task()
+    {
+        return client.task;
+    }
+
+    void HTTPClientConnection::upgrade_to_websocket_internal()
+    {
+    }
+
+    bool HTTPClientConnection::is_idempotent(HTTPMethod method)
+    {
+        return method != HTTPMethod::POST;
+    }
+
+    void HTTPClientConnection::connection_lost()
+    {
+        const auto never_connected = state == State::Connecting;
+
+        if (until_close)
+        {
+            // Content may still be waiting to be delivered, ahead of this event.
+            HTTPPacket packet;
+
+            while (buff->get_rx_buffer().get(packet))
+            {
+                receive(packet);
+            }
+        }
+
+        if (until_close && receiving && !in_flight.empty())
+        {
+            // The end of the connection is the end of the content.
+            client.deliver(HTTPClientResponse{ in_flight.front().id, current_code, HeaderFields{}, {}, false, true });
+            in_flight.pop_front();
+            receiving = false;
+        }
+
+        const auto partial_first = receiving;
+
+        state = State::Closed;
+        socket.reset();
+        receiving = false;
+        closing = false;
+        until_close = false;
+
+        if (!in_flight.empty())
+        {
+            client.unanswered(host_key, in_flight, partial_first);
+            in_flight.clear();
+        }
+
+        if (never_connected)
+        {
+            Log::error(tag, "Could not connect to {}", host_key);
+            client.connection_failed(host_key);
+        }
+        else
+        {
+            client.dispatch(host_key);
+        }
+    }
+}
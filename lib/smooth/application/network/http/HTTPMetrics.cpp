@@ -0,0 +1,124 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/network/http/HTTPMetrics.h"
+#include <algorithm>
+
+namespace smooth::application::network::http
+{
+    using namespace std::chrono;
+    using namespace regular;
+
+    HTTPMetrics::HTTPMetrics(std::size_t max_routes)
+            : max_routes(max_routes),
+              counters((max_routes + 2) * MethodCount)
+    {
+    }
+
+    void HTTPMetrics::record(const RequestRecord& record, microseconds latency)
+    {
+        auto& c = counters[slot_of(record.route) * MethodCount + static_cast<std::size_t>(record.method)];
+
+        c.requests.fetch_add(1, std::memory_order_relaxed);
+
+        auto status_class = static_cast<std::size_t>(record.code) / 100;
+
+        if (status_class >= 1 && status_class <= StatusClasses)
+        {
+            c.status_classes[status_class - 1].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        auto ms = duration_cast<milliseconds>(latency).count();
+        auto bucket = std::find_if(LatencyLimits.begin(), LatencyLimits.end(),
+                                   [ms](auto limit) { return ms < limit; });
+        c.latency[static_cast<std::size_t>(std::distance(LatencyLimits.begin(), bucket))]
+        .fetch_add(1, std::memory_order_relaxed);
+
+        c.bytes_in.fetch_add(record.bytes_in, std::memory_order_relaxed);
+        c.bytes_out.fetch_add(record.bytes_out, std::memory_order_relaxed);
+    }
+
+    std::vector<HTTPMetrics::Counts> HTTPMetrics::get_counts() const
+    {
+        std::vector<Counts> res{};
+
+        for (std::size_t i = 0; i < counters.size(); ++i)
+        {
+            const auto& c = counters[i];
+            auto requests = c.requests.load(std::memory_order_relaxed);
+
+            if (requests > 0)
+            {
+                auto& counts = res.emplace_back();
+                counts.route = route_of(i / MethodCount);
+                counts.method = static_cast<HTTPMethod>(i % MethodCount);
+                counts.requests = requests;
+
+                for (std::size_t j = 0; j < StatusClasses; ++j)
+                {
+                    counts.status_classes[j] = c.status_classes[j].load(std::memory_order_relaxed);
+                }
+
+                for (std::size_t j = 0; j < LatencyBuckets; ++j)
+                {
+                    counts.latency[j] = c.latency[j].load(std::memory_order_relaxed);
+                }
+
+                counts.bytes_in = c.bytes_in.load(std::memory_order_relaxed);
+                counts.bytes_out = c.bytes_out.load(std::memory_order_relaxed);
+            }
+        }
+
+        return res;
+    }
+
+    std::size_t HTTPMetrics::slot_of(std::size_t route) const
+    {
+        std::size_t res;
+
+        if (route == RequestRecord::NoRoute)
+        {
+            res = 0;
+        }
+        else
+        {
+            res = std::min(route, max_routes) + 1;
+        }
+
+        return res;
+    }
+
+    std::size_t HTTPMetrics::route_of(std::size_t slot) const
+    {
+        std::size_t res;
+
+        if (slot == 0)
+        {
+            res = RequestRecord::NoRoute;
+        }
+        else if (slot > max_routes)
+        {
+            res = OtherRoutes;
+        }
+        else
+        {
+            res = slot - 1;
+        }
+
+        return res;
+    }
+}
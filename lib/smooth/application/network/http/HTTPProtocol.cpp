@@ -89,14 +89,57 @@ namespace smooth::application::network::http
             websocket->reset();
         }
 
+        buffered.clear();
+
         regular = std::make_unique<RegularHTTPProtocol>(max_header_size,
                                                         content_chunk_size,
                                                         response,
                                                         *this);
     }
 
+    int HTTPProtocol::get_buffered_amount() const
+    {
+        return regular ? regular->get_buffered_amount() : static_cast<int>(buffered.size());
+    }
+
+    int HTTPProtocol::take_buffered(uint8_t* target, int length)
+    {
+        auto res = 0;
+
+        if (regular)
+        {
+            res = regular->take_buffered(target, length);
+        }
+        else
+        {
+            auto count = std::min(static_cast<std::size_t>(std::max(length, 0)), buffered.size());
+            auto end = buffered.begin() + static_cast<long>(count);
+
+            std::copy(buffered.begin(), end, target);
+            buffered.erase(buffered.begin(), end);
+            res = static_cast<int>(count);
+        }
+
+        return res;
+    }
+
+    std::vector<uint8_t> HTTPProtocol::take_all_buffered()
+    {
+        std::vector<uint8_t> res(static_cast<std::size_t>(get_buffered_amount()));
+        res.resize(static_cast<std::size_t>(take_buffered(res.data(), static_cast<int>(res.size()))));
+
+        return res;
+    }
+
     void HTTPProtocol::upgrade_to_websocket()
     {
+        upgrade_to_websocket(take_all_buffered());
+    }
+
+    void HTTPProtocol::upgrade_to_websocket(std::vector<uint8_t> leftover)
+    {
+        // A client may send its first frames right after the upgrade request; keep them for the websocket protocol.
+        buffered = std::move(leftover);
         regular.reset();
         websocket = std::make_unique<websocket::WebsocketProtocol>(content_chunk_size, response);
     }
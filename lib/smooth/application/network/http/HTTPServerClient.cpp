@@ -53,23 +53,52 @@ namespace smooth::application::network::http
             }
             else if (res == ResponseStatus::NoData)
             {
+                complete_request();
                 current_operation.reset();
+                this->socket->set_cork(false);
 
-                // Immediately send next
-                send_first_part();
+                if (close_when_sent)
+                {
+                    close();
+                }
+                else
+                {
+                    // Immediately send next
+                    send_first_part();
+                }
             }
             else if (res == ResponseStatus::HasMoreData
                      || res == ResponseStatus::LastData)
             {
+                if (res == ResponseStatus::LastData)
+                {
+                    // Release the cork once the last part has been sent.
+                    this->socket->set_cork(false);
+                }
+
+                add_bytes_out(data.size());
+
+                if (res == ResponseStatus::LastData)
+                {
+                    complete_request();
+                }
+
                 HTTPPacket p{ data };
                 auto& tx = this->container->get_tx_buffer();
                 tx.put(p);
             }
         }
+        else if (close_when_sent)
+        {
+            // The response announcing the close has been sent in its entirety.
+            close();
+        }
         else
         {
             send_first_part();
         }
+
+        update_idle_state();
     }
 
     void HTTPServerClient::disconnected()
@@ -79,14 +108,30 @@ namespace smooth::application::network::http
     void HTTPServerClient::connected()
     {
         this->socket->set_receive_timeout(DefaultKeepAlive);
+        update_idle_state();
     }
 
     void HTTPServerClient::reset_client()
     {
         operations.clear();
         current_operation.reset();
+        current_request.reset();
+        operation_records.clear();
+        current_record.reset();
         mode = Mode::HTTP;
         ws_server.reset();
+        request_in_progress = false;
+        close_when_sent = false;
+    }
+
+    void HTTPServerClient::update_idle_state()
+    {
+        // A connection is idle when it is waiting for the next request on a kept-alive connection.
+        // Websocket connections are never considered idle.
+        set_idle(mode == Mode::HTTP
+                 && !request_in_progress
+                 && !current_operation
+                 && operations.empty());
     }
 
     bool HTTPServerClient::parse_url(std::string& raw_url)
@@ -100,7 +145,6 @@ namespace smooth::application::network::http
 
     void HTTPServerClient::separate_request_parameters(std::string& url)
     {
-        // Only supporting key=value format.
         request_parameters.clear();
 
         auto pos = std::find(url.begin(), url.end(), '?');
@@ -109,38 +153,9 @@ namespace smooth::application::network::http
         {
             encoding.decode(url, pos, url.end());
 
-            pos++;
-
-            while (pos != url.end())
-            {
-                auto equal_sign = std::find(pos, url.end(), '=');
-
-                if (equal_sign != url.end())
-                {
-                    // Find ampersand or end of string
-                    auto ampersand = std::find(equal_sign, url.end(), '&');
-                    auto key = std::string(pos, equal_sign);
-                    auto value = std::string{ ++equal_sign, ampersand };
-                    request_parameters[key] = value;
-
-                    if (ampersand != url.end())
-                    {
-                        ++ampersand;
-                    }
-
-                    pos = ampersand;
-                }
-                else
-                {
-                    pos = url.end();
-                }
-            }
-        }
-
-        pos = std::find(url.begin(), url.end(), '?');
-
-        if (pos != url.end())
-        {
+            // The parameters are split on demand, see QueryParameters.
+            auto query_start = static_cast<std::size_t>(std::distance(url.begin(), pos)) + 1;
+            request_parameters.assign(std::string_view{ url }.substr(query_start));
             url.erase(pos, url.end());
         }
     }
@@ -153,7 +168,13 @@ namespace smooth::application::network::http
             using namespace std::chrono;
             const auto timeout = duration_cast<seconds>(this->socket->get_receive_timeout());
 
-            if (timeout.count() > 0)
+            if (current_request && current_request->version == "1.0" && response->disable_chunked_coding())
+            {
+                // HTTP/1.0 clients don't understand chunked transfer coding, so the end of the body is
+                // marked by closing the connection instead.
+                response->set_header(CONNECTION, "close");
+            }
+            else if (timeout.count() > 0)
             {
                 response->add_header(CONNECTION, "keep-alive");
                 response->set_header(KEEP_ALIVE, "timeout=" + std::to_string(timeout.count()));
@@ -170,13 +191,18 @@ namespace smooth::application::network::http
         }
         else
         {
+            // The first response to a request is the one reported for it.
+            auto record = std::exchange(current_request, std::nullopt);
+
             if (place_first)
             {
                 operations.insert(operations.begin(), std::move(response));
+                operation_records.insert(operation_records.begin(), std::move(record));
             }
             else
             {
                 operations.emplace_back(std::move(response));
+                operation_records.emplace_back(std::move(record));
             }
 
             if (!current_operation)
@@ -189,8 +215,10 @@ namespace smooth::application::network::http
     void HTTPServerClient::reply_error(std::unique_ptr<IResponseOperation> response)
     {
         operations.clear();
+        operation_records.clear();
         response->add_header(CONNECTION, "close");
         operations.emplace_back(std::move(response));
+        operation_records.emplace_back(std::exchange(current_request, std::nullopt));
 
         if (!current_operation)
         {
@@ -200,52 +228,135 @@ namespace smooth::application::network::http
 
     void HTTPServerClient::send_first_part()
     {
-        ResponseStatus res = ResponseStatus::Error;
+        // Responses that are complete in their first part, such as those to pipelined requests, are
+        // coalesced into a single packet (up to about content_chunk_size) so that they go out in one send.
+        // Only the last response in a packet may continue in later packets, which keeps them in order.
+        ResponseStatus res = ResponseStatus::NoData;
+        std::vector<uint8_t> coalesced{};
+        core::network::FileRegion file_region{};
 
-        do
+        while (!operations.empty()
+               && (res == ResponseStatus::NoData || res == ResponseStatus::LastData)
+               && coalesced.size() < content_chunk_size
+               && file_region.is_empty()
+               && !close_when_sent)
         {
-            if (!operations.empty())
+            current_operation = std::move(operations.front());
+            operations.pop_front();
+            current_record = std::move(operation_records.front());
+            operation_records.pop_front();
+
+            const auto& headers = current_operation->get_headers();
+
+            if (mode == Mode::HTTP)
             {
-                current_operation = std::move(operations.front());
-                operations.pop_front();
+                const auto connection = headers.find(CONNECTION);
+                close_when_sent = connection != headers.end() && string_util::icontains(connection->second, "close");
+            }
 
-                const auto& headers = current_operation->get_headers();
+            std::vector<uint8_t> data{};
 
-                std::vector<uint8_t> data{};
+            if (mode == Mode::HTTP && current_operation->get_file_region(file_region))
+            {
+                // The entire content follows the headers straight from the file.
+                res = ResponseStatus::HasMoreData;
+            }
+            else
+            {
                 res = current_operation->get_data(content_chunk_size, data);
+            }
 
-                if (res == ResponseStatus::Error)
+            if (res == ResponseStatus::Error)
+            {
+                Log::error(tag, "Current operation reported error, closing server client.");
+                current_operation.reset();
+                operations.clear();
+                current_record.reset();
+                operation_records.clear();
+                coalesced.clear();
+                this->close();
+            }
+            else
+            {
+                // Whether or not everything is sent, send the current (possibly header-only) part.
+                HTTPPacket p = mode == Mode::HTTP
+                               ? HTTPPacket{ current_operation->get_response_code(), "1.1", headers, data }
+                               : HTTPPacket{ data };
+
+                add_bytes_out(p.data().size() + file_region.length);
+
+                if (res == ResponseStatus::LastData || res == ResponseStatus::NoData)
+                {
+                    complete_request();
+                }
+
+                if (coalesced.empty())
                 {
-                    Log::error(tag, "Current operation reported error, closing server client.");
-                    this->close();
+                    coalesced = std::move(p.data());
                 }
                 else
                 {
-                    auto& tx = this->container->get_tx_buffer();
-                    auto buffer_consumed_data = false;
+                    coalesced.insert(coalesced.end(), p.data().begin(), p.data().end());
+                }
+            }
+        }
 
-                    if (mode == Mode::HTTP)
-                    {
-                        // Whether or not everything is sent, send the current (possibly header-only) packet.
-                        HTTPPacket p{ current_operation->get_response_code(), "1.1", headers, data };
-                        buffer_consumed_data = tx.put(p);
-                    }
-                    else
-                    {
-                        HTTPPacket p{ data };
-                        buffer_consumed_data = tx.put(p);
-                    }
+        if (!coalesced.empty())
+        {
+            if (mode == Mode::HTTP)
+            {
+                // Hold back partial segments while the response spans several packets.
+                this->socket->set_cork(res == ResponseStatus::HasMoreData);
+            }
 
-                    if (!buffer_consumed_data
-                        || res == ResponseStatus::NoData)
-                    {
-                        current_operation.reset();
-                    }
-                }
+            HTTPPacket p{ coalesced };
+            p.set_file_region(std::move(file_region));
+            auto& tx = this->container->get_tx_buffer();
+
+            if (!tx.put(p))
+            {
+                current_operation.reset();
+                current_record.reset();
             }
         }
-        while (!operations.empty()
-               && res == ResponseStatus::NoData); // Process next operation as long as no data is sent.
+
+        if (res == ResponseStatus::NoData)
+        {
+            // Nothing more to send for the last response.
+            current_operation.reset();
+        }
+    }
+
+    void HTTPServerClient::set_route(std::size_t route)
+    {
+        if (current_request)
+        {
+            current_request->route = route;
+        }
+    }
+
+    void HTTPServerClient::add_bytes_out(std::size_t count)
+    {
+        if (current_record)
+        {
+            current_record->bytes_out += count;
+        }
+    }
+
+    void HTTPServerClient::complete_request()
+    {
+        if (current_record && current_operation)
+        {
+            current_record->code = current_operation->get_response_code();
+            auto* context = this->get_client_context();
+
+            if (context)
+            {
+                context->request_completed(*current_record);
+            }
+
+            current_record.reset();
+        }
     }
 
     bool HTTPServerClient::translate_method(
@@ -285,13 +396,11 @@ namespace smooth::application::network::http
 
     void HTTPServerClient::set_keep_alive()
     {
-        auto connection = request_headers.find("connection");
+        const std::string connection{ request_headers.get(CONNECTION) };
 
-        if (connection != request_headers.end())
+        if (!connection.empty())
         {
-            auto s = (*connection).second;
-
-            if (string_util::icontains(s, "keep-alive"))
+            if (string_util::icontains(connection, "keep-alive"))
             {
                 this->socket->set_receive_timeout(DefaultKeepAlive);
             }
@@ -309,6 +418,8 @@ namespace smooth::application::network::http
 
             bool res = true;
 
+            request_in_progress = !last_packet;
+
             if (first_packet)
             {
                 // First packet, parse URL etc.
@@ -319,6 +430,20 @@ namespace smooth::application::network::http
                 set_keep_alive();
 
                 mime.reset();
+
+                current_request = RequestRecord{};
+                current_request->start = packet.get_message_start();
+                current_request->bytes_in = packet.get_message_header_size();
+                current_request->version = packet.get_request_version();
+            }
+
+            HTTPMethod method{};
+            auto known_method = translate_method(packet, method);
+
+            if (current_request)
+            {
+                current_request->method = method;
+                current_request->bytes_in += packet.get_buffer().size();
             }
 
             if (res)
@@ -327,9 +452,7 @@ namespace smooth::application::network::http
 
                 if (context)
                 {
-                    HTTPMethod method{};
-
-                    if (translate_method(packet, method))
+                    if (known_method)
                     {
                         context->handle(method,
                                         *this,
@@ -351,6 +474,8 @@ namespace smooth::application::network::http
                 }
             }
         }
+
+        update_idle_state();
     }
 
     void HTTPServerClient::websocket_event(const smooth::core::network::event::DataAvailableEvent<HTTPProtocol>& event)
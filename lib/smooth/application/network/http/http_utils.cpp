@@ -16,14 +16,20 @@ limitations under the License.
 */
 
 #include "smooth/application/network/http/http_utils.h"
+#include "smooth/core/util/string_util.h"
 
+#include <algorithm>
 #include <array>
+#include <cctype>
+#include <cstdlib>
+#include <limits>
 #include <sstream>
 #include <iomanip>
 #include <mutex>
 
 using namespace smooth::application::network::http::regular;
 using namespace std::chrono;
+using namespace smooth::core;
 
 namespace smooth::application::network::http::utils
 {
@@ -42,21 +48,47 @@ namespace smooth::application::network::http::utils
     {
         tm time{};
         gmtime_r(&t, &time);
-        std::stringstream ss;
 
         // https://developer.mozilla.org/en-US/docs/Web/HTTP/Headers/Last-Modified
         // GMT == UTC and the time read from disc is in UTC so no need to convert between timezones.
         // <day-name>, <day> <month> <year> <hour>:<minute>:<second> GMT
-        ss << day[static_cast<decltype(day)::size_type>(time.tm_wday)];
-        ss << ", " << std::setfill('0') << std::setw(2) << time.tm_mday;
-        ss << " " << month[static_cast<decltype(month)::size_type>(time.tm_mon)];
-        ss << " " << time.tm_year + 1900;
-        ss << " " << std::setfill('0') << std::setw(2) << time.tm_hour;
-        ss << ":" << std::setfill('0') << std::setw(2) << time.tm_min;
-        ss << ":" << std::setfill('0') << std::setw(2) << time.tm_sec;
-        ss << " GMT";
-
-        return ss.str();
+        // The format has a fixed length, so it is written directly into place.
+        std::string res{ "Ddd, DD Mmm YYYY HH:MM:SS GMT" };
+
+        const auto put_two = [&res](std::size_t pos, int value) {
+                                 res[pos] = static_cast<char>('0' + value / 10);
+                                 res[pos + 1] = static_cast<char>('0' + value % 10);
+                             };
+
+        res.replace(0, 3, day[static_cast<decltype(day)::size_type>(time.tm_wday)]);
+        put_two(5, time.tm_mday);
+        res.replace(8, 3, month[static_cast<decltype(month)::size_type>(time.tm_mon)]);
+
+        const auto year = time.tm_year + 1900;
+        put_two(12, year / 100);
+        put_two(14, year % 100);
+        put_two(17, time.tm_hour);
+        put_two(20, time.tm_min);
+        put_two(23, time.tm_sec);
+
+        return res;
+    }
+
+    const std::string& http_time_now()
+    {
+        // Formatting is only done when the second has changed since the last call from the same thread.
+        thread_local time_t formatted_time{ -1 };
+        thread_local std::string formatted{};
+
+        const auto now = system_clock::to_time_t(system_clock::now());
+
+        if (now != formatted_time)
+        {
+            formatted = make_http_time(now);
+            formatted_time = now;
+        }
+
+        return formatted;
     }
 
     std::chrono::system_clock::time_point parse_http_time(const std::string& t)
@@ -153,4 +185,139 @@ namespace smooth::application::network::http::utils
 
         return "";
     }
+
+    static bool parse_position(std::string_view digits, std::size_t& value)
+    {
+        auto res = true;
+        value = 0;
+
+        for (auto c : digits)
+        {
+            res = res && std::isdigit(static_cast<unsigned char>(c));
+
+            if (res)
+            {
+                auto digit = static_cast<std::size_t>(c - '0');
+
+                // Positions beyond what can be represented are beyond the end of any file.
+                value = value > (std::numeric_limits<std::size_t>::max() - digit) / 10
+                        ? std::numeric_limits<std::size_t>::max()
+                        : value * 10 + digit;
+            }
+        }
+
+        return res;
+    }
+
+    bool parse_byte_ranges(std::string_view value, std::size_t size, std::vector<ByteRange>& ranges)
+    {
+        static constexpr std::string_view unit{ "bytes=" };
+        static constexpr std::size_t max_ranges = 16;
+
+        ranges.clear();
+
+        auto res = value.size() > unit.size()
+                   && std::equal(unit.begin(), unit.end(), value.begin(), [](char a, char b) {
+                                     return a == std::tolower(static_cast<unsigned char>(b));
+                                 });
+
+        std::size_t count = 0;
+        auto pos = unit.size();
+
+        while (res && pos < value.size())
+        {
+            auto end = std::min(value.find(',', pos), value.size());
+            auto spec = value.substr(pos, end - pos);
+            pos = end + 1;
+
+            // Elements of the list may be empty and surrounded by whitespace.
+            while (!spec.empty() && (spec.front() == ' ' || spec.front() == '\t'))
+            {
+                spec.remove_prefix(1);
+            }
+
+            while (!spec.empty() && (spec.back() == ' ' || spec.back() == '\t'))
+            {
+                spec.remove_suffix(1);
+            }
+
+            if (!spec.empty())
+            {
+                auto dash = spec.find('-');
+                auto first_digits = spec.substr(0, dash);
+                auto last_digits = dash == std::string_view::npos ? std::string_view{} : spec.substr(dash + 1);
+                std::size_t first = 0;
+                std::size_t last = 0;
+
+                res = ++count <= max_ranges
+                      && dash != std::string_view::npos
+                      && !(first_digits.empty() && last_digits.empty())
+                      && parse_position(first_digits, first)
+                      && parse_position(last_digits, last)
+                      && (first_digits.empty() || last_digits.empty() || first <= last);
+
+                if (res)
+                {
+                    if (first_digits.empty())
+                    {
+                        // The last N bytes.
+                        if (last > 0 && size > 0)
+                        {
+                            ranges.push_back(ByteRange{ size - std::min(last, size), size - 1 });
+                        }
+                    }
+                    else if (first < size)
+                    {
+                        ranges.push_back(ByteRange{ first, last_digits.empty() ? size - 1 : std::min(last, size - 1) });
+                    }
+                }
+            }
+        }
+
+        res = res && count > 0;
+
+        if (!res)
+        {
+            ranges.clear();
+        }
+
+        return res;
+    }
+
+    bool is_encoding_acceptable(const std::string& accept_encoding, const char* coding)
+    {
+        // Accept-Encoding: br;q=1.0, gzip;q=0.8, *;q=0.1
+        auto res = false;
+        auto listed = false;
+
+        for (const auto& part : string_util::split(accept_encoding, ",", true))
+        {
+            auto params = string_util::split(part, ";", true);
+
+            if (!params.empty())
+            {
+                const auto& name = params[0];
+                auto exact = string_util::iequals(name, coding);
+
+                // A wildcard only applies to codings not explicitly listed.
+                if (exact || (!listed && name == "*"))
+                {
+                    auto q = 1.0;
+
+                    for (auto p = params.begin() + 1; p != params.end(); ++p)
+                    {
+                        if (p->size() > 2 && (*p)[0] == 'q' && (*p)[1] == '=')
+                        {
+                            q = std::strtod(p->c_str() + 2, nullptr);
+                        }
+                    }
+
+                    res = q > 0.0;
+                    listed = exact;
+                }
+            }
+        }
+
+        return res;
+    }
 }
@@ -31,4 +31,16 @@ namespace smooth::application::network::http::regular
     const char* SEC_WEBSOCKET_PROTOCOL = "sec-websocket-protocol";
     const char* SEC_WEBSOCKET_VERSION = "sec-websocket-version";
     const char* SEC_WEBSOCKET_ACCEPT = "sec-websocket-accept";
+    const char* ETAG = "etag";
+    const char* IF_NONE_MATCH = "if-none-match";
+    const char* IF_MODIFIED_SINCE = "if-modified-since";
+    const char* ACCEPT_ENCODING = "accept-encoding";
+    const char* CONTENT_ENCODING = "content-encoding";
+    const char* VARY = "vary";
+    const char* TRANSFER_ENCODING = "transfer-encoding";
+    const char* DATE = "date";
+    const char* ACCEPT_RANGES = "accept-ranges";
+    const char* CONTENT_RANGE = "content-range";
+    const char* RANGE = "range";
+    const char* IF_RANGE = "if-range";
 }
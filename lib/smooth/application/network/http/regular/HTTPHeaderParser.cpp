@@ -0,0 +1,131 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/network/http/regular/HTTPHeaderParser.h"
+#include <cstring>
+
+namespace smooth::application::network::http::regular
+{
+    bool HTTPHeaderParser::parse(const uint8_t* buffer, std::size_t available)
+    {
+        // Everything before line_start has been parsed, so that is where the search for the next line feed
+        // resumes. memchr() is vectorized in most C libraries, making this much faster than a byte-wise loop.
+        while (!complete && line_start < available)
+        {
+            const auto* lf = static_cast<const uint8_t*>(std::memchr(buffer + line_start, '\n',
+                                                                        available - line_start));
+
+            if (lf == nullptr)
+            {
+                break;
+            }
+
+            auto line_end = static_cast<std::size_t>(lf - buffer);
+            auto next_line = line_end + 1;
+
+            // Lines should end with CRLF, but a single LF is also accepted (RFC 7230, 3.5).
+            if (line_end > line_start && buffer[line_end - 1] == '\r')
+            {
+                --line_end;
+            }
+
+            if (line_end == line_start)
+            {
+                // Empty lines before the start line are ignored, after it they end the header block.
+                if (start_line_found)
+                {
+                    complete = true;
+                    header_size = next_line;
+                }
+            }
+            else
+            {
+                parse_line(buffer, line_start, line_end);
+            }
+
+            line_start = next_line;
+        }
+
+        return complete;
+    }
+
+    void HTTPHeaderParser::reset()
+    {
+        line_start = 0;
+        header_size = 0;
+        start_line_found = false;
+        complete = false;
+        start_line = {};
+        fields.clear();
+    }
+
+    void HTTPHeaderParser::parse_line(const uint8_t* buffer, std::size_t begin, std::size_t end)
+    {
+        if (!start_line_found)
+        {
+            start_line_found = true;
+            start_line = { begin, end - begin };
+        }
+        else if (is_whitespace(buffer[begin]))
+        {
+            // Obsolete line folding; a continuation of the previous field's value.
+            while (begin < end && is_whitespace(buffer[begin]))
+            {
+                ++begin;
+            }
+
+            if (!fields.empty() && begin < end)
+            {
+                Field field{};
+                field.name = fields.back().name;
+                field.value = { begin, end - begin };
+                field.folded = true;
+                fields.push_back(field);
+            }
+        }
+        else
+        {
+            const auto* colon = static_cast<const uint8_t*>(std::memchr(buffer + begin, ':', end - begin));
+
+            if (colon != nullptr)
+            {
+                auto name_end = static_cast<std::size_t>(colon - buffer);
+                auto value_begin = name_end + 1;
+                auto value_end = end;
+
+                // Strip optional white space around the value (RFC 7230, 3.2)
+                while (value_begin < value_end && is_whitespace(buffer[value_begin]))
+                {
+                    ++value_begin;
+                }
+
+                while (value_end > value_begin && is_whitespace(buffer[value_end - 1]))
+                {
+                    --value_end;
+                }
+
+                if (name_end > begin)
+                {
+                    Field field{};
+                    field.name = { begin, name_end - begin };
+                    field.value = { value_begin, value_end - value_begin };
+                    fields.push_back(field);
+                }
+            }
+        }
+    }
+}
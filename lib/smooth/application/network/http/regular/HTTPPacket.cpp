@@ -17,10 +17,13 @@ limitations under the License.
 
 #include "smooth/application/network/http/HTTPPacket.h"
 
+#include <cstring>
 #include <string>
 #include <unordered_map>
 #include <algorithm>
 #include "smooth/application/network/http/http_utils.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+#include "smooth/application/network/http/regular/StatusLines.h"
 
 namespace smooth::application::network::http
 {
@@ -30,28 +33,21 @@ namespace smooth::application::network::http
                            const std::unordered_map<std::string, std::string>& new_headers,
                            const std::vector<uint8_t>& response_content)
     {
-        append("HTTP/");
-        append(version);
-        append(" ");
-        append(std::to_string(static_cast<int>(code)));
-        append(" ");
-        append(response_code_to_text.at(code));
-        append("\r\n");
+        // Origin servers must send a Date header, https://tools.ietf.org/html/rfc7231#section-7.1.1.2
+        const auto add_date = new_headers.find(DATE) == new_headers.end();
+        const auto line = version == "1.1" ? status_line(code) : std::string_view{};
 
-        for (const auto& header : new_headers)
+        if (line.empty())
         {
-            const auto& key = header.first;
-            const auto& value = header.second;
+            const auto reason = response_code_to_text.find(code);
 
-            add_header(key, value);
+            write_message({ "HTTP/", version, " ", std::to_string(static_cast<int>(code)), " ",
+                            reason == response_code_to_text.end() ? "" : reason->second, "\r\n" },
+                          new_headers, add_date, response_content);
         }
-
-        // Add required ending CRLF
-        append("\r\n");
-
-        if (!response_content.empty())
+        else
         {
-            std::copy(response_content.begin(), response_content.end(), std::back_inserter(content));
+            write_message({ line }, new_headers, add_date, response_content);
         }
     }
 
@@ -60,40 +56,74 @@ namespace smooth::application::network::http
                            const std::unordered_map<std::string, std::string>& new_headers,
                            const std::vector<uint8_t>& response_content)
     {
-        append(utils::http_method_to_string(method));
-        append(" ");
-        append(url);
-        append(" HTTP/1.1");
-        append("\r\n");
+        write_message({ utils::http_method_to_string(method), " ", url, " HTTP/1.1\r\n" },
+                      new_headers, false, response_content);
+    }
+
+    void HTTPPacket::write_message(std::initializer_list<std::string_view> start_line,
+                                   const std::unordered_map<std::string, std::string>& new_headers,
+                                   bool add_date,
+                                   const std::vector<uint8_t>& message_content)
+    {
+        constexpr std::string_view separator{ ": " };
+        constexpr std::string_view crlf{ "\r\n" };
+        const std::string_view date = add_date ? utils::http_time_now() : std::string_view{};
+
+        std::size_t size = 0;
+
+        for (const auto& part : start_line)
+        {
+            size += part.size();
+        }
 
         for (const auto& header : new_headers)
         {
-            const auto& key = header.first;
-            const auto& value = header.second;
+            size += header.first.size() + separator.size() + header.second.size() + crlf.size();
+        }
 
-            add_header(key, value);
+        if (add_date)
+        {
+            size += std::char_traits<char>::length(DATE) + separator.size() + date.size() + crlf.size();
         }
 
-        // Add required ending CRLF
-        append("\r\n");
+        // Required ending CRLF
+        size += crlf.size() + message_content.size();
+
+        content.resize(size);
+        auto* pos = content.data();
+
+        const auto write = [&pos](std::string_view s) {
+                               std::memcpy(pos, s.data(), s.size());
+                               pos += s.size();
+                           };
 
-        if (!response_content.empty())
+        for (const auto& part : start_line)
         {
-            std::copy(response_content.begin(), response_content.end(), std::back_inserter(content));
+            write(part);
         }
-    }
 
-    void HTTPPacket::append(const std::string& s)
-    {
-        std::copy(s.begin(), s.end(), std::back_inserter(content));
-    }
+        for (const auto& header : new_headers)
+        {
+            write(header.first);
+            write(separator);
+            write(header.second);
+            write(crlf);
+        }
 
-    void HTTPPacket::add_header(const std::string& key, const std::string& value)
-    {
-        append(key);
-        append(": ");
-        append(value);
-        append("\r\n");
+        if (add_date)
+        {
+            write(DATE);
+            write(separator);
+            write(date);
+            write(crlf);
+        }
+
+        write(crlf);
+
+        if (!message_content.empty())
+        {
+            std::memcpy(pos, message_content.data(), message_content.size());
+        }
     }
 
     HTTPPacket::HTTPPacket(std::vector<uint8_t>& response_content)
@@ -0,0 +1,142 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/network/http/regular/HeaderFields.h"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+
+namespace smooth::application::network::http::regular
+{
+    bool HeaderFields::equal_names(std::string_view a, std::string_view b)
+    {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                          [](unsigned char c, unsigned char c2) {
+                              return std::tolower(c) == std::tolower(c2);
+                          });
+    }
+
+    void HeaderFields::add(std::string_view name, std::string_view value)
+    {
+        if (!fields.empty() && equal_names(this->name(fields.size() - 1), name))
+        {
+            append(", ", value);
+        }
+        else
+        {
+            map_valid = false;
+
+            Field f{};
+            f.name_offset = static_cast<uint32_t>(buffer.size());
+            f.name_length = static_cast<uint32_t>(name.size());
+
+            std::transform(name.begin(), name.end(), std::back_inserter(buffer),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+            f.value_offset = static_cast<uint32_t>(buffer.size());
+            f.value_length = static_cast<uint32_t>(value.size());
+            buffer.append(value.data(), value.size());
+
+            fields.push_back(f);
+        }
+    }
+
+    void HeaderFields::append(std::string_view separator, std::string_view value)
+    {
+        // The value of the last field is always at the end of the buffer, so it can be extended in place.
+        if (!fields.empty())
+        {
+            map_valid = false;
+
+            buffer.append(separator.data(), separator.size()).append(value.data(), value.size());
+            fields.back().value_length += static_cast<uint32_t>(separator.size() + value.size());
+        }
+    }
+
+    const HeaderFields::Field* HeaderFields::find(std::string_view name) const
+    {
+        const Field* res = nullptr;
+
+        for (auto it = fields.begin(); res == nullptr && it != fields.end(); ++it)
+        {
+            if (equal_names(std::string_view{ buffer }.substr(it->name_offset, it->name_length), name))
+            {
+                res = &*it;
+            }
+        }
+
+        return res;
+    }
+
+    std::string_view HeaderFields::get(std::string_view name) const
+    {
+        std::string_view res{};
+        const auto* f = find(name);
+
+        if (f)
+        {
+            res = std::string_view{ buffer }.substr(f->value_offset, f->value_length);
+        }
+
+        return res;
+    }
+
+    bool HeaderFields::contains(std::string_view name) const
+    {
+        return find(name) != nullptr;
+    }
+
+    const std::unordered_map<std::string, std::string>& HeaderFields::as_map() const
+    {
+        if (!map_valid)
+        {
+            map.clear();
+
+            for (std::size_t i = 0; i < fields.size(); ++i)
+            {
+                auto& v = map[std::string{ name(i) }];
+
+                if (v.empty())
+                {
+                    v = value(i);
+                }
+                else
+                {
+                    v.append(", ").append(value(i));
+                }
+            }
+
+            map_valid = true;
+        }
+
+        return map;
+    }
+
+    void HeaderFields::clear()
+    {
+        buffer.clear();
+        fields.clear();
+        map.clear();
+        map_valid = false;
+    }
+
+    void HeaderFields::reserve(std::size_t bytes, std::size_t count)
+    {
+        buffer.reserve(bytes);
+        fields.reserve(count);
+    }
+}
@@ -16,26 +16,39 @@ limitations under the License.
 */
 
 #include "smooth/application/network/http/regular/MIMEParser.h"
+#include <algorithm>
+#include <cstring>
+#include <string_view>
 #include <vector>
+#include "smooth/core/logging/log.h"
 #include "smooth/core/util/split.h"
 #include "smooth/core/util/string_util.h"
 #include "smooth/application/network/http/URLEncoding.h"
+#include "smooth/application/network/http/regular/HeaderFields.h"
 #include "smooth/application/network/http/regular/HTTPMethod.h"
 #include "smooth/application/network/http/regular/HTTPHeaderDef.h"
 
 using namespace smooth::core::util;
+using namespace smooth::core::logging;
 using namespace smooth::core;
 
 namespace smooth::application::network::http::regular
 {
     void MIMEParser::reset() noexcept
     {
-        boundary.clear();
-        end_boundary.clear();
+        delimiter.clear();
+        tail.clear();
+        window.clear();
+        part_headers.clear();
+        field_name.clear();
+        file_name.clear();
+        first_chunk = true;
+        delimiter_suffix = 0;
         form_url_encoded_data.clear();
         data.clear();
         expected_content_length = 0;
         mode = Mode::None;
+        state = State::Preamble;
     }
 
     bool MIMEParser::detect_mode(const std::string& content_type, std::size_t content_length)
@@ -52,24 +65,23 @@ namespace smooth::application::network::http::regular
             // of the preceding part. The boundary must be followed immediately either by another CRLF and the header
             // fields for the next part, or by two CRLFs, in which case there are no header fields for the next part
             // (and it is therefore assumed to be of Content-Type text/plain).
+            delimiter = { '\r', '\n', '-', '-' };
+            delimiter.insert(delimiter.end(), b.begin(), b.end());
 
-            // Note that we don't include the leading CRLF in the boundary pattern - that is handled separately
-            // so that we also match the very first boundary after the HTTP-headers.
-            boundary = { b.begin(), b.end() };
-            boundary.insert(boundary.begin(), '-');
-            boundary.insert(boundary.begin(), '-');
+            // Boyer-Moore-Horspool skip table: how far the search may move when the byte under
+            // the last position of the delimiter doesn't match.
+            const auto last = delimiter.size() - 1;
+            skip.fill(delimiter.size());
 
-            end_boundary = boundary;
-
-            boundary.emplace_back('\r');
-            boundary.emplace_back('\n');
-
-            // The ending boundary is the same as the normal one, but suffixed by "--\r\n" instead of just \r\n
-            end_boundary.emplace_back('-');
-            end_boundary.emplace_back('-');
-            end_boundary.emplace_back('\r');
-            end_boundary.emplace_back('\n');
+            for (std::size_t i = 0; i < last; ++i)
+            {
+                skip[delimiter[i]] = last - i;
+            }
 
+            // The first boundary may come directly after the HTTP-headers, without a preceding CRLF, so
+            // start out as if there were one.
+            tail = { '\r', '\n' };
+            state = State::Preamble;
             mode = Mode::FormData;
         }
         else if (std::regex_match(content_type.begin(), content_type.end(), match, url_encoded_pattern))
@@ -82,253 +94,321 @@ namespace smooth::application::network::http::regular
         return mode != Mode::None;
     }
 
-    auto MIMEParser::find_boundaries() const
+    void MIMEParser::parse(const uint8_t* p, std::size_t length, const FormDataCallback& content_callback,
+                           const URLEncodedDataCallback& url_data)
     {
-        Boundaries b{};
-
-        // Don't search until there are actually enough data
-        if (data.size() > boundary.size() * 2)
+        if (mode == Mode::FormData)
+        {
+            parse_form_data(p, p + length, content_callback);
+        }
+        else if (mode == Mode::FormURLEncoded)
         {
-            auto p = std::search(data.cbegin(), data.cend(), boundary.cbegin(), boundary.cend());
+            data.insert(data.end(), p, p + length);
+            parse_url_encoded(url_data);
+        }
+    }
+
+    void MIMEParser::parse_form_data(const uint8_t* begin, const uint8_t* end,
+                                     const FormDataCallback& content_callback)
+    {
+        auto pos = begin;
 
-            while (p != data.cend())
+        while (pos != end && state != State::Done)
+        {
+            if (state == State::Preamble || state == State::Content)
             {
-                b.emplace_back(p);
-                p = std::search(p + 1, data.cend(), boundary.cbegin(), boundary.cend());
+                pos = scan_for_delimiter(pos, end, content_callback);
             }
-
-            // Also find the end boundary
-            p = std::search(data.cbegin(), data.cend(), end_boundary.cbegin(), end_boundary.cend());
-
-            if (p != data.end())
+            else if (state == State::AfterDelimiter)
             {
-                b.emplace_back(p);
+                pos = parse_after_delimiter(pos, end);
+            }
+            else
+            {
+                pos = parse_headers(pos, end);
             }
-
-            // Adjust for possible preceding CRLF, as the CRLF is considered part of the boundary.
-            adjust_boundary_beginning_for_crlf(data.begin(), b);
         }
-
-        return b;
     }
 
-    void MIMEParser::parse(const uint8_t* p, std::size_t length, const FormDataCallback& content_callback,
-                           const URLEncodedDataCallback& url_data)
+    const uint8_t* MIMEParser::scan_for_delimiter(const uint8_t* begin, const uint8_t* end,
+                                                  const FormDataCallback& content_callback)
     {
-        for (std::size_t i = 0; i < length; ++i)
-        {
-            data.emplace_back(p[i]);
-        }
+        const uint8_t* res = end;
+        auto done = false;
 
-        if (mode == Mode::FormData)
+        if (!tail.empty())
         {
-            auto bounds = find_boundaries();
+            // A delimiter may have started within the tail kept from the previous data;
+            // join it with just enough of the new data to tell.
+            const auto take = std::min(static_cast<std::size_t>(end - begin), delimiter.size() - 1);
+            window.assign(tail.begin(), tail.end());
+            window.insert(window.end(), begin, begin + take);
 
-            auto last_consumed = data.cend();
+            const auto* w_begin = window.data();
+            const auto* w_end = w_begin + window.size();
+            const auto* match = find_delimiter(w_begin, w_end);
 
-            // Each content block is contained between two boundaries
-            while (!bounds.empty() && bounds.size() >= 2)
+            if (match != w_end)
             {
-                auto start_of_content = get_end_of_boundary(bounds.front());
-                bounds.erase(bounds.cbegin());
-                auto end_of_content = bounds.front();
-                last_consumed = end_of_content;
-
-                parse_content(start_of_content, end_of_content, content_callback);
+                emit(w_begin, match, true, content_callback);
+                res = begin + (static_cast<std::size_t>(match - w_begin) + delimiter.size() - tail.size());
+                tail.clear();
+                state = State::AfterDelimiter;
+                done = true;
             }
-
-            // Erase already consumed data
-            if (last_consumed != data.cend())
+            else if (take == delimiter.size() - 1)
             {
-                data.erase(data.begin(), last_consumed);
+                // No delimiter starts within the tail, continue with the new data.
+                emit(tail.data(), tail.data() + tail.size(), false, content_callback);
+                tail.clear();
             }
-        }
-        else if (mode == Mode::FormURLEncoded)
-        {
-            // URL encoded data can't be parsed in chunks, so wait until all data is received
-            if (data.size() >= expected_content_length)
+            else
             {
-                // Split data on '&' as it comes in. Each part is then expected to contain X=Y, so split on '='.
-                // If a part doesn't contain a '=', put it back in the buffer to be used next time.
-                // The way this works is that split() places any leftovers last in the returned vector
-                // which means that it will be encountered last, thus the loops end at the same time.
-
-                auto parts = split(data, std::vector<uint8_t>{ '&' });
-
-                if (!parts.empty())
-                {
-                    data.clear();
-                }
-
-                URLEncoding encoding{};
+                // Still not enough data to tell, keep what may be the start of a delimiter.
+                const auto* keep = possible_delimiter_start(w_begin, w_end);
+                emit(w_begin, keep, false, content_callback);
+                tail.assign(keep, w_end);
+                done = true;
+            }
+        }
 
-                for (const auto& part : parts)
-                {
-                    auto equal_sign = std::find(part.cbegin(), part.cend(), '=');
+        if (!done)
+        {
+            const auto* match = find_delimiter(begin, end);
 
-                    if (equal_sign == part.cend())
-                    {
-                        std::copy(std::make_move_iterator(part.begin()),
-                                  std::make_move_iterator(part.end()),
-                                  std::back_inserter(data));
-                    }
-                    else
-                    {
-                        auto key_value = split(part, std::vector<uint8_t>{ '=' });
+            if (match != end)
+            {
+                emit(begin, match, true, content_callback);
+                res = match + delimiter.size();
+                state = State::AfterDelimiter;
+            }
+            else
+            {
+                const auto* keep = possible_delimiter_start(begin, end);
+                emit(begin, keep, false, content_callback);
+                tail.assign(keep, end);
+            }
+        }
 
-                        if (!key_value.empty())
-                        {
-                            std::string key{ key_value[0].begin(), key_value[0].end() };
-                            auto key_res = encoding.decode(key, key.begin(), key.end());
+        return res;
+    }
 
-                            std::string value{ key_value[1].begin(), key_value[1].end() };
-                            auto value_res = encoding.decode(value, value.begin(), value.end());
+    const uint8_t* MIMEParser::parse_after_delimiter(const uint8_t* begin, const uint8_t* end)
+    {
+        // The delimiter is followed by "--" for the last part or by optional whitespace and CRLF otherwise.
+        auto pos = begin;
 
-                            if (key_res && value_res)
-                            {
-                                form_url_encoded_data.emplace(key, value);
-                            }
-                        }
-                    }
-                }
+        while (pos != end && state == State::AfterDelimiter)
+        {
+            const auto c = *pos++;
 
-                // Perform the callback to the response handler with the parsed and decoded data.
-                url_data(form_url_encoded_data);
+            if (delimiter_suffix == 0 && (c == ' ' || c == '\t'))
+            {
+                // Transport padding
+            }
+            else if (delimiter_suffix == 0 && (c == '-' || c == '\r'))
+            {
+                delimiter_suffix = c;
+            }
+            else if (delimiter_suffix == '-' && c == '-')
+            {
+                state = State::Done;
+            }
+            else if (delimiter_suffix == '\r' && c == '\n')
+            {
+                // The CRLF ending the boundary line is kept first in the header buffer so that
+                // a part without headers ends up with the same CRLFCRLF sequence as one with headers.
+                part_headers = { '\r', '\n' };
+                field_name.clear();
+                file_name.clear();
+                first_chunk = true;
+                state = State::Headers;
+            }
+            else
+            {
+                Log::error("MIMEParser", "Malformed multipart boundary");
+                state = State::Done;
             }
         }
-    }
 
-    MIMEParser::BoundaryIterator MIMEParser::get_end_of_boundary(BoundaryIterator begin)
-    {
-        // Adjust for CRLF at beginning of boundary pattern
-        auto offset = is_crlf(begin) ? 2 : 0;
+        if (state != State::AfterDelimiter)
+        {
+            delimiter_suffix = 0;
+        }
 
-        return begin + static_cast<Boundaries::difference_type>(boundary.size()) + offset;
+        return pos;
     }
 
-    void MIMEParser::parse_content(BoundaryIterator start_of_content, BoundaryIterator end_of_content,
-                                   const FormDataCallback& cb) const
+    const uint8_t* MIMEParser::parse_headers(const uint8_t* begin, const uint8_t* end)
     {
-        // If the first data isn't a CRLF, then there are one or more Content-headers for this data.
-        if (is_crlf(start_of_content))
-        {
-            // All content is considered text/plain
-            cb("", "", start_of_content, end_of_content);
-        }
-        else
+        const std::array<uint8_t, 4> crlf_double{ '\r', '\n', '\r', '\n' };
+        const auto previous_size = part_headers.size();
+        const auto take = std::min(static_cast<std::size_t>(end - begin),
+                                   max_part_header_size - std::min(previous_size, max_part_header_size));
+
+        part_headers.insert(part_headers.end(), begin, begin + take);
+
+        // Only search the new data, and the part of the previous data the ending may have begun in.
+        const auto search_start = part_headers.begin() + static_cast<long>(previous_size < 3 ? 0 : previous_size - 3);
+        const auto found = std::search(search_start, part_headers.end(), crlf_double.begin(), crlf_double.end());
+        const uint8_t* res = begin + take;
+
+        if (found != part_headers.end())
         {
-            auto [new_start_of_content, headers,
-                  content_dispositon] = consume_headers(start_of_content, end_of_content);
+            const auto header_end = static_cast<std::size_t>(std::distance(part_headers.begin(), found))
+                                    + crlf_double.size();
+            res = begin + (header_end - previous_size);
+            part_headers.resize(header_end);
 
-            start_of_content = new_start_of_content;
+            std::string_view headers{ reinterpret_cast<const char*>(part_headers.data()), part_headers.size() };
 
-            if (start_of_content != end_of_content)
+            // Skip the initial CRLF, then handle one header line at a time up to the ending empty line.
+            for (auto line_start = headers.find("\r\n") + 2; line_start < header_end - 2;)
             {
-                cb(content_dispositon["name"], content_dispositon["filename"], start_of_content, end_of_content);
+                const auto line_end = headers.find("\r\n", line_start);
+                const auto line = headers.substr(line_start, line_end - line_start);
+                const auto colon = line.find(':');
+
+                if (colon != std::string_view::npos
+                    && HeaderFields::equal_names(line.substr(0, colon), CONTENT_DISPOSITION))
+                {
+                    parse_content_disposition(std::string{ line.substr(colon + 1) });
+                }
+
+                line_start = line_end + 2;
             }
 
-            (void)headers;
+            state = State::Content;
+        }
+        else if (part_headers.size() >= max_part_header_size)
+        {
+            Log::error("MIMEParser", "Part headers larger than {} bytes", max_part_header_size);
+            state = State::Done;
         }
+
+        return res;
     }
 
-    void MIMEParser::adjust_boundary_beginning_for_crlf(MIMEParser::BoundaryIterator start_of_data,
-                                                        MIMEParser::Boundaries& found_boundaries) const
+    const uint8_t* MIMEParser::find_delimiter(const uint8_t* begin, const uint8_t* end) const
     {
-        for (auto& current : found_boundaries)
+        // Boyer-Moore-Horspool; compares the last byte of the delimiter first and skips ahead
+        // according to the skip table on mismatch.
+        const uint8_t* res = end;
+        const auto length = delimiter.size();
+        const auto last = length - 1;
+        auto pos = begin;
+
+        while (res == end && static_cast<std::size_t>(end - pos) >= length)
         {
-            auto distance = static_cast<long>(std::distance(start_of_data, current));
-            auto offset = static_cast<long>(crlf.size());
+            const auto c = pos[last];
 
-            if (distance > offset)
+            if (c == delimiter[last] && std::memcmp(pos, delimiter.data(), last) == 0)
             {
-                // Check if the boundary has a preceding CRLF
-                if (is_crlf(start_of_data + distance - offset))
-                {
-                    current = start_of_data + distance - offset;
-                }
+                res = pos;
+            }
+            else
+            {
+                pos += skip[c];
             }
         }
+
+        return res;
     }
 
-    bool MIMEParser::is_crlf(MIMEParser::BoundaryIterator start) const
+    const uint8_t* MIMEParser::possible_delimiter_start(const uint8_t* begin, const uint8_t* end) const
     {
-        return *start == '\r' && *(start + 1) == '\n';
+        // The delimiter starts with CR, so only data from the first CR within the last
+        // delimiter.size() - 1 bytes can be the beginning of one.
+        const auto* from = end - std::min(static_cast<std::size_t>(end - begin), delimiter.size() - 1);
+
+        return std::find(from, end, '\r');
     }
 
-    std::tuple<MIMEParser::BoundaryIterator,
-               std::unordered_map<std::string, std::string>,
-               std::unordered_map<std::string, std::string>> MIMEParser::consume_headers(
-        MIMEParser::BoundaryIterator begin,
-        MIMEParser::BoundaryIterator end) const
+    void MIMEParser::emit(const uint8_t* begin, const uint8_t* end, bool last,
+                          const FormDataCallback& content_callback)
     {
-        std::unordered_map<std::string, std::string> headers{};
-        std::unordered_map<std::string, std::string> content_disp{};
-        auto start_of_actual_content = end;
-
-        auto end_of_headers = std::search(begin, end, crlf_double.begin(), crlf_double.end());
+        if (state == State::Content && (begin != end || last))
+        {
+            content_callback(field_name, file_name, begin, end, first_chunk, last);
+            first_chunk = last;
+        }
+    }
 
-        if (end_of_headers != end)
+    void MIMEParser::parse_url_encoded(const URLEncodedDataCallback& url_data)
+    {
+        // URL encoded data can't be parsed in chunks, so wait until all data is received
+        if (data.size() >= expected_content_length)
         {
-            start_of_actual_content = end_of_headers + static_cast<long>(crlf_double.size());
+            // Split data on '&' as it comes in. Each part is then expected to contain X=Y, so split on '='.
+            // If a part doesn't contain a '=', put it back in the buffer to be used next time.
+            // The way this works is that split() places any leftovers last in the returned vector
+            // which means that it will be encountered last, thus the loops end at the same time.
 
-            std::stringstream ss;
+            auto parts = split(data, std::vector<uint8_t>{ '&' });
 
-            std::for_each(begin, end_of_headers, [&ss](auto& c) {
-                              if (c != '\n')
-                              {
-                                  ss << static_cast<char>(c);
-                              }
-            });
+            if (!parts.empty())
+            {
+                data.clear();
+            }
 
-            std::string s;
+            URLEncoding encoding{};
 
-            while (std::getline(ss, s, '\r'))
+            for (const auto& part : parts)
             {
-                auto colon = std::find(s.begin(), s.end(), ':');
+                auto equal_sign = std::find(part.cbegin(), part.cend(), '=');
 
-                if (colon != s.end() && !s.empty())
+                if (equal_sign == part.cend())
                 {
-                    if (std::distance(colon, s.end()) > 2)
+                    std::copy(std::make_move_iterator(part.begin()),
+                              std::make_move_iterator(part.end()),
+                              std::back_inserter(data));
+                }
+                else
+                {
+                    auto key_value = split(part, std::vector<uint8_t>{ '=' });
+
+                    if (!key_value.empty())
                     {
-                        headers[string_util::to_lower_copy({ s.begin(), colon })] = { colon + 2, s.end() };
+                        std::string key{ key_value[0].begin(), key_value[0].end() };
+                        auto key_res = encoding.decode(key, key.begin(), key.end());
+
+                        std::string value{ key_value[1].begin(), key_value[1].end() };
+                        auto value_res = encoding.decode(value, value.begin(), value.end());
+
+                        if (key_res && value_res)
+                        {
+                            form_url_encoded_data.emplace(key, value);
+                        }
                     }
                 }
-
-                parse_content_disposition(headers, content_disp);
             }
-        }
 
-        return std::make_tuple(start_of_actual_content, std::move(headers), std::move(content_disp));
+            // Perform the callback to the response handler with the parsed and decoded data.
+            url_data(form_url_encoded_data);
+        }
     }
 
-    void MIMEParser::parse_content_disposition(const std::unordered_map<std::string, std::string>& headers,
-                                               std::unordered_map<std::string, std::string>& content_disposition) const
+    void MIMEParser::parse_content_disposition(const std::string& content_disposition)
     {
-        try
+        // Content-Disposition: form-data; name="field"; filename="file.txt"
+        for (const auto& p : string_util::split(content_disposition, ";", true))
         {
-            const auto& content_dis = headers.at(CONTENT_DISPOSITION);
-
-            auto part = string_util::split(content_dis, ";", true);
+            auto key_value = string_util::split(p, "=", true);
 
-            for (const auto& p : part)
+            if (key_value.size() > 1)
             {
-                auto key_value = string_util::split(p, "=", true);
+                // Remove leading and ending quotation mark
+                auto filter = [](char c) { return c != '"'; };
 
-                if (key_value.size() > 1)
+                if (key_value[0] == "name")
                 {
-                    // Remove leading and ending quotation mark
-                    auto filter = [](char c) { return c != '"'; };
-                    content_disposition[key_value[0]] = string_util::trim(key_value[1], filter);
+                    field_name = string_util::trim(key_value[1], filter);
                 }
-                else
+                else if (key_value[0] == "filename")
                 {
-                    // Single-value data
-                    content_disposition[key_value[0]] = key_value[0];
+                    file_name = string_util::trim(key_value[1], filter);
                 }
             }
         }
-        catch (...)
-        {
-        }
     }
 }
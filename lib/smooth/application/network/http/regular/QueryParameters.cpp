@@ -0,0 +1,141 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/network/http/regular/QueryParameters.h"
+
+namespace smooth::application::network::http::regular
+{
+    void QueryParameters::assign(std::string_view query_string)
+    {
+        clear();
+        query.assign(query_string.data(), query_string.size());
+    }
+
+    void QueryParameters::split() const
+    {
+        if (!split_done)
+        {
+            // Only supporting key=value format.
+            std::size_t pos = 0;
+
+            while (pos < query.size())
+            {
+                auto ampersand = query.find('&', pos);
+
+                if (ampersand == std::string::npos)
+                {
+                    ampersand = query.size();
+                }
+
+                auto equal_sign = query.find('=', pos);
+
+                if (equal_sign < ampersand)
+                {
+                    pairs.push_back(Pair{ pos, equal_sign - pos, equal_sign + 1, ampersand - equal_sign - 1 });
+                }
+
+                pos = ampersand + 1;
+            }
+
+            split_done = true;
+        }
+    }
+
+    const QueryParameters::Pair* QueryParameters::find(std::string_view key) const
+    {
+        split();
+
+        const Pair* res = nullptr;
+
+        // When a key is repeated, the last occurrence wins.
+        for (const auto& p : pairs)
+        {
+            if (std::string_view{ query }.substr(p.key_offset, p.key_length) == key)
+            {
+                res = &p;
+            }
+        }
+
+        return res;
+    }
+
+    std::string_view QueryParameters::get(std::string_view key) const
+    {
+        std::string_view res{};
+        const auto* p = find(key);
+
+        if (p)
+        {
+            res = std::string_view{ query }.substr(p->value_offset, p->value_length);
+        }
+
+        return res;
+    }
+
+    bool QueryParameters::contains(std::string_view key) const
+    {
+        return find(key) != nullptr;
+    }
+
+    std::size_t QueryParameters::size() const
+    {
+        split();
+
+        return pairs.size();
+    }
+
+    std::string_view QueryParameters::key(std::size_t index) const
+    {
+        split();
+
+        return std::string_view{ query }.substr(pairs[index].key_offset, pairs[index].key_length);
+    }
+
+    std::string_view QueryParameters::value(std::size_t index) const
+    {
+        split();
+
+        return std::string_view{ query }.substr(pairs[index].value_offset, pairs[index].value_length);
+    }
+
+    const std::unordered_map<std::string, std::string>& QueryParameters::as_map() const
+    {
+        if (!map_valid)
+        {
+            map.clear();
+            split();
+
+            for (std::size_t i = 0; i < pairs.size(); ++i)
+            {
+                map[std::string{ key(i) }] = value(i);
+            }
+
+            map_valid = true;
+        }
+
+        return map;
+    }
+
+    void QueryParameters::clear()
+    {
+        query.clear();
+        pairs.clear();
+        split_done = false;
+        map.clear();
+        map_valid = false;
+    }
+}
@@ -16,6 +16,7 @@ limitations under the License.
 */
 
 #include <algorithm>
+#include <cctype>
 #include "smooth/core/util/string_util.h"
 #include "smooth/application/network/http/regular/HTTPHeaderDef.h"
 #include "smooth/application/network/http/regular/RegularHTTPProtocol.h"
@@ -37,15 +38,28 @@ namespace smooth::application::network::http
             amount_to_request = max_header_size - total_bytes_received;
 
             // Make sure there is room for what he have received and what we ask for.
-            packet.expand_by(amount_to_request);
+            auto& data = packet.data();
+            data.resize(std::max(data.size(), static_cast<std::size_t>(max_header_size)));
         }
         else
         {
-            // Never ask for more than content_chunk_size
-            auto remaining_of_content = incoming_content_length - total_content_bytes_received;
-            amount_to_request = std::min(content_chunk_size, remaining_of_content);
+            if (chunked || until_close)
+            {
+                // The end of chunked content is not known up front; fill the current part and set
+                // aside anything beyond the end of the request once it is found. Content ending when the
+                // connection is closed simply fills the current part.
+                amount_to_request = std::max(content_chunk_size - content_bytes_received_in_current_part, 0);
+                auto& data = packet.data();
+                data.resize(std::max(data.size(), static_cast<std::size_t>(content_chunk_size)));
+            }
+            else
+            {
+                // Never ask for more than content_chunk_size
+                auto remaining_of_content = incoming_content_length - total_content_bytes_received;
+                amount_to_request = std::min(content_chunk_size, remaining_of_content);
 
-            packet.expand_by(amount_to_request);
+                packet.expand_by(amount_to_request);
+            }
         }
 
         return amount_to_request;
@@ -53,17 +67,21 @@ namespace smooth::application::network::http
 
     void RegularHTTPProtocol::data_received(HTTPPacket& packet, int length)
     {
+        if (state == State::reading_headers && total_bytes_received == 0)
+        {
+            message_start = std::chrono::steady_clock::now();
+        }
+
         total_bytes_received += length;
 
         if (state == State::reading_headers)
         {
-            const auto end_of_header = packet.find_header_ending();
-
-            if (end_of_header != packet.data().end())
+            // Only the newly received data is parsed.
+            if (header_parser.parse(packet.data().data(), static_cast<std::size_t>(total_bytes_received)))
             {
                 // End of header found
                 state = State::reading_content;
-                actual_header_size = consume_headers(packet, end_of_header);
+                actual_header_size = consume_headers(packet);
                 total_content_bytes_received = total_bytes_received - actual_header_size;
 
                 // content_bytes_received_in_current_part may be larger than content_chunk_size
@@ -71,8 +89,8 @@ namespace smooth::application::network::http
 
                 try
                 {
-                    incoming_content_length = packet.headers()[CONTENT_LENGTH].empty() ? 0 : std::stoi(
-                            packet.headers()[CONTENT_LENGTH]);
+                    const auto content_length = packet.headers().get(CONTENT_LENGTH);
+                    incoming_content_length = content_length.empty() ? 0 : std::stoi(std::string{ content_length });
 
                     if (incoming_content_length < 0)
                     {
@@ -84,6 +102,35 @@ namespace smooth::application::network::http
                 {
                     incoming_content_length = 0;
                 }
+
+                if (is_without_content(packet.response_code()))
+                {
+                    // Whatever follows the headers belongs to the next response.
+                    incoming_content_length = 0;
+                    buffer_surplus(packet);
+                }
+                else if (detect_transfer_coding(packet))
+                {
+                    if (chunked)
+                    {
+                        // Decode whatever was received along with the headers.
+                        auto raw_length = static_cast<std::size_t>(content_bytes_received_in_current_part);
+                        incoming_content_length = 0;
+                        total_content_bytes_received = 0;
+                        content_bytes_received_in_current_part = 0;
+                        decode_chunked(packet, 0, raw_length);
+                    }
+                    else if (!packet.response_version().empty() && packet.headers().get(CONTENT_LENGTH).empty())
+                    {
+                        // The content of a response without a length ends when the server closes the connection,
+                        // https://tools.ietf.org/html/rfc7230#section-3.3.3. Everything received belongs to it.
+                        until_close = true;
+                    }
+                    else
+                    {
+                        buffer_surplus(packet);
+                    }
+                }
             }
             else if (total_bytes_received >= max_header_size)
             {
@@ -98,6 +145,12 @@ namespace smooth::application::network::http
                 reset();
             }
         }
+        else if (chunked)
+        {
+            decode_chunked(packet,
+                           static_cast<std::size_t>(content_bytes_received_in_current_part),
+                           static_cast<std::size_t>(length));
+        }
         else
         {
             total_content_bytes_received += length;
@@ -111,9 +164,10 @@ namespace smooth::application::network::http
             packet.data().resize(static_cast<vector_type::size_type>(content_bytes_received_in_current_part));
 
             packet.set_request_data(last_method, last_url, last_request_version);
+            packet.set_message_start(message_start, static_cast<std::size_t>(actual_header_size));
 
             // When there are more data expected, then this packet is "to be continued"
-            if (total_content_bytes_received < incoming_content_length)
+            if (!is_request_complete())
             {
                 packet.set_continued();
             }
@@ -121,9 +175,9 @@ namespace smooth::application::network::http
             // When still reading the headers, the packet can never be a continuation.
             if (state != State::reading_headers)
             {
-                // If we've already received more data than what fits in a single chunk, then this packet
-                // is a continuation of an earlier packet.
-                if (total_content_bytes_received - content_bytes_received_in_current_part > content_chunk_size)
+                // If content has been received before this packet, then this packet is a continuation
+                // of an earlier packet.
+                if (total_content_bytes_received > content_bytes_received_in_current_part)
                 {
                     // Packet continues a previous packet.
                     packet.set_continuation();
@@ -152,8 +206,14 @@ namespace smooth::application::network::http
     {
         auto complete = state != State::reading_headers;
 
+        // Content ending with the connection is delivered as it is received, as there is no telling
+        // whether more is to come.
         bool content_received =
-            incoming_content_length == 0 // No content to read.
+            until_close
+            ? content_bytes_received_in_current_part > 0 || total_content_bytes_received == 0
+            : chunked
+            ? chunk_state == ChunkState::done || content_bytes_received_in_current_part >= content_chunk_size
+            : incoming_content_length == 0 // No content to read.
             || total_content_bytes_received == incoming_content_length // All content received
             || content_bytes_received_in_current_part >= content_chunk_size; // Packet filled, split into multiple
                                                                              // chunks.
@@ -166,101 +226,346 @@ namespace smooth::application::network::http
         return error;
     }
 
-    int RegularHTTPProtocol::consume_headers(HTTPPacket& packet,
-                                             std::vector<uint8_t>::const_iterator header_ending)
+    int RegularHTTPProtocol::consume_headers(HTTPPacket& packet)
     {
-        std::stringstream ss;
+        auto& data = packet.data();
+        const auto* buffer = reinterpret_cast<const char*>(data.data());
+        const auto view = [buffer](const HTTPHeaderParser::Span& span) {
+                              return std::string_view{ buffer + span.offset, span.length };
+                          };
+
+        parse_start_line(packet, view(header_parser.get_start_line()));
+
+        // Headers are case-insensitive: https://tools.ietf.org/html/rfc7230#section-3.2
+        // Repeated fields are combined into one, and lines continued by obsolete folding are joined with a space,
+        // so that every field ends up as a single contiguous value.
+        const auto& fields = header_parser.get_fields();
+        auto& headers = packet.headers();
+        headers.clear();
+        headers.reserve(header_parser.get_header_size(), fields.size());
+
+        const auto same_name = [&view](const HTTPHeaderParser::Field& a, const HTTPHeaderParser::Field& b) {
+                                   return HeaderFields::equal_names(view(a.name), view(b.name));
+                               };
+
+        for (auto first = fields.begin(); first != fields.end(); ++first)
+        {
+            const auto seen = first->folded
+                              || std::any_of(fields.begin(), first, [&](const HTTPHeaderParser::Field& f) {
+                                                 return !f.folded && same_name(f, *first);
+                                             });
 
-        std::for_each(packet.data().cbegin(),
-                      header_ending,
-                      [&ss](auto& c) {
-                          if (c != '\n')
-                          {
-                              ss << static_cast<char>(c);
-                          }
-        });
+            if (!seen)
+            {
+                auto added = false;
+
+                for (auto curr = first; curr != fields.end(); ++curr)
+                {
+                    if (!curr->folded && same_name(*curr, *first))
+                    {
+                        // Add the field and any folded lines following it.
+                        for (auto line = curr; line != fields.end() && (line == curr || line->folded); ++line)
+                        {
+                            const auto value = view(line->value);
+
+                            if (!value.empty())
+                            {
+                                if (added)
+                                {
+                                    headers.append(line->folded ? " " : ", ", value);
+                                }
+                                else
+                                {
+                                    headers.add(view(first->name), value);
+                                    added = true;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
 
-        // Get actual end of header
-        header_ending += HTTPPacket::ending.size();
+        // Move any content received along with the headers to the start of the buffer.
+        auto actual_header_bytes_received = static_cast<int>(header_parser.get_header_size());
+        auto content_bytes = static_cast<std::size_t>(total_bytes_received - actual_header_bytes_received);
+        auto content_start = data.begin() + actual_header_bytes_received;
+        std::copy(content_start, content_start + static_cast<long>(content_bytes), data.begin());
+        data.resize(content_bytes);
 
-        // Update actual header size
-        auto actual_header_bytes_received = static_cast<int>(std::distance(packet.data().cbegin(), header_ending));
+        return actual_header_bytes_received;
+    }
 
-        // Erase headers from buffer
-        packet.data().erase(packet.data().begin(), header_ending);
+    void RegularHTTPProtocol::parse_start_line(HTTPPacket& packet, std::string_view line)
+    {
+        if (line.compare(0, 5, "HTTP/") == 0)
+        {
+            // HTTP/1.1 200 OK
+            auto code_start = line.find(' ');
+            auto code_end = line.find(' ', code_start == std::string_view::npos ? line.size() : code_start + 1);
+            auto code = code_start == std::string_view::npos
+                        ? std::string_view{}
+                        : line.substr(code_start + 1, code_end - code_start - 1);
 
-        std::string s;
+            auto valid = code.size() == 3
+                         && std::all_of(code.begin(), code.end(), [](unsigned char c) { return std::isdigit(c); });
 
-        while (std::getline(ss, s, '\r'))
+            if (valid)
+            {
+                auto response_code = (code[0] - '0') * 100 + (code[1] - '0') * 10 + (code[2] - '0');
+                packet.set_response_data(static_cast<ResponseCode>(response_code), std::string{ line.substr(5, 3) });
+            }
+            else
+            {
+                error = true;
+                Log::error("HTTPProtocol", "Invalid response code: {}", std::string{ code });
+            }
+        }
+        else
         {
-            if (!s.empty())
+            // GET / HTTP/1.1
+            auto method_end = line.find(' ');
+            auto version_start = line.rfind(' ');
+
+            if (method_end != std::string_view::npos
+                && version_start > method_end + 1
+                && line.size() - version_start == 9
+                && line.compare(version_start + 1, 5, "HTTP/") == 0
+                && std::isdigit(static_cast<unsigned char>(line[version_start + 6]))
+                && line[version_start + 7] == '.'
+                && std::isdigit(static_cast<unsigned char>(line[version_start + 8])))
             {
-                auto colon = std::find(s.begin(), s.end(), ':');
+                // Store method for use in continued packets.
+                last_method.assign(line.data(), method_end);
+                last_url.assign(line.data() + method_end + 1, version_start - method_end - 1);
+                last_request_version.assign(line.data() + version_start + 6, 3);
+                packet.set_request_data(last_method, last_url, last_request_version);
+            }
+        }
+    }
 
-                if (colon == s.end() && !s.empty())
+    void RegularHTTPProtocol::buffer_surplus(HTTPPacket& packet)
+    {
+        // While reading headers, as much as fits is read so any requests following the current one
+        // (i.e. pipelined requests) may have been received as well. Set those bytes aside, ahead
+        // of anything already set aside, for the following packets.
+        if (!error && total_content_bytes_received > incoming_content_length)
+        {
+            auto surplus = total_content_bytes_received - incoming_content_length;
+            auto& data = packet.data();
+            auto surplus_start = data.begin() + incoming_content_length;
+
+            buffered.insert(buffered.begin(), surplus_start, surplus_start + surplus);
+            data.erase(surplus_start, surplus_start + surplus);
+
+            total_bytes_received -= surplus;
+            total_content_bytes_received -= surplus;
+            content_bytes_received_in_current_part -= surplus;
+        }
+    }
+
+    bool RegularHTTPProtocol::is_without_content(ResponseCode code)
+    {
+        // Informational, 204 and 304 responses end with the headers, https://tools.ietf.org/html/rfc7230#section-3.3.3
+        const auto value = static_cast<int>(code);
+
+        return (value >= 100 && value < 200)
+               || code == ResponseCode::No_Content
+               || code == ResponseCode::Not_Modified;
+    }
+
+    bool RegularHTTPProtocol::detect_transfer_coding(HTTPPacket& packet)
+    {
+        auto res = true;
+        const auto transfer_encoding = packet.headers().get(TRANSFER_ENCODING);
+
+        if (!transfer_encoding.empty())
+        {
+            // Chunked must be the final coding, https://tools.ietf.org/html/rfc7230#section-3.3.3.
+            // Content-Length is then ignored. No other codings are supported.
+            auto codings = string_util::split(std::string{ transfer_encoding }, ",", true);
+            chunked = codings.size() == 1 && string_util::iequals(codings.back(), "chunked");
+
+            if (!chunked)
+            {
+                response.reply_error(std::make_unique<responses::ErrorResponse>(ResponseCode::Not_Implemented));
+                Log::error("HTTPProtocol", "Unsupported transfer coding: {}", transfer_encoding);
+                error = true;
+                res = false;
+            }
+        }
+
+        return res;
+    }
+
+    void RegularHTTPProtocol::decode_chunked(HTTPPacket& packet, std::size_t raw_start, std::size_t raw_length)
+    {
+        // The chunk data is moved to the end of the data decoded so far. Since the decoded
+        // data is never longer than the raw data, this can be done in place.
+        auto& data = packet.data();
+        auto in = raw_start;
+        const auto end = raw_start + raw_length;
+        const auto decoded_before = static_cast<std::size_t>(content_bytes_received_in_current_part);
+        auto out = decoded_before;
+        const auto capacity = static_cast<std::size_t>(content_chunk_size);
+
+        while (!error
+               && in < end
+               && chunk_state != ChunkState::done
+               && !(chunk_state == ChunkState::data && out >= capacity))
+        {
+            const auto c = data[in];
+
+            if (chunk_state == ChunkState::data)
+            {
+                auto count = std::min({ chunk_remaining, end - in, capacity - out });
+                std::copy(data.begin() + static_cast<long>(in),
+                          data.begin() + static_cast<long>(in + count),
+                          data.begin() + static_cast<long>(out));
+                in += count;
+                out += count;
+                chunk_remaining -= count;
+
+                if (chunk_remaining == 0)
                 {
-                    std::smatch m;
+                    chunk_state = ChunkState::data_end;
+                }
+            }
+            else
+            {
+                ++in;
 
-                    if (std::regex_match(s, m, request_line))
+                // Line endings are CRLF or, leniently, a bare LF; a CR anywhere else would let other
+                // parsers split the message differently.
+                const auto misplaced_cr = chunk_cr && c != '\n';
+                chunk_cr = c == '\r';
+
+                if (misplaced_cr)
+                {
+                    error = true;
+                }
+                else if (chunk_cr)
+                {
+                    // Checked along with the next character.
+                }
+                else if (chunk_state == ChunkState::size && std::isxdigit(c))
+                {
+                    // A limit of 8 digits prevents overflow, even with a 32-bit size_t.
+                    auto digit = std::isdigit(c) ? c - '0' : std::tolower(c) - 'a' + 10;
+                    chunk_remaining = (chunk_remaining << 4) | static_cast<std::size_t>(digit);
+                    error = ++chunk_size_digits > 8;
+                }
+                else if ((chunk_state == ChunkState::size
+                          || chunk_state == ChunkState::size_end
+                          || chunk_state == ChunkState::extension) && c == '\n')
+                {
+                    error = chunk_size_digits == 0;
+                    chunk_size_digits = 0;
+                    chunk_state = chunk_remaining == 0 ? ChunkState::trailer : ChunkState::data;
+                }
+                else if (chunk_state == ChunkState::size || chunk_state == ChunkState::size_end)
+                {
+                    // Chunk extensions are ignored. Whitespace may follow the size, but no more digits.
+                    if (c == ';')
                     {
-                        // Store method for use in continued packets.
-                        last_method = m[1].str();
-                        last_url = m[2].str();
-                        last_request_version = m[3].str();
-                        packet.set_request_data(last_method, last_url, last_request_version);
+                        chunk_state = ChunkState::extension;
                     }
-                    else if (std::regex_match(s, m, response_line))
+                    else if ((c == ' ' || c == '\t') && chunk_size_digits > 0)
                     {
-                        // Store response data for later use
-                        try
-                        {
-                            auto response_code = std::stoi(m[2].str());
-                            packet.set_response_data(static_cast<ResponseCode>(response_code));
-                        }
-                        catch (...)
-                        {
-                            error = true;
-
-                            Log::error("HTTPProtocol", "Invalid response code: {}", m[2].str());
-                        }
+                        chunk_state = ChunkState::size_end;
+                    }
+                    else
+                    {
+                        error = true;
                     }
                 }
-                else
+                else if (chunk_state == ChunkState::data_end)
                 {
-                    if (std::distance(colon, s.end()) > 2)
+                    if (c == '\n')
                     {
-                        // Headers are case-insensitive: https://tools.ietf.org/html/rfc7230#section-3.2
-                        // Headers may be split on several lines, so append data if header isn't empty.
-                        auto& curr_header = packet.headers()[string_util::to_lower_copy({ s.begin(), colon })];
-
-                        if (curr_header.empty())
-                        {
-                            curr_header = { colon + 2, s.end() };
-                        }
-                        else
-                        {
-                            curr_header.append(", ").append({ colon + 2, s.end() });
-                        }
+                        chunk_state = ChunkState::size;
+                    }
+                    else
+                    {
+                        error = true;
+                    }
+                }
+                else if (chunk_state == ChunkState::trailer)
+                {
+                    // Trailer fields are skipped, an empty line ends the message.
+                    if (c == '\n')
+                    {
+                        chunk_state = trailer_line_length == 0 ? ChunkState::done : ChunkState::trailer;
+                        trailer_line_length = 0;
+                    }
+                    else
+                    {
+                        ++trailer_line_length;
                     }
                 }
             }
         }
 
-        return actual_header_bytes_received;
+        if (error)
+        {
+            Log::error("HTTPProtocol", "Invalid chunked content.");
+        }
+        else if (in < end)
+        {
+            // The start of a pipelined request, or chunk data that didn't fit in the current part.
+            buffered.insert(buffered.begin(),
+                            data.begin() + static_cast<long>(in),
+                            data.begin() + static_cast<long>(end));
+        }
+
+        content_bytes_received_in_current_part = static_cast<int>(out);
+        total_content_bytes_received += static_cast<int>(out - decoded_before);
+    }
+
+    bool RegularHTTPProtocol::is_request_complete() const
+    {
+        return !until_close
+               && (chunked ? chunk_state == ChunkState::done
+                   : total_content_bytes_received >= incoming_content_length);
+    }
+
+    int RegularHTTPProtocol::take_buffered(uint8_t* target, int length)
+    {
+        auto count = std::min(static_cast<std::size_t>(std::max(length, 0)), buffered.size());
+        auto end = buffered.begin() + static_cast<long>(count);
+
+        std::copy(buffered.begin(), end, target);
+        buffered.erase(buffered.begin(), end);
+
+        return static_cast<int>(count);
     }
 
     void RegularHTTPProtocol::packet_consumed()
     {
         content_bytes_received_in_current_part = 0;
 
-        if (error || total_content_bytes_received >= incoming_content_length)
+        if (error || is_request_complete())
         {
             // All chunks of the current request has been received.
+            chunked = false;
+            until_close = false;
+            chunk_state = ChunkState::size;
+            chunk_remaining = 0;
+            chunk_size_digits = 0;
+            chunk_cr = false;
+            trailer_line_length = 0;
             total_bytes_received = 0;
             incoming_content_length = 0;
             total_content_bytes_received = 0;
             actual_header_size = 0;
             state = State::reading_headers;
+            header_parser.reset();
+        }
+
+        if (error)
+        {
+            // Framing is lost, whatever follows can't be trusted.
+            buffered.clear();
         }
 
         error = false;
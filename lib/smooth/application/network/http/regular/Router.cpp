@@ -0,0 +1,224 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/network/http/regular/Router.h"
+#include <algorithm>
+
+namespace smooth::application::network::http::regular
+{
+    bool Router::add(HTTPMethod method, const std::string& route, RouteHandlerSignature handler)
+    {
+        auto res = true;
+        Node* node = &root;
+        std::vector<std::string> names{};
+        std::string_view pattern{ route };
+        std::size_t pos = 0;
+
+        while (res && pos < pattern.size())
+        {
+            // Find the start of the next :param or *wildcard segment.
+            auto token = pos;
+
+            while (token < pattern.size()
+                   && !((pattern[token] == ':' || pattern[token] == '*')
+                        && (token == 0 || pattern[token - 1] == '/')))
+            {
+                ++token;
+            }
+
+            node = insert_static(*node, pattern.substr(pos, token - pos));
+            pos = token;
+
+            if (pos < pattern.size())
+            {
+                auto is_wildcard = pattern[pos] == '*';
+                auto end = is_wildcard ? pattern.size() : std::min(pattern.find('/', pos), pattern.size());
+                auto name = pattern.substr(pos + 1, end - pos - 1);
+
+                res = !name.empty()
+                      && names.size() < RouteParameters::MaxCount
+                      && (is_wildcard || name.find_first_of(":*") == std::string_view::npos);
+
+                if (res)
+                {
+                    auto& child = is_wildcard ? node->wildcard : node->parameter;
+
+                    if (!child)
+                    {
+                        child = std::make_unique<Node>();
+                    }
+
+                    names.emplace_back(name);
+                    node = child.get();
+                    pos = end;
+                }
+            }
+        }
+
+        if (res)
+        {
+            auto& r = node->routes[static_cast<std::size_t>(method)];
+            r.handler = std::move(handler);
+            r.parameter_names = std::move(names);
+
+            auto existing = std::find(routes.begin(), routes.end(), route);
+            r.id = static_cast<std::size_t>(std::distance(routes.begin(), existing));
+
+            if (existing == routes.end())
+            {
+                routes.emplace_back(route);
+            }
+        }
+
+        return res;
+    }
+
+    const RouteHandlerSignature* Router::find(HTTPMethod method,
+                                              std::string_view url,
+                                              RouteParameters& parameters,
+                                              std::size_t& route) const
+    {
+        const RouteHandlerSignature* res = nullptr;
+        const Route* found = nullptr;
+
+        parameters.names = nullptr;
+        parameters.count = 0;
+
+        if (match(root, url, static_cast<std::size_t>(method), parameters, found))
+        {
+            parameters.names = &found->parameter_names;
+            res = &found->handler;
+            route = found->id;
+        }
+
+        return res;
+    }
+
+    const std::string& Router::get_route(std::size_t route) const
+    {
+        static const std::string none{};
+
+        return route < routes.size() ? routes[route] : none;
+    }
+
+    Router::Node* Router::insert_static(Node& node, std::string_view text)
+    {
+        Node* res = &node;
+
+        if (!text.empty())
+        {
+            auto child = std::find_if(node.children.begin(), node.children.end(),
+                                      [&text](const auto& c) { return c->prefix[0] == text[0]; });
+
+            if (child == node.children.end())
+            {
+                auto n = std::make_unique<Node>();
+                n->prefix = text;
+                res = n.get();
+                node.children.emplace_back(std::move(n));
+            }
+            else
+            {
+                auto& existing = *child;
+                auto common = static_cast<std::size_t>(std::distance(
+                        text.begin(),
+                        std::mismatch(text.begin(), text.end(),
+                                      existing->prefix.begin(), existing->prefix.end()).first));
+
+                if (common < existing->prefix.size())
+                {
+                    // Split the existing node at the end of the common prefix.
+                    auto split = std::make_unique<Node>();
+                    split->prefix = existing->prefix.substr(0, common);
+                    existing->prefix.erase(0, common);
+                    split->children.emplace_back(std::move(existing));
+                    existing = std::move(split);
+                }
+
+                res = insert_static(*existing, text.substr(common));
+            }
+        }
+
+        return res;
+    }
+
+    bool Router::match(const Node& node,
+                       std::string_view remaining,
+                       std::size_t method,
+                       RouteParameters& parameters,
+                       const Route*& found)
+    {
+        // Try static text first, then :param and finally *wildcard. Backtracking only happens
+        // when a more specific branch turns out to be a dead end.
+        auto res = remaining.empty() && match_leaf(node, method, found);
+
+        if (!res && !remaining.empty())
+        {
+            for (const auto& child : node.children)
+            {
+                if (child->prefix[0] == remaining[0])
+                {
+                    const auto& prefix = child->prefix;
+
+                    if (remaining.compare(0, prefix.size(), prefix) == 0)
+                    {
+                        res = match(*child, remaining.substr(prefix.size()), method, parameters, found);
+                    }
+
+                    break;
+                }
+            }
+        }
+
+        if (!res && node.parameter && !remaining.empty() && remaining[0] != '/'
+            && parameters.count < RouteParameters::MaxCount)
+        {
+            auto end = std::min(remaining.find('/'), remaining.size());
+            parameters.values[parameters.count++] = remaining.substr(0, end);
+            res = match(*node.parameter, remaining.substr(end), method, parameters, found);
+
+            if (!res)
+            {
+                --parameters.count;
+            }
+        }
+
+        if (!res && node.wildcard && parameters.count < RouteParameters::MaxCount)
+        {
+            res = match_leaf(*node.wildcard, method, found);
+
+            if (res)
+            {
+                parameters.values[parameters.count++] = remaining;
+            }
+        }
+
+        return res;
+    }
+
+    bool Router::match_leaf(const Node& node, std::size_t method, const Route*& found)
+    {
+        auto res = static_cast<bool>(node.routes[method].handler);
+
+        if (res)
+        {
+            found = &node.routes[method];
+        }
+
+        return res;
+    }
+}
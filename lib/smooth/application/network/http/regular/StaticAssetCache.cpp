@@ -0,0 +1,309 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/network/http/regular/StaticAssetCache.h"
+#include <cstdlib>
+#include "smooth/application/hash/sha.h"
+#include "smooth/application/network/http/http_utils.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+#include "smooth/application/network/http/regular/responses/CachedAssetResponse.h"
+#include "smooth/application/network/http/regular/responses/HeaderOnlyResponse.h"
+#include "smooth/core/filesystem/File.h"
+#include "smooth/core/logging/log.h"
+#include "smooth/core/util/string_util.h"
+
+using namespace smooth::core::filesystem;
+using namespace smooth::core::logging;
+using namespace smooth::core;
+
+namespace smooth::application::network::http::regular
+{
+    static const char* tag = "StaticAssetCache";
+
+    StaticAssetCache::StaticAssetCache(std::size_t max_size)
+            : max_size(max_size)
+    {
+    }
+
+    std::unique_ptr<IResponseOperation>
+    StaticAssetCache::get_response(const FileInfo& info,
+                                   const HeaderFields& request_headers,
+                                   bool with_content)
+    {
+        std::unique_ptr<IResponseOperation> res{};
+
+        const auto* asset = is_enabled() ? find(info, with_content) : nullptr;
+
+        if (asset)
+        {
+            auto encoding = select_encoding(*asset, request_headers);
+            const auto& variant = asset->variants[encoding];
+
+            // If-None-Match takes precedence over If-Modified-Since, https://tools.ietf.org/html/rfc7232#section-6
+            auto not_modified = false;
+            auto if_none_match = request_headers.get(IF_NONE_MATCH);
+
+            if (!if_none_match.empty())
+            {
+                not_modified = matches(std::string{ if_none_match }, variant.etag);
+            }
+            else
+            {
+                auto if_modified_since = request_headers.get(IF_MODIFIED_SINCE);
+
+                if (!if_modified_since.empty())
+                {
+                    auto since = utils::parse_http_time(std::string{ if_modified_since });
+                    not_modified = since >= std::chrono::system_clock::from_time_t(asset->modified);
+                }
+            }
+
+            if (not_modified)
+            {
+                res = std::make_unique<responses::HeaderOnlyResponse>(ResponseCode::Not_Modified);
+            }
+            else
+            {
+                if (with_content)
+                {
+                    res = std::make_unique<responses::CachedAssetResponse>(variant.content);
+                }
+                else
+                {
+                    res = std::make_unique<responses::HeaderOnlyResponse>(ResponseCode::OK);
+                    res->set_header(CONTENT_LENGTH, std::to_string(variant.content->size()));
+                }
+
+                res->set_header(CONTENT_TYPE, asset->content_type);
+
+                if (encoding == Gzip)
+                {
+                    res->set_header(CONTENT_ENCODING, "gzip");
+                }
+                else if (encoding == Brotli)
+                {
+                    res->set_header(CONTENT_ENCODING, "br");
+                }
+            }
+
+            res->set_header(ETAG, variant.etag);
+            res->set_header(LAST_MODIFIED, asset->last_modified);
+
+            if (asset->variants[Gzip].content || asset->variants[Brotli].content)
+            {
+                res->set_header(VARY, ACCEPT_ENCODING);
+            }
+        }
+
+        return res;
+    }
+
+    void StaticAssetCache::clear()
+    {
+        by_path.clear();
+        assets.clear();
+        cached_size = 0;
+    }
+
+    const StaticAssetCache::Asset* StaticAssetCache::find(const FileInfo& info, bool load_missing)
+    {
+        const Asset* res = nullptr;
+
+        auto key = info.path().str();
+        auto existing = by_path.find(key);
+
+        if (existing != by_path.end())
+        {
+            auto pos = (*existing).second;
+
+            if (pos->modified == info.last_modified() && pos->file_size == info.size())
+            {
+                // Move to the front of the LRU-list.
+                assets.splice(assets.begin(), assets, pos);
+                res = &*pos;
+            }
+            else
+            {
+                // Changed on disk, reload below.
+                remove(pos);
+            }
+        }
+
+        if (!res && load_missing)
+        {
+            Asset asset{};
+            asset.path = key;
+
+            if (load(info, asset))
+            {
+                auto usage = asset.memory_usage();
+
+                if (usage <= max_size)
+                {
+                    while (!assets.empty() && cached_size + usage > max_size)
+                    {
+                        remove(std::prev(assets.end()));
+                    }
+
+                    assets.emplace_front(std::move(asset));
+                    by_path[key] = assets.begin();
+                    cached_size += usage;
+                    res = &assets.front();
+                }
+            }
+        }
+
+        return res;
+    }
+
+    bool StaticAssetCache::load(const FileInfo& info, Asset& asset) const
+    {
+        auto res = info.size() <= max_size;
+
+        if (res)
+        {
+            std::vector<uint8_t> data{};
+            File f{ info.path() };
+
+            // The size must match the stat:ed one since that is what the entry is validated against.
+            res = f.read(data) && data.size() == info.size();
+
+            if (res)
+            {
+                auto hash = hash::sha1(data.data(), data.size());
+                std::string etag = "\"";
+                const char* hex = "0123456789abcdef";
+
+                // Half of the SHA-1 is plenty to tell versions of the same file apart.
+                for (std::size_t i = 0; i < 8; ++i)
+                {
+                    etag += hex[hash[i] >> 4];
+                    etag += hex[hash[i] & 0x0F];
+                }
+
+                asset.modified = info.last_modified();
+                asset.file_size = info.size();
+                asset.content_type = utils::get_content_type(info.path());
+                asset.last_modified = utils::make_http_time(info.last_modified());
+
+                auto& identity = asset.variants[Identity];
+                identity.content = std::make_shared<const std::vector<uint8_t>>(std::move(data));
+                identity.etag = etag + "\"";
+
+                // Each representation needs its own strong ETag.
+                if (load_sibling(info, ".gz", asset.variants[Gzip]))
+                {
+                    asset.variants[Gzip].etag = etag + "-gz\"";
+                }
+
+                if (load_sibling(info, ".br", asset.variants[Brotli]))
+                {
+                    asset.variants[Brotli].etag = etag + "-br\"";
+                }
+            }
+            else
+            {
+                Log::warning(tag, "Could not read {}", info.path().str());
+            }
+        }
+
+        return res;
+    }
+
+    bool StaticAssetCache::load_sibling(const FileInfo& info, const char* extension, Variant& variant)
+    {
+        auto name = info.path().str() + extension;
+        FileInfo sibling{ Path{ name.c_str() } };
+
+        // A sibling older than the file itself is stale and one that isn't smaller is useless.
+        auto res = sibling.is_regular_file()
+                   && sibling.last_modified() >= info.last_modified()
+                   && sibling.size() < info.size();
+
+        if (res)
+        {
+            std::vector<uint8_t> data{};
+            File f{ name };
+            res = f.read(data) && data.size() == sibling.size();
+
+            if (res)
+            {
+                variant.content = std::make_shared<const std::vector<uint8_t>>(std::move(data));
+            }
+        }
+
+        return res;
+    }
+
+    void StaticAssetCache::remove(AssetList::iterator pos)
+    {
+        cached_size -= pos->memory_usage();
+        by_path.erase(pos->path);
+        assets.erase(pos);
+    }
+
+    StaticAssetCache::Encoding
+    StaticAssetCache::select_encoding(const Asset& asset,
+                                      const HeaderFields& request_headers)
+    {
+        auto res = Identity;
+        const std::string accept_encoding{ request_headers.get(ACCEPT_ENCODING) };
+
+        if (!accept_encoding.empty())
+        {
+            // Brotli compresses text assets better than gzip, so prefer it.
+            if (asset.variants[Brotli].content && utils::is_encoding_acceptable(accept_encoding, "br"))
+            {
+                res = Brotli;
+            }
+            else if (asset.variants[Gzip].content && utils::is_encoding_acceptable(accept_encoding, "gzip"))
+            {
+                res = Gzip;
+            }
+        }
+
+        return res;
+    }
+
+    bool StaticAssetCache::matches(const std::string& if_none_match, const std::string& etag)
+    {
+        // If-None-Match uses the weak comparison, https://tools.ietf.org/html/rfc7232#section-3.2
+        auto res = string_util::trim(if_none_match) == "*";
+
+        for (const auto& candidate : string_util::split(if_none_match, ",", true))
+        {
+            const auto weak_prefix = std::string{ "W/" };
+            auto tag_start = candidate.compare(0, weak_prefix.size(), weak_prefix) == 0 ? weak_prefix.size() : 0;
+
+            res = res || candidate.compare(tag_start, std::string::npos, etag) == 0;
+        }
+
+        return res;
+    }
+
+    std::size_t StaticAssetCache::Asset::memory_usage() const
+    {
+        std::size_t res = sizeof(Asset) + path.size() + content_type.size() + last_modified.size();
+
+        for (const auto& v : variants)
+        {
+            res += v.content ? v.content->size() : 0;
+        }
+
+        return res;
+    }
+}
@@ -16,15 +16,15 @@ limitations under the License.
 */
 
 #include "smooth/application/network/http/regular/TemplateProcessor.h"
-#include <regex>
-#include "smooth/application/network/http/regular/responses/StringResponse.h"
+#include <algorithm>
+#include <cctype>
+#include "smooth/application/network/http/regular/responses/TemplateResponse.h"
 #include "smooth/application/network/http/regular/responses/ErrorResponse.h"
 #include "smooth/application/network/http/regular/ResponseCodes.h"
 #include "smooth/core/filesystem/File.h"
-#include "smooth/core/util/string_util.h"
+#include "smooth/core/filesystem/Fileinfo.h"
 
 using namespace smooth::core::filesystem;
-using namespace smooth::core::string_util;
 
 namespace smooth::application::network::http::regular
 {
@@ -35,58 +35,136 @@ namespace smooth::application::network::http::regular
     {
     }
 
+    bool TemplateProcessor::is_template(const smooth::core::filesystem::Path& path) const
+    {
+        return template_files.find(path.extension()) != template_files.end();
+    }
+
     std::unique_ptr<IResponseOperation> TemplateProcessor::process_template(const smooth::core::filesystem::Path& path)
     {
         std::unique_ptr<IResponseOperation> res{};
 
-        const auto& ext = path.extension();
-        bool is_template_file = template_files.find(ext) != template_files.end();
+        if (is_template(path))
+        {
+            auto t = get_compiled(path);
+
+            if (!t)
+            {
+                res = std::make_unique<responses::ErrorResponse>(ResponseCode::Internal_Server_Error);
+            }
+            else
+            {
+                std::vector<std::string> values{};
+
+                if (data_retriever)
+                {
+                    // Tokens without corresponding data are replaced with an empty string.
+                    data_retriever->get_all(t->tokens, values);
+                    values.resize(t->tokens.size());
+                }
+                else
+                {
+                    values = t->tokens;
+                }
+
+                res = std::make_unique<responses::TemplateResponse>(std::move(t), std::move(values));
+            }
+        }
+
+        return res;
+    }
+
+    std::shared_ptr<const CompiledTemplate> TemplateProcessor::get_compiled(const Path& path)
+    {
+        std::shared_ptr<const CompiledTemplate> res{};
+
+        FileInfo info{ path };
+        auto existing = compiled.find(path.str());
 
-        if (is_template_file)
+        if (existing != compiled.end()
+            && (*existing).second->modified == info.last_modified()
+            && (*existing).second->file_size == info.size())
+        {
+            res = (*existing).second;
+        }
+        else
         {
-            std::string data;
+            auto t = std::make_shared<CompiledTemplate>();
             File src{ path };
 
-            if (!src.read(data) || data.empty())
+            if (info.is_regular_file() && src.read(t->text) && !t->text.empty())
             {
-                res = std::make_unique<responses::ErrorResponse>(ResponseCode::Internal_Server_Error);
+                t->modified = info.last_modified();
+                t->file_size = info.size();
+                compile(*t);
+
+                compiled[path.str()] = t;
+                res = std::move(t);
             }
             else
             {
-                process_template(data);
-                res = std::make_unique<responses::StringResponse>(ResponseCode::OK, data, false);
+                compiled.erase(path.str());
             }
         }
 
         return res;
     }
 
-    void TemplateProcessor::process_template(std::string& template_data) const
+    void TemplateProcessor::compile(CompiledTemplate& t)
     {
-        // Find keys in the form "{{alpha_num}}, then do a lookup on the alpha_num part
-        // and replace the entire found token. Continue search after the found token until end of data.
+        // Find keys in the form "{{alpha_num}}" and split the text into literal parts and tokens.
+        // Repeated tokens share the same index so that each is only looked up once per rendering.
+        const auto& text = t.text;
+        std::size_t literal_start = 0;
+        auto pos = text.find("{{");
 
-        if (data_retriever)
+        while (pos != std::string::npos)
         {
-            try
+            auto name_end = pos + 2;
+
+            while (name_end < text.size() && is_token_char(text[name_end]))
             {
-                // Find all tokens
-                std::smatch match{};
+                ++name_end;
+            }
 
-                while (std::regex_search(template_data, match, token))
+            if (name_end > pos + 2 && text.compare(name_end, 2, "}}") == 0)
+            {
+                const auto token_end = name_end + 2;
+
+                if (pos > literal_start)
                 {
-                    std::stringstream ss;
-                    const auto& found_token = match[0].str();
+                    t.segments.push_back({ literal_start, pos - literal_start, CompiledTemplate::Literal });
+                }
 
-                    // Replaces any matched token, even if no corresponding data exists, in which case empty string is
-                    // used.
-                    replace_all(template_data, found_token, data_retriever->get(found_token));
+                auto token = text.substr(pos, token_end - pos);
+                auto index = static_cast<std::size_t>(std::distance(t.tokens.begin(),
+                                                                    std::find(t.tokens.begin(), t.tokens.end(),
+                                                                              token)));
+
+                if (index == t.tokens.size())
+                {
+                    t.tokens.push_back(std::move(token));
                 }
+
+                t.segments.push_back({ pos, token_end - pos, index });
+
+                literal_start = token_end;
+                pos = text.find("{{", token_end);
             }
-            catch (std::regex_error& ex)
+            else
             {
-                Log::error("TemplateProcessor", ex.what());
+                pos = text.find("{{", pos + 1);
             }
         }
+
+        if (literal_start < text.size())
+        {
+            t.segments.push_back({ literal_start, text.size() - literal_start, CompiledTemplate::Literal });
+        }
+    }
+
+    bool TemplateProcessor::is_token_char(char c)
+    {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-';
     }
 }
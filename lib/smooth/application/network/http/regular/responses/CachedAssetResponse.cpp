@@ -0,0 +1,55 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/network/http/regular/responses/CachedAssetResponse.h"
+#include <algorithm>
+#include "smooth/core/logging/log.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+
+using namespace smooth::core::logging;
+
+namespace smooth::application::network::http::regular::responses
+{
+    CachedAssetResponse::CachedAssetResponse(std::shared_ptr<const std::vector<uint8_t>> content)
+            : HeaderOnlyResponse(ResponseCode::OK),
+              content(std::move(content))
+    {
+        headers[CONTENT_LENGTH] = std::to_string(this->content->size());
+    }
+
+    ResponseStatus CachedAssetResponse::get_data(std::size_t max_amount, std::vector<uint8_t>& target)
+    {
+        auto res = ResponseStatus::NoData;
+
+        if (sent < content->size())
+        {
+            auto to_send = std::min(content->size() - sent, max_amount);
+            auto begin = content->begin() + static_cast<long>(sent);
+            target.insert(target.end(), begin, begin + static_cast<long>(to_send));
+            sent += to_send;
+
+            res = sent < content->size() ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
+        }
+
+        return res;
+    }
+
+    void CachedAssetResponse::dump() const
+    {
+        Log::debug("CachedAssetResponse", "Code: {}; Status: {}/{} bytes", code, sent, content->size());
+    }
+}
@@ -0,0 +1,122 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/network/http/regular/responses/ChunkedResponse.h"
+#include <algorithm>
+#include <array>
+#include "smooth/core/logging/log.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+
+using namespace smooth::core::logging;
+
+namespace smooth::application::network::http::regular::responses
+{
+    // Size of the chunk size line (up to 8 hex digits and CRLF) plus the CRLF ending the chunk data.
+    static constexpr std::size_t chunk_overhead = 8 + 2 + 2;
+
+    // The last chunk, followed by an empty trailer.
+    static constexpr std::array<uint8_t, 5> last_chunk{ '0', '\r', '\n', '\r', '\n' };
+
+    ChunkedResponse::ChunkedResponse(ResponseCode code, const std::string& content_type, Generator generator)
+            : HeaderOnlyResponse(code),
+              generator(std::move(generator))
+    {
+        headers[TRANSFER_ENCODING] = "chunked";
+        headers[CONTENT_TYPE] = content_type;
+    }
+
+    ResponseStatus ChunkedResponse::get_data(std::size_t max_amount, std::vector<uint8_t>& target)
+    {
+        auto res = ResponseStatus::NoData;
+
+        if (!complete)
+        {
+            auto max_chunk = !chunked ? max_amount
+                             : max_amount > chunk_overhead + last_chunk.size()
+                             ? max_amount - chunk_overhead - last_chunk.size()
+                             : std::size_t{ 1 };
+
+            if (more_to_generate && pending.size() < max_chunk)
+            {
+                more_to_generate = generator(max_chunk - pending.size(), pending);
+            }
+
+            auto chunk_size = std::min(pending.size(), max_chunk);
+
+            if (!chunked)
+            {
+                auto chunk_end = pending.begin() + static_cast<long>(chunk_size);
+                target.insert(target.end(), pending.begin(), chunk_end);
+                pending.erase(pending.begin(), chunk_end);
+                sent += chunk_size;
+            }
+            // A chunk of size zero ends the body, so only send actual data.
+            else if (chunk_size > 0)
+            {
+                append_chunk_size(chunk_size, target);
+                auto chunk_end = pending.begin() + static_cast<long>(chunk_size);
+                target.insert(target.end(), pending.begin(), chunk_end);
+                target.emplace_back('\r');
+                target.emplace_back('\n');
+                pending.erase(pending.begin(), chunk_end);
+                sent += chunk_size;
+            }
+
+            complete = !more_to_generate && pending.empty();
+
+            if (complete && chunked)
+            {
+                target.insert(target.end(), last_chunk.begin(), last_chunk.end());
+            }
+
+            res = complete ? ResponseStatus::LastData : ResponseStatus::HasMoreData;
+        }
+
+        return res;
+    }
+
+    bool ChunkedResponse::disable_chunked_coding()
+    {
+        chunked = false;
+        headers.erase(TRANSFER_ENCODING);
+
+        return true;
+    }
+
+    void ChunkedResponse::append_chunk_size(std::size_t size, std::vector<uint8_t>& target)
+    {
+        const char* hex = "0123456789abcdef";
+        std::array<uint8_t, 8> digits{};
+        std::size_t count = 0;
+
+        do
+        {
+            digits[count++] = static_cast<uint8_t>(hex[size & 0x0F]);
+            size >>= 4;
+        }
+        while (size > 0 && count < digits.size());
+
+        std::reverse_copy(digits.begin(), digits.begin() + static_cast<long>(count), std::back_inserter(target));
+        target.emplace_back('\r');
+        target.emplace_back('\n');
+    }
+
+    void ChunkedResponse::dump() const
+    {
+        Log::debug("ChunkedResponse", "Code: {}; Sent: {} bytes; Complete: {}", code, sent, complete);
+    }
+}
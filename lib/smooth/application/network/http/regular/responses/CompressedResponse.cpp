@@ -0,0 +1,240 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "smooth/application/network/http/regular/responses/CompressedResponse.h"
+
+#ifdef CONFIG_SMOOTH_HTTP_COMPRESSION
+
+#include <algorithm>
+#include <cstdlib>
+#include "smooth/core/logging/log.h"
+#include "smooth/core/util/string_util.h"
+#include "smooth/application/network/http/http_utils.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+
+using namespace smooth::core;
+using namespace smooth::core::logging;
+
+namespace smooth::application::network::http::regular::responses
+{
+    static std::string get_header(const std::unordered_map<std::string, std::string>& headers, const char* name)
+    {
+        auto it = headers.find(name);
+
+        return it == headers.end() ? std::string{} : it->second;
+    }
+
+    CompressedResponse::CompressedResponse(std::unique_ptr<IResponseOperation> wrapped,
+                                           Coding coding,
+                                           const CompressionOptions& options)
+            : ChunkedResponse(wrapped->get_response_code(),
+                              get_header(wrapped->get_headers(), CONTENT_TYPE),
+                              [this](std::size_t max_amount, std::vector<uint8_t>& target) {
+                                  return generate(max_amount, target);
+                              }),
+              response(std::move(wrapped)),
+              coding(coding),
+              level(std::clamp(options.level, 1, 9)),
+              window_bits(std::clamp(options.window_bits, 9, 15)),
+              mem_level(std::clamp(options.mem_level, 1, 9))
+    {
+        for (const auto& header : response->get_headers())
+        {
+            // The length of the compressed content is not known up front.
+            if (header.first != CONTENT_LENGTH && header.first != TRANSFER_ENCODING)
+            {
+                headers[header.first] = header.second;
+            }
+        }
+
+        headers[CONTENT_ENCODING] = coding == Coding::Gzip ? "gzip" : "deflate";
+
+        // The compressed content is not byte for byte the same as what a strong ETag identifies.
+        auto etag = headers.find(ETAG);
+
+        if (etag != headers.end() && etag->second.compare(0, 2, "W/") != 0)
+        {
+            etag->second.insert(0, "W/");
+        }
+    }
+
+    void CompressedResponse::initialize()
+    {
+        // Not done up front, as the compressor allocates its memory here and the response may never
+        // be sent compressed, see disable_chunked_coding().
+        // zlib writes a gzip header and trailer instead of the zlib ones when 16 is added to the window bits.
+        initialized = deflateInit2(&stream,
+                                   level,
+                                   Z_DEFLATED,
+                                   coding == Coding::Gzip ? window_bits + 16 : window_bits,
+                                   mem_level,
+                                   Z_DEFAULT_STRATEGY) == Z_OK;
+
+        if (!initialized)
+        {
+            Log::error("CompressedResponse", "Could not initialize compression");
+            failed = true;
+        }
+    }
+
+    CompressedResponse::~CompressedResponse()
+    {
+        if (initialized)
+        {
+            deflateEnd(&stream);
+        }
+    }
+
+    std::unique_ptr<IResponseOperation>
+    CompressedResponse::compress(std::unique_ptr<IResponseOperation> response,
+                                 const HeaderFields& request_headers,
+                                 const CompressionOptions& options)
+    {
+        auto res = std::move(response);
+
+        if (res && is_eligible(res->get_headers(), res->get_response_code(), options))
+        {
+            // The content depends on the request's Accept-Encoding,
+            // https://tools.ietf.org/html/rfc7231#section-7.1.4
+            res->add_header(VARY, ACCEPT_ENCODING);
+
+            const std::string accept_encoding{ request_headers.get(ACCEPT_ENCODING) };
+
+            if (utils::is_encoding_acceptable(accept_encoding, "gzip"))
+            {
+                res = std::make_unique<CompressedResponse>(std::move(res), Coding::Gzip, options);
+            }
+            else if (utils::is_encoding_acceptable(accept_encoding, "deflate"))
+            {
+                res = std::make_unique<CompressedResponse>(std::move(res), Coding::Deflate, options);
+            }
+        }
+
+        return res;
+    }
+
+    ResponseStatus CompressedResponse::get_data(std::size_t max_amount, std::vector<uint8_t>& target)
+    {
+        auto res = ResponseStatus::Error;
+
+        if (pass_through)
+        {
+            res = response->get_data(max_amount, target);
+        }
+        else
+        {
+            res = ChunkedResponse::get_data(max_amount, target);
+
+            // Closing the connection is the only way to tell the client that the content is incomplete.
+            if (failed)
+            {
+                res = ResponseStatus::Error;
+            }
+        }
+
+        return res;
+    }
+
+    bool CompressedResponse::get_file_region(smooth::core::network::FileRegion& region)
+    {
+        return pass_through && response->get_file_region(region);
+    }
+
+    bool CompressedResponse::disable_chunked_coding()
+    {
+        // Without chunked transfer coding the end of the compressed content could only be marked by closing
+        // the connection, so send the content uncompressed, with the headers of the wrapped response.
+        pass_through = true;
+        headers = response->get_headers();
+
+        return response->disable_chunked_coding();
+    }
+
+    bool CompressedResponse::generate(std::size_t max_amount, std::vector<uint8_t>& target)
+    {
+        auto finished = false;
+        const auto start = target.size();
+
+        if (!initialized && !failed)
+        {
+            initialize();
+        }
+
+        target.resize(start + max_amount);
+        stream.next_out = target.data() + start;
+        stream.avail_out = static_cast<uInt>(max_amount);
+
+        while (!failed && !finished && stream.avail_out > 0)
+        {
+            if (consumed == input.size() && !input_complete)
+            {
+                // Read no more from the wrapped response than what fits in a chunk.
+                input.clear();
+                consumed = 0;
+
+                auto status = response->get_data(max_amount, input);
+                failed = status == ResponseStatus::Error;
+                input_complete = status == ResponseStatus::LastData || status == ResponseStatus::NoData;
+            }
+
+            if (!failed)
+            {
+                stream.next_in = input.data() + consumed;
+                stream.avail_in = static_cast<uInt>(input.size() - consumed);
+
+                auto rc = deflate(&stream, input_complete ? Z_FINISH : Z_NO_FLUSH);
+
+                consumed = input.size() - stream.avail_in;
+                finished = rc == Z_STREAM_END;
+                failed = rc == Z_STREAM_ERROR;
+            }
+        }
+
+        target.resize(start + max_amount - stream.avail_out);
+
+        return !finished && !failed;
+    }
+
+    bool CompressedResponse::is_eligible(const std::unordered_map<std::string, std::string>& response_headers,
+                                         ResponseCode code,
+                                         const CompressionOptions& options)
+    {
+        const auto value = static_cast<int>(code);
+        const auto content_length = get_header(response_headers, CONTENT_LENGTH);
+
+        // Only the media type is compared, not parameters such as charset.
+        const auto content_type = get_header(response_headers, CONTENT_TYPE);
+        const auto media_type = string_util::to_lower_copy(
+            string_util::trim(content_type.substr(0, content_type.find(';'))));
+
+        return value >= 200
+               && code != ResponseCode::No_Content
+               && code != ResponseCode::Partial_Content
+               && code != ResponseCode::Not_Modified
+               && get_header(response_headers, CONTENT_ENCODING).empty()
+               && get_header(response_headers, TRANSFER_ENCODING).empty()
+               && !content_length.empty()
+               && std::strtoull(content_length.c_str(), nullptr, 10) >= options.min_size
+               && options.content_types.count(media_type) > 0;
+    }
+
+    void CompressedResponse::dump() const
+    {
+        Log::debug("CompressedResponse", "Code: {}; Input complete: {}; Failed: {}", code, input_complete, failed);
+    }
+}
+
+#endif
@@ -15,6 +15,8 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <atomic>
+#include <chrono>
 #include <utility>
 #include <iomanip>
 #include <sstream>
@@ -28,13 +30,73 @@ using namespace smooth::core::filesystem;
 
 namespace smooth::application::network::http::regular::responses
 {
+    static std::string make_boundary()
+    {
+        // Any string not found in the content will do; the counter tells concurrent responses apart.
+        static std::atomic<uint32_t> count{ 0 };
+
+        std::stringstream ss;
+        ss << "smooth_byteranges_" << std::hex
+           << std::chrono::steady_clock::now().time_since_epoch().count() << "_" << count++;
+
+        return ss.str();
+    }
+
     FileContentResponse::FileContentResponse(smooth::core::filesystem::Path full_path)
-            : StringResponse(ResponseCode::OK),
-              path(std::move(full_path)),
-              info(path)
+            : FileContentResponse(FileInfo{ full_path }, {})
+    {
+    }
+
+    FileContentResponse::FileContentResponse(FileInfo file_info, const std::vector<utils::ByteRange>& ranges)
+            : StringResponse(ranges.empty() ? ResponseCode::OK : ResponseCode::Partial_Content),
+              path(file_info.path()),
+              info(std::move(file_info))
     {
-        headers[CONTENT_LENGTH] = std::to_string(info.size());
-        headers[CONTENT_TYPE] = utils::get_content_type(info.path());
+        const auto content_type = utils::get_content_type(info.path());
+        const auto size = std::to_string(info.size());
+        const auto content_range = [&size](const utils::ByteRange& range) {
+                                       return "bytes " + std::to_string(range.first) + "-"
+                                              + std::to_string(range.last) + "/" + size;
+                                   };
+
+        if (ranges.empty())
+        {
+            segments.push_back(Segment{ {}, 0, info.size() });
+            headers[CONTENT_TYPE] = content_type;
+        }
+        else if (ranges.size() == 1)
+        {
+            segments.push_back(Segment{ {}, ranges.front().first, ranges.front().length() });
+            headers[CONTENT_TYPE] = content_type;
+            headers[CONTENT_RANGE] = content_range(ranges.front());
+        }
+        else
+        {
+            // https://tools.ietf.org/html/rfc7233#section-4.1
+            const auto boundary = make_boundary();
+
+            for (const auto& range : ranges)
+            {
+                auto part_header = "\r\n--" + boundary + "\r\nContent-Type: " + content_type
+                                   + "\r\nContent-Range: " + content_range(range) + "\r\n\r\n";
+                const auto length = part_header.size();
+                segments.push_back(Segment{ std::move(part_header), 0, length });
+                segments.push_back(Segment{ {}, range.first, range.length() });
+            }
+
+            auto end = "\r\n--" + boundary + "--\r\n";
+            const auto length = end.size();
+            segments.push_back(Segment{ std::move(end), 0, length });
+            headers[CONTENT_TYPE] = "multipart/byteranges; boundary=" + boundary;
+        }
+
+        for (const auto& segment : segments)
+        {
+            content_length += segment.length;
+        }
+
+        headers[CONTENT_LENGTH] = std::to_string(content_length);
+        headers[ACCEPT_RANGES] = "bytes";
         headers[LAST_MODIFIED] = utils::make_http_time(info.last_modified());
     }
 
@@ -42,21 +104,100 @@ namespace smooth::application::network::http::regular::responses
     ResponseStatus FileContentResponse::get_data(std::size_t max_amount, std::vector<uint8_t>& target)
     {
         auto res = ResponseStatus::NoData;
+        auto read_ok = true;
+        const auto start_size = target.size();
 
-        if (sent < info.size())
+        open_file();
+
+        while (read_ok && current_segment < segments.size() && target.size() - start_size < max_amount)
         {
-            auto to_send = std::min(info.size() - sent, max_amount);
+            const auto& segment = segments[current_segment];
+            auto to_send = std::min(segment.length - sent_of_segment, max_amount - (target.size() - start_size));
+
+            if (segment.text.empty())
+            {
+                read_ok = read_file(segment.offset + sent_of_segment, to_send, target);
+            }
+            else
+            {
+                auto begin = segment.text.begin() + static_cast<long>(sent_of_segment);
+                target.insert(target.end(), begin, begin + static_cast<long>(to_send));
+            }
 
-            auto read_res = smooth::core::filesystem::File::read(path, target, sent, to_send);
+            sent += to_send;
+            sent_of_segment += to_send;
 
-            if (read_res)
+            if (sent_of_segment == segment.length)
+            {
+                ++current_segment;
+                sent_of_segment = 0;
+            }
+        }
+
+        if (!read_ok)
+        {
+            res = ResponseStatus::Error;
+        }
+        else if (target.size() > start_size)
+        {
+            res = sent < content_length ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
+        }
+
+        return res;
+    }
+
+    bool FileContentResponse::get_file_region(smooth::core::network::FileRegion& region)
+    {
+        open_file();
+
+        // Only a body consisting of a single part of the file can be handed over. The file may have
+        // changed since it was inspected, stick to the announced length.
+        bool res = file
+                   && sent == 0
+                   && segments.size() == 1
+                   && segments.front().length > 0
+                   && file->size() >= segments.front().offset + segments.front().length;
+
+        if (res)
+        {
+            region.file = file;
+            region.offset = segments.front().offset;
+            region.length = segments.front().length;
+            sent = content_length;
+            current_segment = segments.size();
+        }
+
+        return res;
+    }
+
+    void FileContentResponse::open_file()
+    {
+        // Not opened up front, as the response may be queued behind others for some time, or only
+        // be built for its headers.
+        if (!open_attempted && current_segment < segments.size())
+        {
+            open_attempted = true;
+            file = OpenFile::open(path);
+        }
+    }
+
+    bool FileContentResponse::read_file(std::size_t offset, std::size_t length, std::vector<uint8_t>& target) const
+    {
+        auto res = true;
+
+        if (length > 0)
+        {
+            if (file)
             {
-                sent += to_send;
-                res = sent < info.size() ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
+                const auto start = target.size();
+                target.resize(start + length);
+                res = file->read(offset, target.data() + start, length) == static_cast<ssize_t>(length);
             }
             else
             {
-                res = ResponseStatus::Error;
+                std::vector<uint8_t> data{};
+                res = smooth::core::filesystem::File::read(path, data, offset, length);
+                target.insert(target.end(), data.begin(), data.end());
             }
         }
 
@@ -65,6 +206,11 @@ namespace smooth::application::network::http::regular::responses
 
     void FileContentResponse::dump() const
     {
-        Log::debug("FileContentResponse", "Code: {}; Status: {}/{} bytes, Path: {}", code, sent, info.size(), path);
+        Log::debug("FileContentResponse",
+                   "Code: {}; Status: {}/{} bytes, Path: {}",
+                   code,
+                   sent,
+                   content_length,
+                   path);
     }
 }
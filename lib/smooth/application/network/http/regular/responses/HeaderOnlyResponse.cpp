@@ -32,7 +32,7 @@ namespace smooth::application::network::http::regular::responses
     HeaderOnlyResponse::HeaderOnlyResponse(ResponseCode code)
             : code(code)
     {
-        headers[LAST_MODIFIED] = utils::make_http_time(std::chrono::system_clock::now());
+        headers[LAST_MODIFIED] = utils::http_time_now();
     }
 
     ResponseCode HeaderOnlyResponse::get_response_code()
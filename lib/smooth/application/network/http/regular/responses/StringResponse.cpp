@@ -21,7 +21,6 @@ limitations under the License.
 #include <algorithm>
 #include "smooth/core/logging/log.h"
 #include "smooth/application/network/http/regular/HTTPHeaderDef.h"
-#include "smooth/application/network/http/http_utils.h"
 
 using namespace smooth::core::logging;
 
@@ -44,7 +43,6 @@ namespace smooth::application::network::http::regular::responses
 
         headers[CONTENT_LENGTH] = std::to_string(data.size());
         headers[CONTENT_TYPE] = "text/html";
-        headers[LAST_MODIFIED] = utils::make_http_time(std::chrono::system_clock::now());
     }
 
     ResponseStatus StringResponse::get_data(std::size_t max_amount, std::vector<uint8_t>& target)
@@ -0,0 +1,86 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/network/http/regular/responses/TemplateResponse.h"
+#include <algorithm>
+#include "smooth/core/logging/log.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+
+using namespace smooth::core::logging;
+
+namespace smooth::application::network::http::regular::responses
+{
+    TemplateResponse::TemplateResponse(std::shared_ptr<const CompiledTemplate> compiled,
+                                       std::vector<std::string> values)
+            : HeaderOnlyResponse(ResponseCode::OK),
+              compiled(std::move(compiled)),
+              values(std::move(values))
+    {
+        // All values are known up front, so the length of the rendered page is too.
+        std::size_t length = 0;
+
+        for (const auto& s : this->compiled->segments)
+        {
+            length += segment_data(s).size();
+        }
+
+        headers[CONTENT_LENGTH] = std::to_string(length);
+        headers[CONTENT_TYPE] = "text/html";
+    }
+
+    ResponseStatus TemplateResponse::get_data(std::size_t max_amount, std::vector<uint8_t>& target)
+    {
+        auto res = ResponseStatus::NoData;
+        const auto& segments = compiled->segments;
+        const auto start_size = target.size();
+
+        while (segment < segments.size() && target.size() - start_size < max_amount)
+        {
+            const auto data = segment_data(segments[segment]);
+            const auto to_send = std::min(data.size() - segment_offset, max_amount - (target.size() - start_size));
+
+            target.insert(target.end(), data.begin() + static_cast<long>(segment_offset),
+                          data.begin() + static_cast<long>(segment_offset + to_send));
+            segment_offset += to_send;
+
+            if (segment_offset == data.size())
+            {
+                ++segment;
+                segment_offset = 0;
+            }
+        }
+
+        if (target.size() > start_size)
+        {
+            res = segment < segments.size() ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
+        }
+
+        return res;
+    }
+
+    std::string_view TemplateResponse::segment_data(const CompiledTemplate::Segment& s) const
+    {
+        return s.token == CompiledTemplate::Literal
+               ? std::string_view{ compiled->text }.substr(s.offset, s.length)
+               : std::string_view{ values[s.token] };
+    }
+
+    void TemplateResponse::dump() const
+    {
+        Log::debug("TemplateResponse", "Code: {}; Segment: {}/{}", code, segment, compiled->segments.size());
+    }
+}
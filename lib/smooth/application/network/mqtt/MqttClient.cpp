@@ -267,6 +267,9 @@ namespace smooth::application::network::mqtt
                 buff->clear();
 
                 mqtts_socket = core::network::SecureSocket<packet::MQTTProtocol>::create(buff, tls_context->create_context());
+
+                // Resume the previous session, if any, to avoid a full handshake on reconnects.
+                mqtts_socket->set_tls_session(tls_session);
                 mqtts_socket->set_receive_timeout(keep_alive + seconds{ 1 });
                 mqtts_socket->start(address);
             } 
@@ -292,6 +295,7 @@ namespace smooth::application::network::mqtt
         is_mqtts = true;
         tls_context = std::make_unique<smooth::core::network::MBedTLSContext>();
         tls_context->init_client(ca_cert);
+        tls_session->clear();
         
         return true;
     }
@@ -64,6 +64,30 @@ namespace smooth::core::filesystem
         cv.notify_one();
     }
 
+    FSLock::FSLock(std::adopt_lock_t)
+    {
+    }
+
+    std::unique_ptr<FSLock> FSLock::try_acquire()
+    {
+        std::unique_ptr<FSLock> res{};
+        std::unique_lock<std::mutex> guard{ lock };
+
+        if (max > 0 && count < max - 1)
+        {
+            count++;
+
+            if (count > max_ever_opened)
+            {
+                max_ever_opened = count;
+            }
+
+            res.reset(new FSLock(std::adopt_lock));
+        }
+
+        return res;
+    }
+
     FSLock::~FSLock()
     {
         std::unique_lock<std::mutex> guard{ lock };
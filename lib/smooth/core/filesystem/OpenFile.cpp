@@ -0,0 +1,127 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifndef ESP_PLATFORM
+#include <sys/mman.h>
+#endif
+#include "smooth/core/filesystem/OpenFile.h"
+#include "smooth/core/logging/log.h"
+
+using namespace smooth::core::logging;
+
+namespace smooth::core::filesystem
+{
+    std::shared_ptr<OpenFile> OpenFile::open(const Path& path)
+    {
+        std::shared_ptr<OpenFile> res{};
+        auto file_lock = FSLock::try_acquire();
+
+        if (file_lock)
+        {
+            auto fd = ::open(path, O_RDONLY);
+
+            if (fd >= 0)
+            {
+                struct stat s {};
+
+                if (fstat(fd, &s) == 0 && S_ISREG(s.st_mode))
+                {
+                    res.reset(new OpenFile(fd, static_cast<std::size_t>(s.st_size), std::move(file_lock)));
+                }
+                else
+                {
+                    close(fd);
+                }
+            }
+            else
+            {
+                Log::error("OpenFile", "Could not open {}: {}", path, strerror(errno));
+            }
+        }
+
+        return res;
+    }
+
+    OpenFile::OpenFile(int fd, std::size_t size, std::unique_ptr<FSLock> lock)
+            : fd(fd),
+              file_size(size),
+              lock(std::move(lock))
+    {
+    }
+
+    OpenFile::~OpenFile()
+    {
+#ifndef ESP_PLATFORM
+
+        if (mapping != nullptr)
+        {
+            munmap(mapping, file_size);
+        }
+#endif
+        close(fd);
+    }
+
+    ssize_t OpenFile::read(std::size_t offset, uint8_t* target, std::size_t length) const
+    {
+#ifdef ESP_PLATFORM
+
+        // Each open file is read from one thread only, so seeking first is safe.
+        ssize_t res = -1;
+
+        if (lseek(fd, static_cast<off_t>(offset), SEEK_SET) >= 0)
+        {
+            res = ::read(fd, target, length);
+        }
+
+        return res;
+#else
+
+        return pread(fd, target, length, static_cast<off_t>(offset));
+#endif
+    }
+
+    std::size_t OpenFile::current_size() const
+    {
+        struct stat s {};
+
+        return fstat(fd, &s) == 0 ? static_cast<std::size_t>(s.st_size) : 0;
+    }
+
+    const uint8_t* OpenFile::map()
+    {
+#ifndef ESP_PLATFORM
+
+        if (!map_attempted && file_size > 0 && current_size() >= file_size)
+        {
+            map_attempted = true;
+
+            auto m = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (m != MAP_FAILED)
+            {
+                mapping = m;
+            }
+        }
+#endif
+
+        return static_cast<const uint8_t*>(mapping);
+    }
+}
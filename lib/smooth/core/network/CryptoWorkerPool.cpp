@@ -0,0 +1,123 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include "smooth/core/network/CryptoWorkerPool.h"
+#include "smooth/core/task_priorities.h"
+
+#ifdef ESP_PLATFORM
+#include <esp_pthread.h>
+#endif
+
+namespace smooth::core::network
+{
+    CryptoWorkerPool::CryptoWorkerPool(std::size_t worker_count, std::size_t max_concurrent, uint32_t stack_size)
+            : max_concurrent(std::max(max_concurrent, static_cast<std::size_t>(1)))
+    {
+#ifdef ESP_PLATFORM
+
+        // Handshakes need a lot more stack than the default pthread stack size, see Task::start().
+        auto worker_config = esp_pthread_get_default_config();
+        worker_config.stack_size = stack_size;
+        worker_config.prio = CRYPTO_WORKER_PRIO;
+        worker_config.thread_name = "CryptoWorker";
+        esp_pthread_set_cfg(&worker_config);
+#else
+        (void)stack_size;
+#endif
+
+        for (std::size_t i = 0; i < std::max(worker_count, static_cast<std::size_t>(1)); ++i)
+        {
+            workers.emplace_back([this]() {
+                                     this->run();
+                                 });
+        }
+    }
+
+    CryptoWorkerPool::~CryptoWorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(guard);
+            stopping = true;
+        }
+
+        work_available.notify_all();
+
+        for (auto& w : workers)
+        {
+            w.join();
+        }
+    }
+
+    bool CryptoWorkerPool::try_submit(std::function<void()> job)
+    {
+        bool res = false;
+
+        {
+            std::lock_guard<std::mutex> lock(guard);
+
+            if (!stopping && in_flight < max_concurrent)
+            {
+                ++in_flight;
+                jobs.emplace_back(std::move(job));
+                res = true;
+            }
+        }
+
+        if (res)
+        {
+            work_available.notify_one();
+        }
+
+        return res;
+    }
+
+    std::size_t CryptoWorkerPool::get_in_flight() const
+    {
+        std::lock_guard<std::mutex> lock(guard);
+
+        return in_flight;
+    }
+
+    void CryptoWorkerPool::run()
+    {
+        std::unique_lock<std::mutex> lock(guard);
+
+        while (!stopping)
+        {
+            if (jobs.empty())
+            {
+                work_available.wait(lock);
+            }
+            else
+            {
+                auto job = std::move(jobs.front());
+                jobs.pop_front();
+
+                lock.unlock();
+
+                job();
+
+                // Release whatever the job holds (e.g. a socket) before it is counted as done.
+                job = nullptr;
+
+                lock.lock();
+                --in_flight;
+            }
+        }
+    }
+}
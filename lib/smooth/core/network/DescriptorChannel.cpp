@@ -0,0 +1,130 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ESP_PLATFORM
+
+#include <fcntl.h>
+#include <unistd.h>
+#include "smooth/core/logging/log.h"
+#include "smooth/core/network/DescriptorChannel.h"
+
+using namespace smooth::core::logging;
+
+namespace smooth::core::network
+{
+    DescriptorChannel::DescriptorChannel(std::size_t max_queued)
+            : max_queued(max_queued)
+    {
+    }
+
+    DescriptorChannel::~DescriptorChannel()
+    {
+        clear();
+    }
+
+    bool DescriptorChannel::send(int fd)
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        auto res = outgoing.size() < max_queued;
+
+        if (res)
+        {
+            auto copy = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+            res = copy >= 0;
+
+            if (res)
+            {
+                outgoing.push_back(copy);
+            }
+        }
+
+        return res;
+    }
+
+    int DescriptorChannel::receive()
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        int res = -1;
+
+        if (!incoming.empty())
+        {
+            res = incoming.front();
+            incoming.pop_front();
+        }
+
+        return res;
+    }
+
+    void DescriptorChannel::clear()
+    {
+        std::lock_guard<std::mutex> lock(guard);
+
+        for (auto fd : outgoing)
+        {
+            close(fd);
+        }
+
+        for (auto fd : incoming)
+        {
+            close(fd);
+        }
+
+        outgoing.clear();
+        incoming.clear();
+    }
+
+    std::size_t DescriptorChannel::peek_outgoing(int* target)
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        std::size_t count = 0;
+
+        for (auto it = outgoing.begin(); it != outgoing.end() && count < MaxPerMessage; ++it)
+        {
+            target[count++] = *it;
+        }
+
+        return count;
+    }
+
+    void DescriptorChannel::outgoing_sent(std::size_t count)
+    {
+        std::lock_guard<std::mutex> lock(guard);
+
+        for (std::size_t i = 0; i < count && !outgoing.empty(); ++i)
+        {
+            close(outgoing.front());
+            outgoing.pop_front();
+        }
+    }
+
+    void DescriptorChannel::add_incoming(int fd)
+    {
+        std::lock_guard<std::mutex> lock(guard);
+
+        if (incoming.size() < max_queued)
+        {
+            incoming.push_back(fd);
+        }
+        else
+        {
+            Log::warning("DescriptorChannel", "Receive queue full, closing descriptor {}", fd);
+            close(fd);
+        }
+    }
+}
+
+#endif
@@ -58,6 +58,11 @@ namespace smooth::core::network
     {
     }
 
+    void IPv4::set_address(const sockaddr_in& addr)
+    {
+        sock_address = addr;
+    }
+
     sockaddr* IPv4::get_socket_address()
     {
         return reinterpret_cast<sockaddr*>(&sock_address);
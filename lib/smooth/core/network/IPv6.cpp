@@ -35,6 +35,11 @@ namespace smooth::core::network
     {
     }
 
+    void IPv6::set_address(const sockaddr_in6& address)
+    {
+        sock_address = address;
+    }
+
     bool IPv6::resolve_ip()
     {
         return true;
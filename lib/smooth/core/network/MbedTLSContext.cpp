@@ -59,6 +59,12 @@ namespace smooth::core::network
         mbedtls_x509_crt_init(&server_cert);
         mbedtls_entropy_init(&entropy);
         mbedtls_ctr_drbg_init(&ctr_drbg);
+#if defined(MBEDTLS_SSL_CACHE_C)
+        mbedtls_ssl_cache_init(&cache);
+#endif
+#if defined(MBEDTLS_SSL_TICKET_C)
+        mbedtls_ssl_ticket_init(&ticket);
+#endif
 
 #if defined(ESP_PLATFORM)
     #if defined(CONFIG_MBEDTLS_DEBUG)
@@ -91,7 +97,7 @@ namespace smooth::core::network
             }
             else
             {
-                mbedtls_ssl_conf_rng(&conf, mbedtls_ctr_drbg_random, &ctr_drbg);
+                mbedtls_ssl_conf_rng(&conf, random, this);
             }
         }
 
@@ -127,7 +133,8 @@ namespace smooth::core::network
     bool MBedTLSContext::init_server(const std::vector<unsigned char>& ca_certificates,
                                      const std::vector<unsigned char>& server_certificate,
                                      const std::vector<unsigned char>& private_key,
-                                     const std::vector<unsigned char>& password)
+                                     const std::vector<unsigned char>& password,
+                                     const TLSSessionOptions& session_options)
     {
         auto res = common_init(true);
 
@@ -165,11 +172,146 @@ namespace smooth::core::network
             }
         }
 
+        if (res == 0)
+        {
+            res = init_session_resumption(session_options);
+        }
+
+        return res == 0;
+    }
+
+    int MBedTLSContext::init_session_resumption(const TLSSessionOptions& options)
+    {
+        int res = 0;
+        auto lifetime = static_cast<int>(options.lifetime.count());
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+
+        if (options.cache_size > 0)
+        {
+            mbedtls_ssl_cache_set_max_entries(&cache, options.cache_size);
+            mbedtls_ssl_cache_set_timeout(&cache, lifetime);
+            mbedtls_ssl_conf_session_cache(&conf, this, cache_get, cache_set);
+        }
+#endif
+#if defined(MBEDTLS_SSL_TICKET_C) && defined(MBEDTLS_SSL_SESSION_TICKETS)
+
+        if (options.tickets)
+        {
+            res = mbedtls_ssl_ticket_setup(&ticket,
+                                           random,
+                                           this,
+                                           MBEDTLS_CIPHER_AES_256_GCM,
+                                           static_cast<uint32_t>(lifetime));
+
+            if (res != 0)
+            {
+                log_mbedtls_error(tag, "mbedtls_ssl_ticket_setup", res);
+            }
+            else
+            {
+                mbedtls_ssl_conf_session_tickets_cb(&conf, ticket_write, ticket_parse, this);
+            }
+        }
+#endif
+
+        // Unsupported features are simply not used.
+        (void)lifetime;
+
+        return res;
+    }
+
+    int MBedTLSContext::random(void* ctx, unsigned char* output, size_t length)
+    {
+        auto self = static_cast<MBedTLSContext*>(ctx);
+        std::lock_guard<std::mutex> lock(self->rng_guard);
+
+        return mbedtls_ctr_drbg_random(&self->ctr_drbg, output, length);
+    }
+
+    int MBedTLSContext::cache_get(void* ctx, mbedtls_ssl_session* session)
+    {
+        auto res = -1;
+#if defined(MBEDTLS_SSL_CACHE_C)
+        auto self = static_cast<MBedTLSContext*>(ctx);
+        std::lock_guard<std::mutex> lock(self->resumption_guard);
+
+        // Only called when the client offers a session ID
+        res = mbedtls_ssl_cache_get(&self->cache, session);
+        SSLContext::note_resumption(res == 0);
+#else
+        (void)ctx;
+        (void)session;
+#endif
+
+        return res;
+    }
+
+    int MBedTLSContext::cache_set(void* ctx, const mbedtls_ssl_session* session)
+    {
+        auto res = -1;
+#if defined(MBEDTLS_SSL_CACHE_C)
+        auto self = static_cast<MBedTLSContext*>(ctx);
+        std::lock_guard<std::mutex> lock(self->resumption_guard);
+        res = mbedtls_ssl_cache_set(&self->cache, session);
+#else
+        (void)ctx;
+        (void)session;
+#endif
+
+        return res;
+    }
+
+    int MBedTLSContext::ticket_write(void* ctx,
+                                     const mbedtls_ssl_session* session,
+                                     unsigned char* start,
+                                     const unsigned char* end,
+                                     size_t* length,
+                                     uint32_t* lifetime)
+    {
+        auto res = -1;
+#if defined(MBEDTLS_SSL_TICKET_C)
+        auto self = static_cast<MBedTLSContext*>(ctx);
+        std::lock_guard<std::mutex> lock(self->resumption_guard);
+        res = mbedtls_ssl_ticket_write(&self->ticket, session, start, end, length, lifetime);
+#else
+        (void)ctx;
+        (void)session;
+        (void)start;
+        (void)end;
+        (void)length;
+        (void)lifetime;
+#endif
+
+        return res;
+    }
+
+    int MBedTLSContext::ticket_parse(void* ctx, mbedtls_ssl_session* session, unsigned char* buf, size_t length)
+    {
+        auto res = -1;
+#if defined(MBEDTLS_SSL_TICKET_C)
+        auto self = static_cast<MBedTLSContext*>(ctx);
+        std::lock_guard<std::mutex> lock(self->resumption_guard);
+        res = mbedtls_ssl_ticket_parse(&self->ticket, session, buf, length);
+        SSLContext::note_resumption(res == 0);
+#else
+        (void)ctx;
+        (void)session;
+        (void)buf;
+        (void)length;
+#endif
+
         return res;
     }
 
     MBedTLSContext::~MBedTLSContext()
     {
+#if defined(MBEDTLS_SSL_TICKET_C)
+        mbedtls_ssl_ticket_free(&ticket);
+#endif
+#if defined(MBEDTLS_SSL_CACHE_C)
+        mbedtls_ssl_cache_free(&cache);
+#endif
         mbedtls_ctr_drbg_free(&ctr_drbg);
         mbedtls_entropy_free(&entropy);
         mbedtls_x509_crt_free(&ca_chain);
@@ -197,14 +339,173 @@ namespace smooth::core::network
 
     std::unique_ptr<SSLContext> MBedTLSContext::create_context()
     {
-        auto context = std::make_unique<SSLContext>();
-        auto res = mbedtls_ssl_setup(*context, &conf);
+        std::unique_ptr<SSLContext> context{};
 
-        if (res != 0)
         {
-            log_mbedtls_error(tag, "mbedtls_ssl_setup", res);
+            std::lock_guard<std::mutex> lock(pool_guard);
+
+            if (!context_pool.empty())
+            {
+                context = std::move(context_pool.back());
+                context_pool.pop_back();
+            }
+        }
+
+        if (!context)
+        {
+            context = std::make_unique<SSLContext>();
+            context->set_key_guard(key_guard);
+            auto res = mbedtls_ssl_setup(*context, &conf);
+
+            if (res != 0)
+            {
+                log_mbedtls_error(tag, "mbedtls_ssl_setup", res);
+            }
         }
 
         return context;
     }
+
+    void MBedTLSContext::recycle_context(std::unique_ptr<SSLContext> context)
+    {
+        if (context)
+        {
+            // Keeps the configuration and buffers, but clears all connection state.
+            auto res = mbedtls_ssl_session_reset(*context);
+
+            if (res != 0)
+            {
+                log_mbedtls_error(tag, "mbedtls_ssl_session_reset", res);
+            }
+            else
+            {
+                std::lock_guard<std::mutex> lock(pool_guard);
+
+                if (context_pool.size() < context_pool_size)
+                {
+                    context_pool.emplace_back(std::move(context));
+                }
+            }
+        }
+    }
+
+    void MBedTLSContext::set_context_pool_size(std::size_t size)
+    {
+        std::lock_guard<std::mutex> lock(pool_guard);
+        context_pool_size = size;
+
+        if (context_pool.size() > size)
+        {
+            context_pool.resize(size);
+        }
+    }
+
+    bool MBedTLSContext::set_max_fragment_length(int length)
+    {
+        auto res = false;
+
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+        auto code = MBEDTLS_SSL_MAX_FRAG_LEN_NONE;
+
+        if (length == 512)
+        {
+            code = MBEDTLS_SSL_MAX_FRAG_LEN_512;
+        }
+        else if (length == 1024)
+        {
+            code = MBEDTLS_SSL_MAX_FRAG_LEN_1024;
+        }
+        else if (length == 2048)
+        {
+            code = MBEDTLS_SSL_MAX_FRAG_LEN_2048;
+        }
+        else if (length == 4096)
+        {
+            code = MBEDTLS_SSL_MAX_FRAG_LEN_4096;
+        }
+
+        auto err = mbedtls_ssl_conf_max_frag_len(&conf, static_cast<unsigned char>(code));
+        res = err == 0;
+
+        if (!res)
+        {
+            log_mbedtls_error(tag, "mbedtls_ssl_conf_max_frag_len", err);
+        }
+#else
+        (void)length;
+        Log::warning(tag, "Max fragment length is not supported by this mbedTLS configuration");
+#endif
+
+        return res;
+    }
+
+    TLSSession::TLSSession()
+    {
+        mbedtls_ssl_session_init(&session);
+    }
+
+    TLSSession::~TLSSession()
+    {
+        mbedtls_ssl_session_free(&session);
+    }
+
+    void TLSSession::restore(SSLContext& context)
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        offered = false;
+
+        if (valid)
+        {
+            auto res = mbedtls_ssl_set_session(context, &session);
+
+            if (res == 0)
+            {
+                offered = true;
+            }
+            else
+            {
+                log_mbedtls_error(tag, "mbedtls_ssl_set_session", res);
+            }
+        }
+    }
+
+    void TLSSession::save(SSLContext& context)
+    {
+        std::lock_guard<std::mutex> lock(guard);
+
+        mbedtls_ssl_session current;
+        mbedtls_ssl_session_init(&current);
+
+        if (mbedtls_ssl_get_session(context, &current) == 0)
+        {
+            if (offered)
+            {
+                // A resumed session keeps the master secret of the offered session, a full handshake
+                // derives a new one. The session ID can't tell, as a server resuming from a ticket
+                // echoes whatever ID the client sent.
+                auto resumed = memcmp(current.master, session.master, sizeof(session.master)) == 0;
+
+                ++(resumed ? hits : misses);
+            }
+
+            mbedtls_ssl_session_free(&session);
+            session = current;
+            valid = true;
+        }
+        else
+        {
+            mbedtls_ssl_session_free(&current);
+        }
+
+        offered = false;
+    }
+
+    void TLSSession::clear()
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        mbedtls_ssl_session_free(&session);
+        mbedtls_ssl_session_init(&session);
+        valid = false;
+        offered = false;
+    }
 }
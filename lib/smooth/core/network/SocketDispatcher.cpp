@@ -24,6 +24,7 @@ limitations under the License.
 #ifndef ESP_PLATFORM
 
 #include <unistd.h>
+#include <ctime>
 
 #endif
 
@@ -67,6 +68,7 @@ namespace smooth::core::network
     void SocketDispatcher::tick()
     {
         std::lock_guard<std::mutex> lock(socket_guard);
+        close_deferred_sockets();
         restart_inactive_sockets();
         check_socket_timeouts();
 
@@ -74,38 +76,18 @@ namespace smooth::core::network
 
         if (max_file_descriptor >= 0)
         {
-            set_timeout();
+            set_timeout(pending_data_count > 0 || offloaded_socket_count > 0 || !deferred_close.empty());
             int res = select(max_file_descriptor + 1, &read_set, &write_set, nullptr, &tv);
 
             if (res == -1)
             {
                 Log::error(tag, "Error during select: {}", strerror(errno));
-            }
-            else if (res > 0)
-            {
-                for (int i = 0; i <= max_file_descriptor; ++i)
-                {
-                    if (is_fd_set(static_cast<FD>(i), read_set))
-                    {
-                        auto it = active_sockets.find(i);
 
-                        if (it != active_sockets.end())
-                        {
-                            it->second->readable(*this);
-                        }
-                    }
-
-                    if (is_fd_set(static_cast<FD>(i), write_set))
-                    {
-                        auto it = active_sockets.find(i);
-
-                        if (it != active_sockets.end())
-                        {
-                            it->second->writable();
-                        }
-                    }
-                }
+                // Nothing is known to be ready, but sockets with pending data are still serviced.
+                clear_sets();
             }
+
+            service_sockets();
         }
         else
         {
@@ -124,12 +106,124 @@ namespace smooth::core::network
             // operation, but only when there was no socket read/write to do prior to that operation being queued.
             std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
+
+        update_cpu_time();
+    }
+
+    void SocketDispatcher::service_sockets()
+    {
+        const auto iteration_start = steady_clock::now();
+        auto max_delay = steady_clock::duration::zero();
+        uint64_t rescheduled = 0;
+
+        // Service the ready sockets in round-robin order, starting after the socket that was first in line
+        // the previous iteration, so that no socket is always served ahead of (or behind) the others.
+        service_order.clear();
+        const auto first = active_sockets.upper_bound(last_first_serviced);
+
+        for (auto it = first; it != active_sockets.end(); ++it)
+        {
+            add_if_ready(it->second);
+        }
+
+        for (auto it = active_sockets.begin(); it != first; ++it)
+        {
+            add_if_ready(it->second);
+        }
+
+        for (auto& s : service_order)
+        {
+            max_delay = std::max(max_delay, steady_clock::now() - iteration_start);
+
+            auto fd = static_cast<FD>(s->get_socket_id());
+
+            // Sockets holding data already read from the underlying socket are readable regardless.
+            if (is_fd_set(fd, read_set) || has_pending_data(s))
+            {
+                s->readable(*this);
+            }
+
+            if (is_fd_set(fd, write_set))
+            {
+                s->writable();
+            }
+
+            if (s->has_pending_data())
+            {
+                ++rescheduled;
+            }
+        }
+
+        if (!service_order.empty())
+        {
+            last_first_serviced = service_order.front()->get_socket_id();
+        }
+
+        const auto iteration_time = steady_clock::now() - iteration_start;
+
+        std::lock_guard<std::mutex> lock(statistics_guard);
+        ++statistics.iterations;
+        statistics.services += service_order.size();
+        statistics.rescheduled += rescheduled;
+        statistics.max_service_delay = std::max(statistics.max_service_delay,
+                                                duration_cast<microseconds>(max_delay));
+        statistics.max_iteration_time = std::max(statistics.max_iteration_time,
+                                                 duration_cast<microseconds>(iteration_time));
+    }
+
+    void SocketDispatcher::add_if_ready(const std::shared_ptr<ISocket>& socket)
+    {
+        auto fd = static_cast<FD>(socket->get_socket_id());
+
+        if (is_fd_set(fd, read_set) || is_fd_set(fd, write_set) || has_pending_data(socket))
+        {
+            service_order.push_back(socket);
+        }
     }
 
-    void SocketDispatcher::set_timeout()
+    bool SocketDispatcher::has_pending_data(const std::shared_ptr<ISocket>& socket)
     {
+        return pending_data_count > 0 && is_fd_set(static_cast<FD>(socket->get_socket_id()), pending_set);
+    }
+
+    void SocketDispatcher::set_io_budget(const IOBudget& budget)
+    {
+        // Read by the sockets on every turn, so no lock is taken.
+        budget_bytes.store(budget.bytes, std::memory_order_relaxed);
+        budget_packets.store(budget.packets, std::memory_order_relaxed);
+    }
+
+    DispatcherStatistics SocketDispatcher::get_statistics() const
+    {
+        std::lock_guard<std::mutex> lock(statistics_guard);
+
+        return statistics;
+    }
+
+    void SocketDispatcher::reset_statistics()
+    {
+        std::lock_guard<std::mutex> lock(statistics_guard);
+        statistics = DispatcherStatistics{};
+    }
+
+    void SocketDispatcher::update_cpu_time()
+    {
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+        timespec t{};
+
+        if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t) == 0)
+        {
+            cpu_time_us = static_cast<int64_t>(t.tv_sec) * 1000000 + t.tv_nsec / 1000;
+        }
+#endif
+    }
+
+    void SocketDispatcher::set_timeout(bool short_timeout)
+    {
+        // With pending data, poll often so that it is delivered soon after the application has made room for it.
+        // Likewise, sockets that are offloaded to another thread are picked up soon after that work is done.
         tv.tv_sec = 0;
-        tv.tv_usec = 10000;
+        tv.tv_usec = short_timeout ? 1000 : 10000;
     }
 
     void SocketDispatcher::clear_sets()
@@ -144,6 +238,12 @@ namespace smooth::core::network
     int SocketDispatcher::build_sets()
     {
         clear_sets();
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+        FD_ZERO(&pending_set);
+#pragma GCC diagnostic pop
+        pending_data_count = 0;
+        offloaded_socket_count = 0;
 
         int max = ISocket::INVALID_SOCKET;
 
@@ -153,7 +253,11 @@ namespace smooth::core::network
 
             max = std::max(max, s->get_socket_id());
 
-            if (s->is_active())
+            if (s->is_offloaded())
+            {
+                ++offloaded_socket_count;
+            }
+            else if (s->is_active())
             {
                 if (!is_backed_off(s->get_socket_id()))
                 {
@@ -165,6 +269,12 @@ namespace smooth::core::network
                     if (s->is_connected())
                     {
                         set_fd(static_cast<FD>(s->get_socket_id()), read_set);
+
+                        if (s->has_pending_data())
+                        {
+                            set_fd(static_cast<FD>(s->get_socket_id()), pending_set);
+                            ++pending_data_count;
+                        }
                     }
                 }
             }
@@ -194,6 +304,43 @@ namespace smooth::core::network
     {
         std::lock_guard<std::mutex> lock(socket_guard);
 
+        if (socket->is_offloaded())
+        {
+            // A worker thread is using the socket. Closing it now would let the descriptor be reused by
+            // the next accepted connection while the worker still reads and writes it, so the socket is
+            // closed once the worker is done with it.
+            remove_socket_from_active_sockets(socket);
+
+            if (std::find(deferred_close.begin(), deferred_close.end(), socket) == deferred_close.end())
+            {
+                deferred_close.push_back(std::move(socket));
+            }
+        }
+        else
+        {
+            close_socket(socket);
+        }
+    }
+
+    void SocketDispatcher::close_deferred_sockets()
+    {
+        for (auto it = deferred_close.begin(); it != deferred_close.end();)
+        {
+            if ((*it)->is_offloaded())
+            {
+                ++it;
+            }
+            else
+            {
+                auto socket = std::move(*it);
+                it = deferred_close.erase(it);
+                close_socket(socket);
+            }
+        }
+    }
+
+    void SocketDispatcher::close_socket(std::shared_ptr<ISocket>& socket)
+    {
         Log::verbose(tag, "Shutting down socket {}, ID: {}", static_cast<void*>(socket.get()), socket->get_socket_id());
         socket->stop_internal();
         remove_socket_from_active_sockets(socket);
@@ -339,7 +486,11 @@ namespace smooth::core::network
     {
         for (auto& pair : active_sockets)
         {
-            if (pair.second->has_send_expired())
+            if (pair.second->is_offloaded())
+            {
+                // Timeouts are checked once the socket is back.
+            }
+            else if (pair.second->has_send_expired())
             {
                 Log::warning(tag, "Send timeout on socket {} ({} ms)", static_cast<void*>(pair.second.get()),
                                          pair.second->get_send_timeout().count());
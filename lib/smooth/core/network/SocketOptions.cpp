@@ -0,0 +1,144 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/core/network/SocketOptions.h"
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#include <sys/socket.h>
+#pragma GCC diagnostic pop
+#ifndef ESP_PLATFORM
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#endif
+#include <cstring>
+#include <cerrno>
+#include "smooth/core/logging/log.h"
+
+using namespace smooth::core::logging;
+
+namespace smooth::core::network
+{
+    static constexpr const char* tag = "SocketOptions";
+
+    static bool set_option(int socket_id, int level, int option, int value, const char* name)
+    {
+        auto res = setsockopt(socket_id, level, option, &value, sizeof(value)) == 0;
+
+        if (!res)
+        {
+            Log::warning(tag, "Could not set {} to {} on socket {}: {}", name, value, socket_id, strerror(errno));
+        }
+
+        return res;
+    }
+
+    bool SocketOptions::apply(int socket_id, bool is_tcp) const
+    {
+        bool res = true;
+
+        if (send_buffer_size > 0)
+        {
+            res &= set_option(socket_id, SOL_SOCKET, SO_SNDBUF, send_buffer_size, "SO_SNDBUF");
+        }
+
+        if (receive_buffer_size > 0)
+        {
+            res &= set_option(socket_id, SOL_SOCKET, SO_RCVBUF, receive_buffer_size, "SO_RCVBUF");
+        }
+
+#ifdef SO_BUSY_POLL
+
+        if (busy_poll.count() > 0)
+        {
+            res &= set_option(socket_id, SOL_SOCKET, SO_BUSY_POLL, static_cast<int>(busy_poll.count()),
+                              "SO_BUSY_POLL");
+        }
+#endif
+
+        if (is_tcp)
+        {
+            if (no_delay)
+            {
+                res &= set_option(socket_id, IPPROTO_TCP, TCP_NODELAY, 1, "TCP_NODELAY");
+            }
+
+            if (keep_alive)
+            {
+                res &= set_option(socket_id, SOL_SOCKET, SO_KEEPALIVE, 1, "SO_KEEPALIVE");
+
+#ifdef TCP_KEEPIDLE
+
+                if (keep_alive_idle.count() > 0)
+                {
+                    res &= set_option(socket_id, IPPROTO_TCP, TCP_KEEPIDLE, static_cast<int>(keep_alive_idle.count()),
+                                      "TCP_KEEPIDLE");
+                }
+#endif
+#ifdef TCP_KEEPINTVL
+
+                if (keep_alive_interval.count() > 0)
+                {
+                    res &= set_option(socket_id, IPPROTO_TCP, TCP_KEEPINTVL,
+                                      static_cast<int>(keep_alive_interval.count()), "TCP_KEEPINTVL");
+                }
+#endif
+#ifdef TCP_KEEPCNT
+
+                if (keep_alive_count > 0)
+                {
+                    res &= set_option(socket_id, IPPROTO_TCP, TCP_KEEPCNT, keep_alive_count, "TCP_KEEPCNT");
+                }
+#endif
+            }
+
+#ifdef TCP_USER_TIMEOUT
+
+            if (user_timeout.count() > 0)
+            {
+                res &= set_option(socket_id, IPPROTO_TCP, TCP_USER_TIMEOUT, static_cast<int>(user_timeout.count()),
+                                  "TCP_USER_TIMEOUT");
+            }
+#endif
+        }
+
+        return res;
+    }
+
+    bool SocketOptions::is_cork_supported()
+    {
+#ifdef TCP_CORK
+
+        return true;
+#else
+
+        return false;
+#endif
+    }
+
+    bool SocketOptions::set_cork(int socket_id, bool corked)
+    {
+#ifdef TCP_CORK
+
+        return set_option(socket_id, IPPROTO_TCP, TCP_CORK, corked ? 1 : 0, "TCP_CORK");
+#else
+        (void)socket_id;
+        (void)corked;
+
+        return false;
+#endif
+    }
+}
@@ -0,0 +1,156 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ESP_PLATFORM
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "smooth/core/logging/log.h"
+#include "smooth/core/network/UnixAddress.h"
+
+using namespace smooth::core::logging;
+
+namespace smooth::core::network
+{
+    UnixAddress::UnixAddress(const std::string& path, int socket_type)
+            : InetAddress(path, 0),
+              socket_type(socket_type)
+    {
+    }
+
+    UnixAddress::UnixAddress(const sockaddr_un& addr, socklen_t length)
+            : InetAddress("", 0),
+              socket_type(SOCK_STREAM)
+    {
+        set_address(addr, length);
+    }
+
+    void UnixAddress::set_address(const sockaddr_un& addr, socklen_t length)
+    {
+        sock_address = addr;
+        address_length = std::min(length, static_cast<socklen_t>(sizeof(sock_address)));
+
+        auto path_length = address_length > offsetof(sockaddr_un, sun_path)
+                           ? address_length - offsetof(sockaddr_un, sun_path) : 0;
+
+        if (path_length == 0)
+        {
+            // Unnamed, as is the case for most connecting peers.
+            host.clear();
+        }
+        else if (sock_address.sun_path[0] == '\0')
+        {
+            host = "@" + std::string(&sock_address.sun_path[1], path_length - 1);
+        }
+        else
+        {
+            host = std::string(sock_address.sun_path, strnlen(sock_address.sun_path, path_length));
+        }
+
+        resolved_ip = host;
+        valid = true;
+    }
+
+    sockaddr* UnixAddress::get_socket_address()
+    {
+        return reinterpret_cast<sockaddr*>(&sock_address);
+    }
+
+    socklen_t UnixAddress::get_socket_address_length() const
+    {
+        return address_length;
+    }
+
+    bool UnixAddress::resolve_ip()
+    {
+        memset(&sock_address, 0, sizeof(sock_address));
+        sock_address.sun_family = AF_UNIX;
+
+        // Room for the path, and for file system paths, the terminating null.
+        valid = !host.empty() && host.size() < sizeof(sock_address.sun_path);
+
+        if (valid)
+        {
+            // The leading '@' of abstract addresses becomes the leading null in sun_path.
+            std::copy(host.begin() + (is_abstract() ? 1 : 0),
+                      host.end(),
+                      &sock_address.sun_path[is_abstract() ? 1 : 0]);
+
+            // Abstract addresses are not null terminated; the length determines the name.
+            address_length = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + host.size()
+                                                    + (is_abstract() ? 0 : 1));
+            resolved_ip = host;
+        }
+        else
+        {
+            Log::error("UnixAddress", "Invalid socket path '{}'", host);
+        }
+
+        return valid;
+    }
+
+    bool UnixAddress::prepare_bind()
+    {
+        auto res = true;
+        struct stat info{};
+
+        // A socket file remaining from a previous run would make bind() fail with EADDRINUSE.
+        if (valid && !is_abstract() && lstat(sock_address.sun_path, &info) == 0)
+        {
+            if (!S_ISSOCK(info.st_mode))
+            {
+                Log::error("UnixAddress", "{} exists and is not a socket", host);
+                errno = EEXIST;
+                res = false;
+            }
+            else if (is_in_use())
+            {
+                Log::error("UnixAddress", "{} is in use by another server", host);
+                errno = EADDRINUSE;
+                res = false;
+            }
+            else if (unlink(sock_address.sun_path) == 0)
+            {
+                Log::verbose("UnixAddress", "Removed stale socket file {}", host);
+            }
+        }
+
+        return res;
+    }
+
+    bool UnixAddress::is_in_use() const
+    {
+        auto res = false;
+        auto s = socket(AF_UNIX, socket_type | SOCK_CLOEXEC, 0);
+
+        if (s >= 0)
+        {
+            // Connecting only succeeds while a server is bound to the path.
+            res = connect(s, reinterpret_cast<const sockaddr*>(&sock_address), address_length) == 0;
+            close(s);
+        }
+
+        return res;
+    }
+}
+
+#endif
@@ -0,0 +1,67 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "smooth/application/network/http/regular/RequestRecord.h"
+
+namespace smooth::application::network::http
+{
+    /// Fixed-size ring of the most recently completed requests. Entries are kept in binary form so that
+    /// logging a request neither formats text nor allocates memory; when full, the oldest entry is overwritten.
+    /// The lock is private to the ring and is only contended while the entries are copied.
+    class HTTPAccessLog
+    {
+        public:
+            struct Entry
+            {
+                /// Route id of requests not handled by a route.
+                static constexpr uint32_t NoRoute = UINT32_MAX;
+
+                /// Completion time, in seconds since the epoch.
+                uint32_t time{ 0 };
+                uint32_t latency_us{ 0 };
+                uint32_t bytes_in{ 0 };
+                uint32_t bytes_out{ 0 };
+                uint32_t route{ NoRoute };
+                uint16_t status{ 0 };
+                uint8_t method{ 0 };
+            };
+
+            explicit HTTPAccessLog(std::size_t size);
+
+            /// Adds a completed request, overwriting the oldest entry when full.
+            void add(const regular::RequestRecord& record,
+                     std::chrono::microseconds latency,
+                     std::chrono::system_clock::time_point completed);
+
+            /// \return A copy of the entries, oldest first.
+            [[nodiscard]] std::vector<Entry> get_entries() const;
+
+            /// \return The number of requests added since creation, including those since overwritten.
+            [[nodiscard]] uint64_t get_total() const;
+
+        private:
+            mutable std::mutex guard{};
+            std::vector<Entry> entries;
+            uint64_t total{ 0 };
+    };
+}
@@ -0,0 +1,129 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "smooth/core/Task.h"
+#include "smooth/core/ipc/TaskEventQueue.h"
+#include "smooth/core/network/InetAddress.h"
+#include "smooth/core/network/MbedTLSContext.h"
+#include "smooth/application/network/http/HTTPClientConnection.h"
+#include "smooth/application/network/http/HTTPClientResponse.h"
+#include "smooth/application/network/http/regular/HTTPMethod.h"
+
+namespace smooth::application::network::http
+{
+    /// HTTP/1.1 client keeping a pool of keep-alive connections per host. Requests to the same host
+    /// reuse idle connections and are pipelined on them; non-idempotent requests (POST) are only sent
+    /// on a connection without other requests in flight. The responses are delivered, in parts as they
+    /// are received, to the response queue.
+    ///
+    /// All methods must be called from the task passed to the constructor, which also handles the connections.
+    ///
+    /// Responses without Content-Length or chunked transfer coding end when the server closes the connection.
+    ///
+    /// Limitations: HEAD requests are not supported, since a response is framed without knowing the request
+    /// it answers.
+    class HTTPClient
+    {
+        public:
+            /// Constructor
+            /// \param task The task in which the connections are handled.
+            /// \param response_queue The queue where the responses are posted.
+            /// \param max_connections_per_host The maximum number of simultaneous connections to the same host.
+            /// \param pipeline_depth The maximum number of requests in flight on a single connection. Must be less
+            /// than the size of the transmit buffer of the connections (5).
+            /// \param max_header_size The maximum size of the response headers.
+            /// \param content_chunk_size The maximum amount of content delivered in a single response part.
+            /// \param idle_timeout Connections are closed when nothing has been received for this long, which
+            /// also limits the time the server may take to respond.
+            HTTPClient(core::Task& task,
+                       std::weak_ptr<core::ipc::TaskEventQueue<HTTPClientResponse>> response_queue,
+                       std::size_t max_connections_per_host = 2,
+                       std::size_t pipeline_depth = 4,
+                       int max_header_size = 2048,
+                       int content_chunk_size = 2048,
+                       std::chrono::milliseconds idle_timeout = std::chrono::seconds{ 30 });
+
+            ~HTTPClient();
+
+            HTTPClient(const HTTPClient&) = delete;
+
+            HTTPClient& operator=(const HTTPClient&) = delete;
+
+            /// Makes all following connections use TLS, verifying the servers against the given CA certificate(s).
+            bool load_certificate(const std::vector<unsigned char>& ca_cert);
+
+            /// Queues a request for sending. The Host and Content-Length headers are added, unless given.
+            /// \param address The host to send the request to.
+            /// \param method The method.
+            /// \param url The request target, i.e. the path and query.
+            /// \param headers Additional request headers.
+            /// \param content The request body.
+            /// \return The id identifying the responses to this request, or 0 if the request can't be made.
+            uint32_t request(const std::shared_ptr<core::network::InetAddress>& address,
+                             regular::HTTPMethod method,
+                             const std::string& url,
+                             const std::unordered_map<std::string, std::string>& headers = {},
+                             const std::vector<uint8_t>& content = {});
+
+            /// Closes all connections. Requests without a complete response are reported as failed.
+            void close_all();
+
+        private:
+            friend class HTTPClientConnection;
+
+            struct Host
+            {
+                std::shared_ptr<core::network::InetAddress> address;
+                std::deque<HTTPClientRequest> waiting{};
+                std::vector<std::unique_ptr<HTTPClientConnection>> connections{};
+                std::shared_ptr<core::network::TLSSession> tls_session{};
+            };
+
+            /// Sends as many of the waiting requests to the host as the connections allow, opening new
+            /// connections when needed.
+            void dispatch(const std::string& host_key);
+
+            /// Called when a connection to the host could not be established.
+            void connection_failed(const std::string& host_key);
+
+            /// Called by a connection when it was lost or closed with requests not completely answered.
+            /// Idempotent requests that received no response are resent once, the others are failed.
+            void unanswered(const std::string& host_key, std::deque<HTTPClientRequest>& requests, bool partial_first);
+
+            void deliver(const HTTPClientResponse& response);
+
+            core::Task& task;
+            std::weak_ptr<core::ipc::TaskEventQueue<HTTPClientResponse>> response_queue;
+            const std::size_t max_connections_per_host;
+            const std::size_t pipeline_depth;
+            const int max_header_size;
+            const int content_chunk_size;
+            const std::chrono::milliseconds idle_timeout;
+            std::unique_ptr<core::network::MBedTLSContext> tls_context{};
+            std::unordered_map<std::string, Host> hosts{};
+            uint32_t next_id{ 1 };
+            bool closing_all{ false };
+    };
+}
@@ -0,0 +1,149 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include "smooth/core/Task.h"
+#include "smooth/core/ipc/IEventListener.h"
+#include "smooth/core/network/BufferContainer.h"
+#include "smooth/core/network/InetAddress.h"
+#include "smooth/core/network/MbedTLSContext.h"
+#include "smooth/core/network/Socket.h"
+#include "smooth/core/network/event/ConnectionStatusEvent.h"
+#include "smooth/core/network/event/DataAvailableEvent.h"
+#include "smooth/core/network/event/TransmitBufferEmptyEvent.h"
+#include "smooth/application/network/http/HTTPPacket.h"
+#include "smooth/application/network/http/HTTPProtocol.h"
+#include "smooth/application/network/http/IServerResponse.h"
+
+namespace smooth::application::network::http
+{
+    class HTTPClient;
+
+    /// A request waiting for, or being sent on, a connection of the HTTPClient.
+    struct HTTPClientRequest
+    {
+        uint32_t id;
+        regular::HTTPMethod method;
+        HTTPPacket packet;
+
+        // Set once the request has been resent after the connection was lost before any response arrived.
+        bool retried;
+    };
+
+    /// A keep-alive connection to a single host, owned by the HTTPClient. Requests are pipelined,
+    /// i.e. sent without waiting for the responses to earlier requests, and the responses are
+    /// delivered in the order the requests were sent.
+    class HTTPClientConnection
+        : public core::ipc::IEventListener<core::network::event::TransmitBufferEmptyEvent>,
+        public core::ipc::IEventListener<core::network::event::DataAvailableEvent<HTTPProtocol>>,
+        public core::ipc::IEventListener<core::network::event::ConnectionStatusEvent>,
+        public IServerResponse
+    {
+        public:
+            HTTPClientConnection(HTTPClient& client,
+                                 std::string host_key,
+                                 std::shared_ptr<core::network::InetAddress> address);
+
+            ~HTTPClientConnection() override;
+
+            HTTPClientConnection(const HTTPClientConnection&) = delete;
+
+            HTTPClientConnection& operator=(const HTTPClientConnection&) = delete;
+
+            /// Starts connecting, unless already connected or connecting.
+            /// \return false if the connection could not be started.
+            bool connect();
+
+            /// Closes the connection. Requests without a complete response are handed back to the client.
+            void close(const char* reason);
+
+            /// Returns true when the request may be sent on this connection right away.
+            [[nodiscard]] bool can_send(const HTTPClientRequest& request) const;
+
+            /// Sends the request; the caller must have checked can_send() first.
+            void send(HTTPClientRequest request);
+
+            [[nodiscard]] bool is_closed() const
+            {
+                return state == State::Closed;
+            }
+
+            [[nodiscard]] bool is_connected() const
+            {
+                return state == State::Connected;
+            }
+
+            /// The number of requests sent whose responses have not yet been completely received.
+            [[nodiscard]] std::size_t get_in_flight() const
+            {
+                return in_flight.size();
+            }
+
+            /// Returns true for requests that can be resent without changing their effect on the server.
+            static bool is_idempotent(regular::HTTPMethod method);
+
+            void event(const core::network::event::TransmitBufferEmptyEvent& event) override;
+
+            void event(const core::network::event::DataAvailableEvent<HTTPProtocol>& event) override;
+
+            void event(const core::network::event::ConnectionStatusEvent& event) override;
+
+            void reply(std::unique_ptr<IResponseOperation> response, bool place_first) override;
+
+            void reply_error(std::unique_ptr<IResponseOperation> response) override;
+
+        protected:
+            core::Task& get_task() override;
+
+            void upgrade_to_websocket_internal() override;
+
+        private:
+            enum class State
+            {
+                Closed,
+                Connecting,
+                Connected
+            };
+
+            void receive(HTTPPacket& packet);
+
+            void connection_lost();
+
+            HTTPClient& client;
+            const std::string host_key;
+            std::shared_ptr<core::network::InetAddress> address;
+            std::shared_ptr<core::network::BufferContainer<HTTPProtocol>> buff;
+            std::shared_ptr<core::network::Socket<HTTPProtocol>> socket{};
+            std::deque<HTTPClientRequest> in_flight{};
+            State state{ State::Closed };
+            regular::ResponseCode current_code{};
+
+            // Set when the server has announced that it will close the connection after the current response.
+            bool closing{ false };
+
+            // Set once any part of the response to the first request in flight has been received.
+            bool receiving{ false };
+
+            // Set when the content of the current response ends when the server closes the connection.
+            bool until_close{ false };
+    };
+}
@@ -0,0 +1,110 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "smooth/application/network/http/regular/HeaderFields.h"
+#include "smooth/application/network/http/regular/ResponseCodes.h"
+
+namespace smooth::application::network::http
+{
+    /// Part of the response to a request made via the HTTPClient. Large responses are delivered
+    /// in several parts, each holding at most content_chunk_size bytes of the body.
+    class HTTPClientResponse
+    {
+        public:
+            HTTPClientResponse() = default;
+
+            HTTPClientResponse(const HTTPClientResponse&) = default;
+
+            HTTPClientResponse& operator=(const HTTPClientResponse&) = default;
+
+            HTTPClientResponse(uint32_t request_id,
+                               regular::ResponseCode code,
+                               regular::HeaderFields headers,
+                               std::vector<uint8_t> content,
+                               bool first_part,
+                               bool last_part)
+                    : request_id(request_id),
+                      code(code),
+                      headers(std::move(headers)),
+                      content(std::move(content)),
+                      first_part(first_part),
+                      last_part(last_part)
+            {
+            }
+
+            /// Creates a response reporting that the request failed, i.e. no (further) response will be received.
+            static HTTPClientResponse failure(uint32_t request_id)
+            {
+                HTTPClientResponse res{ request_id, regular::ResponseCode{}, {}, {}, true, true };
+                res.failed = true;
+
+                return res;
+            }
+
+            /// The id returned by HTTPClient::request() for the request this is the response to.
+            [[nodiscard]] uint32_t get_request_id() const
+            {
+                return request_id;
+            }
+
+            /// true if the request could not be completed, such as when the connection could not
+            /// be established or was lost. This is always the last event for the request.
+            [[nodiscard]] bool is_failure() const
+            {
+                return failed;
+            }
+
+            [[nodiscard]] regular::ResponseCode get_response_code() const
+            {
+                return code;
+            }
+
+            /// The response headers, only set on the first part.
+            [[nodiscard]] const regular::HeaderFields& get_headers() const
+            {
+                return headers;
+            }
+
+            [[nodiscard]] const std::vector<uint8_t>& get_content() const
+            {
+                return content;
+            }
+
+            [[nodiscard]] bool is_first_part() const
+            {
+                return first_part;
+            }
+
+            [[nodiscard]] bool is_last_part() const
+            {
+                return last_part;
+            }
+
+        private:
+            uint32_t request_id{ 0 };
+            regular::ResponseCode code{};
+            regular::HeaderFields headers{};
+            std::vector<uint8_t> content{};
+            bool first_part{ false };
+            bool last_part{ false };
+            bool failed{ false };
+    };
+}
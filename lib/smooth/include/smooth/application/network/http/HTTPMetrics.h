@@ -0,0 +1,100 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "smooth/application/network/http/regular/RequestRecord.h"
+
+namespace smooth::application::network::http
+{
+    /// Options for the request metrics and access log of HTTPServer.
+    struct MetricsOptions
+    {
+        /// Number of routes counted separately, in the order they are added. Later routes share one set of counters.
+        std::size_t max_routes{ 16 };
+
+        /// Number of requests kept in the access log, see HTTPAccessLog. 0 disables the access log.
+        std::size_t access_log_size{ 32 };
+    };
+
+    /// Per route and method counters of the requests handled by a server: number of requests, status classes,
+    /// latency histogram and bytes in/out. The counters are allocated up front and updated with relaxed atomic
+    /// operations, so recording a request takes no lock and the counters may be read from any task.
+    class HTTPMetrics
+    {
+        public:
+            /// Upper limits, in milliseconds, of the buckets of the latency histogram. A last bucket counts the rest.
+            static constexpr std::array<uint32_t, 12> LatencyLimits{ 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000,
+                                                                     5000 };
+            static constexpr std::size_t LatencyBuckets = LatencyLimits.size() + 1;
+
+            /// 1xx to 5xx
+            static constexpr std::size_t StatusClasses = 5;
+
+            /// Route id of the counters shared by the routes beyond MetricsOptions::max_routes.
+            static constexpr std::size_t OtherRoutes = regular::RequestRecord::NoRoute - 1;
+
+            /// A copy of the counters of a route and method.
+            struct Counts
+            {
+                /// The route id, RequestRecord::NoRoute or OtherRoutes.
+                std::size_t route{ regular::RequestRecord::NoRoute };
+                regular::HTTPMethod method{ regular::HTTPMethod::GET };
+                uint32_t requests{ 0 };
+                std::array<uint32_t, StatusClasses> status_classes{};
+                std::array<uint32_t, LatencyBuckets> latency{};
+                uint64_t bytes_in{ 0 };
+                uint64_t bytes_out{ 0 };
+            };
+
+            explicit HTTPMetrics(std::size_t max_routes);
+
+            /// Counts a completed request.
+            /// \param record The request
+            /// \param latency Time from the first byte of the request to the last byte of the response.
+            void record(const regular::RequestRecord& record, std::chrono::microseconds latency);
+
+            /// \return The counters of the routes and methods that have received requests.
+            [[nodiscard]] std::vector<Counts> get_counts() const;
+
+        private:
+            static constexpr std::size_t MethodCount = static_cast<std::size_t>(regular::HTTPMethod::POST) + 1;
+
+            struct Counters
+            {
+                std::atomic<uint32_t> requests{ 0 };
+                std::array<std::atomic<uint32_t>, StatusClasses> status_classes{};
+                std::array<std::atomic<uint32_t>, LatencyBuckets> latency{};
+                std::atomic<uint64_t> bytes_in{ 0 };
+                std::atomic<uint64_t> bytes_out{ 0 };
+            };
+
+            // Routes are counted in slots; the first one is for requests without a route
+            // and the last one for the routes beyond max_routes.
+            [[nodiscard]] std::size_t slot_of(std::size_t route) const;
+
+            [[nodiscard]] std::size_t route_of(std::size_t slot) const;
+
+            const std::size_t max_routes;
+            std::vector<Counters> counters;
+    };
+}
@@ -18,12 +18,17 @@ limitations under the License.
 #pragma once
 
 #include <algorithm>
+#include <chrono>
+#include <initializer_list>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include "smooth/core/network/IPacketDisassembly.h"
+#include "smooth/core/network/FileRegion.h"
 #include "smooth/application/network/http/regular/ResponseCodes.h"
 #include "regular/HTTPMethod.h"
+#include "regular/HeaderFields.h"
 #include "websocket/OpCode.h"
 
 namespace smooth::application::network::http
@@ -71,6 +76,17 @@ namespace smooth::application::network::http
                 return content;
             }
 
+            const smooth::core::network::FileRegion* get_file_region() override
+            {
+                return file_region.is_empty() ? nullptr : &file_region;
+            }
+
+            /// Sets a part of a file to be sent straight from the file, following the packet's content.
+            void set_file_region(smooth::core::network::FileRegion region)
+            {
+                file_region = std::move(region);
+            }
+
             void set_continued()
             {
                 continued = true;
@@ -98,9 +114,10 @@ namespace smooth::application::network::http
                 request_version = version;
             }
 
-            void set_response_data(regular::ResponseCode code)
+            void set_response_data(regular::ResponseCode code, const std::string& version)
             {
                 resp_code = code;
+                resp_version = version;
             }
 
             regular::ResponseCode response_code() const
@@ -108,6 +125,29 @@ namespace smooth::application::network::http
                 return resp_code;
             }
 
+            /// The HTTP version of a received response, e.g. "1.1"; empty for requests.
+            const std::string& response_version() const
+            {
+                return resp_version;
+            }
+
+            /// Sets when the first byte of the message was received and the size of its headers.
+            void set_message_start(std::chrono::steady_clock::time_point start, std::size_t header_size)
+            {
+                message_start = start;
+                message_header_size = header_size;
+            }
+
+            std::chrono::steady_clock::time_point get_message_start() const
+            {
+                return message_start;
+            }
+
+            std::size_t get_message_header_size() const
+            {
+                return message_header_size;
+            }
+
             const std::string& get_request_url() const
             {
                 return request_url;
@@ -134,7 +174,7 @@ namespace smooth::application::network::http
                                                         + static_cast<decltype(content.size())>(additional_space)));
             }
 
-            std::unordered_map<std::string, std::string>& headers()
+            regular::HeaderFields& headers()
             {
                 return request_headers;
             }
@@ -144,13 +184,6 @@ namespace smooth::application::network::http
                 content.clear();
             }
 
-            auto find_header_ending() const
-            {
-                const auto end = std::search(content.cbegin(), content.cend(), ending.cbegin(), ending.cend());
-
-                return end;
-            }
-
             void set_ws_control_code(websocket::OpCode code)
             {
                 ws_opcode = code;
@@ -161,18 +194,23 @@ namespace smooth::application::network::http
                 return ws_opcode;
             }
 
-            static constexpr std::array<uint8_t, 4> ending{ '\r', '\n', '\r', '\n' };
         private:
-            void append(const std::string& s);
-
-            void add_header(const std::string& key, const std::string& value);
+            /// Writes the start line, the headers and the content in a single pass into a buffer sized up front.
+            void write_message(std::initializer_list<std::string_view> start_line,
+                               const std::unordered_map<std::string, std::string>& new_headers,
+                               bool add_date,
+                               const std::vector<uint8_t>& message_content);
 
-            std::unordered_map<std::string, std::string> request_headers{};
+            regular::HeaderFields request_headers{};
             std::string request_method{};
             std::string request_url{};
             std::string request_version{};
             std::vector<uint8_t> content{};
+            smooth::core::network::FileRegion file_region{};
             regular::ResponseCode resp_code{};
+            std::string resp_version{};
+            std::chrono::steady_clock::time_point message_start{};
+            std::size_t message_header_size{ 0 };
             bool continuation = false;
             bool continued = false;
             websocket::OpCode ws_opcode{ websocket::OpCode::Continuation };
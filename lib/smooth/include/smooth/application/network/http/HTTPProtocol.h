@@ -20,6 +20,7 @@ limitations under the License.
 #include <cstdint>
 #include <regex>
 #include <memory>
+#include <vector>
 #include "smooth/core/logging/log.h"
 #include "smooth/core/network/IPacketDisassembly.h"
 #include "smooth/core/network/IPacketAssembly.h"
@@ -69,13 +70,25 @@ namespace smooth::application::network::http
 
             void reset() override;
 
+            int get_buffered_amount() const override;
+
+            int take_buffered(uint8_t* target, int length) override;
+
             void upgrade_to_websocket() override;
 
+            /// Switches to the websocket protocol, which assembles \p leftover before anything read later.
+            void upgrade_to_websocket(std::vector<uint8_t> leftover);
+
+            /// Removes and returns all data received but not yet assembled.
+            std::vector<uint8_t> take_all_buffered();
+
         private:
             const int max_header_size;
             const int content_chunk_size;
             IServerResponse& response;
             std::unique_ptr<RegularHTTPProtocol> regular{};
             std::unique_ptr<websocket::WebsocketProtocol> websocket{};
+            // Data received after the upgrade request, before switching to the websocket protocol.
+            std::vector<uint8_t> buffered{};
     };
 }
@@ -39,10 +39,15 @@ limitations under the License.
 #include "smooth/application/network/http/HTTPServerClient.h"
 #include "smooth/application/network/http/regular/responses/ErrorResponse.h"
 #include "smooth/application/network/http/regular/responses/FileContentResponse.h"
+#include "smooth/application/network/http/regular/responses/HeaderOnlyResponse.h"
 #include "smooth/application/network/http/regular/TemplateProcessor.h"
+#include "smooth/application/network/http/regular/StaticAssetCache.h"
 #include "smooth/application/hash/sha.h"
 #include "regular/RequestHandlerSignature.h"
+#include "regular/Router.h"
 #include "HTTPServerConfig.h"
+#include "HTTPAccessLog.h"
+#include "HTTPMetrics.h"
 
 namespace smooth::application::network::http
 {
@@ -64,6 +69,7 @@ namespace smooth::application::network::http
                                             config.chunk_size(),
                                             config.max_responses());
                 server->set_client_context(this);
+                server->set_socket_options(config.socket_options());
                 server->start(std::move(bind_to));
             }
 
@@ -87,58 +93,94 @@ namespace smooth::application::network::http
                                             config.max_responses());
 
                 server->set_client_context(this);
+                server->set_socket_options(config.socket_options());
                 server->start(std::move(bind_to));
             }
 
+            /// Registers a handler for the given method and URL.
+            /// The URL may contain ":name" and "*name" segments, see Router.
             void on(HTTPMethod method, const std::string& url,
                     const RequestHandlerSignature& handler);
 
+            /// Registers a handler which receives the values captured by the URL's ":name" and "*name" segments,
+            /// e.g. "/api/users/:id".
+            void on(HTTPMethod method, const std::string& url,
+                    const RouteHandlerSignature& handler);
+
             template<typename WServerType>
             void enable_websocket_on(const std::string& url);
 
-        private:
-            using HandlerByURL = std::unordered_map<std::string, RequestHandlerSignature>;
-            using HandlerByMethod = std::unordered_map<HTTPMethod, HandlerByURL>;
+            /// Compresses a response as configured by HTTPServerConfig, e.g. the output of a request handler,
+            /// provided compression is enabled, the response is eligible and the client accepts it.
+            /// \return The compressed response, or the response as is.
+            std::unique_ptr<IResponseOperation> compress(std::unique_ptr<IResponseOperation> response,
+                                                         const HeaderFields& request_headers) const;
+
+            /// \return The request counters of each route and method, empty unless enabled by HTTPServerConfig.
+            [[nodiscard]] std::vector<HTTPMetrics::Counts> get_metrics() const;
+
+            /// \return A copy of the access log, oldest first, empty unless enabled by HTTPServerConfig.
+            [[nodiscard]] std::vector<HTTPAccessLog::Entry> get_access_log() const;
 
+            /// Writes the access log at info level, one line per request.
+            void dump_access_log() const;
+
+            /// \return The route that a route id of the metrics or access log refers to, e.g. "/api/users/:id".
+            [[nodiscard]] std::string get_route_name(std::size_t route) const;
+
+        private:
             void handle(HTTPMethod method,
                         IServerResponse& response,
                         IConnectionTimeoutModifier& timeout_modifier,
                         const std::string& requested_url,
-                        const std::unordered_map<std::string, std::string>& request_headers,
-                        const std::unordered_map<std::string, std::string>& request_parameters,
+                        const HeaderFields& request_headers,
+                        const QueryParameters& request_parameters,
                         const std::vector<uint8_t>& data,
                         MIMEParser& mime,
                         bool fist_part,
                         bool last_part) override;
 
+            void request_completed(const RequestRecord& record) override;
+
             template<typename WSServerType>
             void websocket_upgrade_detector(IServerResponse& response,
                                             IConnectionTimeoutModifier& timeout_modifier,
                                             const std::string& url,
                                             bool first_part,
                                             bool last_part,
-                                            const std::unordered_map<std::string, std::string>& headers,
-                                            const std::unordered_map<std::string, std::string>& request_parameters,
+                                            const HeaderFields& headers,
+                                            const QueryParameters& request_parameters,
                                             const std::vector<uint8_t>& content,
                                             MIMEParser& mime);
 
             smooth::core::filesystem::Path find_index(const smooth::core::filesystem::Path& search_path) const;
 
-            void
-            reply_with(IServerResponse& response, std::unique_ptr<IResponseOperation> res);
-
             void serve_file(const HTTPMethod& method, IServerResponse& response, const std::string& requested_url,
-                            const std::unordered_map<std::string, std::string>& request_headers);
+                            const HeaderFields& request_headers);
+
+            std::unique_ptr<IResponseOperation> serve_regular_file(const HTTPMethod& method,
+                                                                   smooth::core::filesystem::FileInfo& info,
+                                                                   const HeaderFields& request_headers);
+
+            /// Creates the response to a HEAD request for a file, without reading or opening it.
+            std::unique_ptr<IResponseOperation> serve_head(const smooth::core::filesystem::FileInfo& info,
+                                                           const HeaderFields& request_headers);
+
+            static bool is_not_modified(const smooth::core::filesystem::FileInfo& info,
+                                        const HeaderFields& request_headers);
 
             smooth::core::Task& task;
             std::shared_ptr<smooth::core::network::ServerSocket<
                                 smooth::application::network::http::HTTPServerClient,
                                 smooth::application::network::http::HTTPProtocol, IRequestHandler>> server{};
 
-            HandlerByMethod handlers{};
+            Router router{};
             HTTPServerConfig config;
             const char* tag = "HTTPServer";
             TemplateProcessor template_processor;
+            StaticAssetCache asset_cache;
+            std::unique_ptr<HTTPMetrics> metrics{};
+            std::unique_ptr<HTTPAccessLog> access_log{};
     };
 
     template<typename ServerSocketType>
@@ -146,8 +188,18 @@ namespace smooth::application::network::http
             :
               task(task),
               config(configuration),
-              template_processor(configuration.templates(), config.data_retriever())
+              template_processor(configuration.templates(), config.data_retriever()),
+              asset_cache(configuration.asset_cache_size())
     {
+        if (config.metrics())
+        {
+            metrics = std::make_unique<HTTPMetrics>(config.metrics()->max_routes);
+
+            if (config.metrics()->access_log_size > 0)
+            {
+                access_log = std::make_unique<HTTPAccessLog>(config.metrics()->access_log_size);
+            }
+        }
     }
 
     template<typename ServerType>
@@ -155,7 +207,37 @@ namespace smooth::application::network::http
                                     const std::string& url,
                                     const RequestHandlerSignature& handler)
     {
-        handlers[method][url] = handler;
+        on(method, url, [handler](IServerResponse& response,
+                                  IConnectionTimeoutModifier& timeout_modifier,
+                                  const std::string& requested_url,
+                                  bool first_part,
+                                  bool last_part,
+                                  const HeaderFields& headers,
+                                  const QueryParameters& request_parameters,
+                                  const RouteParameters& /*route_parameters*/,
+                                  const std::vector<uint8_t>& content,
+                                  MIMEParser& mime) {
+               handler(response,
+                       timeout_modifier,
+                       requested_url,
+                       first_part,
+                       last_part,
+                       headers.as_map(),
+                       request_parameters.as_map(),
+                       content,
+                       mime);
+           });
+    }
+
+    template<typename ServerType>
+    void HTTPServer<ServerType>::on(HTTPMethod method,
+                                    const std::string& url,
+                                    const RouteHandlerSignature& handler)
+    {
+        if (!router.add(method, url, handler))
+        {
+            Log::error(tag, "Invalid route: {}", url);
+        }
     }
 
     template<typename ServerType>
@@ -164,8 +246,8 @@ namespace smooth::application::network::http
         IServerResponse& response,
         IConnectionTimeoutModifier& timeout_modifier,
         const std::string& requested_url,
-        const std::unordered_map<std::string, std::string>& request_headers,
-        const std::unordered_map<std::string, std::string>& request_parameters,
+        const HeaderFields& request_headers,
+        const QueryParameters& request_parameters,
         const std::vector<uint8_t>& data,
         MIMEParser& mime,
         bool fist_part,
@@ -173,35 +255,28 @@ namespace smooth::application::network::http
     {
         using namespace smooth::core::logging;
 
-        // Is there a URL for the given method?
-        auto by_url = handlers.find(method);
+        // Is there a handler for this URL and method?
+        RouteParameters route_parameters{};
+        std::size_t route{};
+        const auto* response_handler = router.find(method, requested_url, route_parameters, route);
 
-        if (by_url != handlers.end())
+        if (response_handler)
         {
-            // Is there a specific handler for this URL?
-            auto response_handler = (*by_url).second.find(requested_url);
-
-            if (response_handler == (*by_url).second.end())
-            {
-                // No handler for this URL, does it match a file path beneath the web root?
-                serve_file(method, response, requested_url, request_headers);
-            }
-            else
-            {
-                (*response_handler).second(response,
-                                           timeout_modifier,
-                                           requested_url,
-                                           fist_part,
-                                           last_part,
-                                           request_headers,
-                                           request_parameters,
-                                           data,
-                                           mime);
-            }
+            response.set_route(route);
+            (*response_handler)(response,
+                                timeout_modifier,
+                                requested_url,
+                                fist_part,
+                                last_part,
+                                request_headers,
+                                request_parameters,
+                                route_parameters,
+                                data,
+                                mime);
         }
         else
         {
-            // No specific handler for this URL.
+            // No handler for this URL, does it match a file path beneath the web root?
             serve_file(method, response, requested_url, request_headers);
         }
     }
@@ -210,11 +285,14 @@ namespace smooth::application::network::http
     void HTTPServer<ServerType>::serve_file(const HTTPMethod& method,
                                             IServerResponse& response,
                                             const std::string& requested_url,
-                                            const std::unordered_map<std::string, std::string>& request_headers)
+                                            const HeaderFields& request_headers)
     {
-        auto found = false;
+        std::unique_ptr<IResponseOperation> res{};
 
-        Log::info(tag, "Request: {}: '{}'", utils::http_method_to_string(method), requested_url);
+        if (config.request_logging())
+        {
+            Log::info(tag, "Request: {}: '{}'", utils::http_method_to_string(method), requested_url);
+        }
 
         filesystem::Path search{ config.web_root() };
         search /= requested_url;
@@ -223,70 +301,186 @@ namespace smooth::application::network::http
         {
             filesystem::FileInfo info(search);
 
-            if (info.is_regular_file())
+            if (info.is_regular_file() && method == HTTPMethod::HEAD)
+            {
+                res = serve_head(info, request_headers);
+            }
+            else if (info.is_regular_file())
             {
                 // Attempt to process the file as a template.
-                auto processed_template = template_processor.process_template(info.path());
+                res = template_processor.process_template(info.path());
 
-                if (processed_template)
+                if (res)
                 {
-                    reply_with(response, std::move(processed_template));
+                    res = compress(std::move(res), request_headers);
                 }
                 else
                 {
                     // Not a template, simply serve the requested file
-                    bool send_not_modified = false;
-                    auto if_modified_since = request_headers.find("if-modified-since");
-
-                    if (if_modified_since != request_headers.end())
-                    {
-                        auto since = utils::parse_http_time((*if_modified_since).second);
-
-                        if (since >= info.last_modified_point())
-                        {
-                            send_not_modified = true;
-                        }
-                    }
-
-                    if (send_not_modified)
-                    {
-                        reply_with(response,
-                                   std::make_unique<responses::ErrorResponse>(ResponseCode::Not_Modified));
-                    }
-                    else
-                    {
-                        reply_with(response, std::make_unique<responses::FileContentResponse>(search));
-                    }
+                    res = serve_regular_file(method, info, request_headers);
                 }
-
-                found = true;
             }
             else if (info.is_directory())
             {
                 auto index_path = find_index(search);
 
-                if (!index_path.empty())
+                if (!index_path.empty() && method == HTTPMethod::HEAD)
                 {
-                    auto processed_template = template_processor.process_template(index_path);
+                    filesystem::FileInfo index_info(index_path);
+                    res = serve_head(index_info, request_headers);
+                }
+                else if (!index_path.empty())
+                {
+                    res = template_processor.process_template(index_path);
 
-                    if (processed_template)
+                    if (res)
                     {
-                        reply_with(response, std::move(processed_template));
+                        res = compress(std::move(res), request_headers);
                     }
                     else
                     {
-                        reply_with(response, std::make_unique<responses::FileContentResponse>(index_path));
+                        filesystem::FileInfo index_info(index_path);
+                        res = serve_regular_file(method, index_info, request_headers);
                     }
-
-                    found = true;
                 }
             }
         }
 
-        if (!found)
+        if (!res)
+        {
+            res = std::make_unique<responses::ErrorResponse>(ResponseCode::Not_Found);
+        }
+
+        if (method == HTTPMethod::HEAD)
         {
-            reply_with(response, std::make_unique<responses::ErrorResponse>(ResponseCode::Not_Found));
+            // Files are answered by serve_head(); anything else, e.g. errors, gets the same headers as for a GET.
+            auto head = std::make_unique<responses::HeaderOnlyResponse>(res->get_response_code());
+
+            for (const auto& header : res->get_headers())
+            {
+                head->set_header(header.first, header.second);
+            }
+
+            res = std::move(head);
         }
+
+        response.reply(std::move(res), false);
+    }
+
+    template<typename ServerType>
+    std::unique_ptr<IResponseOperation> HTTPServer<ServerType>::serve_regular_file(
+        const HTTPMethod& method,
+        smooth::core::filesystem::FileInfo& info,
+        const HeaderFields& request_headers)
+    {
+        std::unique_ptr<IResponseOperation> res{};
+
+        // Ranges only apply to GET and, when conditional, as long as the file is unchanged. Only
+        // Last-Modified dates are used as validators; files are not served with an ETag to compare with.
+        // https://tools.ietf.org/html/rfc7233#section-3
+        const auto range = request_headers.get(RANGE);
+        const auto if_range = request_headers.get(IF_RANGE);
+        std::vector<utils::ByteRange> ranges{};
+
+        const auto ranged = method == HTTPMethod::GET
+                            && !range.empty()
+                            && (if_range.empty() || if_range == utils::make_http_time(info.last_modified()))
+                            && utils::parse_byte_ranges(range, info.size(), ranges);
+
+        if (!ranged)
+        {
+            res = asset_cache.get_response(info, request_headers);
+        }
+
+        if (!res)
+        {
+            if (is_not_modified(info, request_headers))
+            {
+                res = std::make_unique<responses::ErrorResponse>(ResponseCode::Not_Modified);
+            }
+            else if (!ranged)
+            {
+                res = std::make_unique<responses::FileContentResponse>(info.path());
+            }
+            else if (ranges.empty())
+            {
+                res = std::make_unique<responses::ErrorResponse>(ResponseCode::Requested_Range_Not_Satisfiable);
+                res->set_header(CONTENT_RANGE, "bytes */" + std::to_string(info.size()));
+            }
+            else
+            {
+                res = std::make_unique<responses::FileContentResponse>(info, ranges);
+            }
+        }
+
+        return res;
+    }
+
+    template<typename ServerType>
+    std::unique_ptr<IResponseOperation> HTTPServer<ServerType>::serve_head(
+        const smooth::core::filesystem::FileInfo& info,
+        const HeaderFields& request_headers)
+    {
+        std::unique_ptr<IResponseOperation> res{};
+
+        if (template_processor.is_template(info.path()))
+        {
+            // The length of a rendered template depends on the data at the time of a GET, and isn't
+            // worth rendering the page for.
+            res = std::make_unique<responses::HeaderOnlyResponse>(ResponseCode::OK);
+            res->set_header(CONTENT_TYPE, "text/html");
+        }
+        else
+        {
+            // Files not already cached are not loaded into the cache just for their headers.
+            res = asset_cache.get_response(info, request_headers, false);
+
+            if (!res && is_not_modified(info, request_headers))
+            {
+                res = std::make_unique<responses::HeaderOnlyResponse>(ResponseCode::Not_Modified);
+            }
+            else if (!res)
+            {
+                // The headers of a FileContentResponse, from what is already known about the file.
+                res = std::make_unique<responses::HeaderOnlyResponse>(ResponseCode::OK);
+                res->set_header(CONTENT_TYPE, utils::get_content_type(info.path()));
+                res->set_header(CONTENT_LENGTH, std::to_string(info.size()));
+                res->set_header(ACCEPT_RANGES, "bytes");
+                res->set_header(LAST_MODIFIED, utils::make_http_time(info.last_modified()));
+            }
+        }
+
+        return res;
+    }
+
+    template<typename ServerType>
+    bool HTTPServer<ServerType>::is_not_modified(const smooth::core::filesystem::FileInfo& info,
+                                                 const HeaderFields& request_headers)
+    {
+        auto res = false;
+        auto if_modified_since = request_headers.get(IF_MODIFIED_SINCE);
+
+        if (!if_modified_since.empty())
+        {
+            auto since = utils::parse_http_time(std::string{ if_modified_since });
+            res = since >= info.last_modified_point();
+        }
+
+        return res;
+    }
+
+    template<typename ServerType>
+    std::unique_ptr<IResponseOperation> HTTPServer<ServerType>::compress(std::unique_ptr<IResponseOperation> response,
+                                                                         const HeaderFields& request_headers) const
+    {
+        auto res = std::move(response);
+
+        if (config.compression())
+        {
+            res = responses::CompressedResponse::compress(std::move(res), request_headers, *config.compression());
+        }
+
+        return res;
     }
 
     template<typename ServerType>
@@ -314,11 +508,79 @@ namespace smooth::application::network::http
     }
 
     template<typename ServerType>
-    void HTTPServer<ServerType>::reply_with(IServerResponse& response,
-                                            std::unique_ptr<IResponseOperation> res)
+    void HTTPServer<ServerType>::request_completed(const RequestRecord& record)
     {
-        Log::info(tag, "Reply: {}", response_code_to_text.at(res->get_response_code()));
-        response.reply(std::move(res), false);
+        using namespace std::chrono;
+        const auto latency = duration_cast<microseconds>(steady_clock::now() - record.start);
+
+        if (metrics)
+        {
+            metrics->record(record, latency);
+        }
+
+        if (access_log)
+        {
+            access_log->add(record, latency, system_clock::now());
+        }
+
+        if (config.request_logging())
+        {
+            const auto text = response_code_to_text.find(record.code);
+
+            Log::info(tag, "Reply: {} {} ({} us, {} bytes)",
+                      static_cast<int>(record.code),
+                      text == response_code_to_text.end() ? "" : text->second,
+                      latency.count(), record.bytes_out);
+        }
+    }
+
+    template<typename ServerType>
+    std::vector<HTTPMetrics::Counts> HTTPServer<ServerType>::get_metrics() const
+    {
+        return metrics ? metrics->get_counts() : std::vector<HTTPMetrics::Counts>{};
+    }
+
+    template<typename ServerType>
+    std::vector<HTTPAccessLog::Entry> HTTPServer<ServerType>::get_access_log() const
+    {
+        return access_log ? access_log->get_entries() : std::vector<HTTPAccessLog::Entry>{};
+    }
+
+    template<typename ServerType>
+    void HTTPServer<ServerType>::dump_access_log() const
+    {
+        for (const auto& e : get_access_log())
+        {
+            Log::info(tag, "{} {} {} {}: {} us, {}/{} bytes in/out",
+                      e.time,
+                      utils::http_method_to_string(static_cast<HTTPMethod>(e.method)),
+                      get_route_name(e.route),
+                      e.status,
+                      e.latency_us,
+                      e.bytes_in,
+                      e.bytes_out);
+        }
+    }
+
+    template<typename ServerType>
+    std::string HTTPServer<ServerType>::get_route_name(std::size_t route) const
+    {
+        std::string res;
+
+        if (route < router.get_route_count())
+        {
+            res = router.get_route(route);
+        }
+        else if (route == HTTPMetrics::OtherRoutes)
+        {
+            res = "(other routes)";
+        }
+        else
+        {
+            res = "(no route)";
+        }
+
+        return res;
     }
 
     template<typename ServerType>
@@ -329,8 +591,9 @@ namespace smooth::application::network::http
                      IConnectionTimeoutModifier& timeout_modifier,
                      const std::string& url, bool first_part,
                      bool last_part,
-                     const std::unordered_map<std::string, std::string>& headers,
-                     const std::unordered_map<std::string, std::string>& request_parameters,
+                     const HeaderFields& headers,
+                     const QueryParameters& request_parameters,
+                     const RouteParameters& /*route_parameters*/,
                      const std::vector<uint8_t>& content, MIMEParser& mime) {
                      websocket_upgrade_detector<WSServerType>(response,
                                                      timeout_modifier,
@@ -343,7 +606,7 @@ namespace smooth::application::network::http
                                                      mime);
                  };
 
-        on(HTTPMethod::GET, url, f);
+        on(HTTPMethod::GET, url, RouteHandlerSignature{ f });
     }
 
     template<typename ServerType>
@@ -353,9 +616,8 @@ namespace smooth::application::network::http
                                                             const std::string& url,
                                                             bool first_part,
                                                             bool last_part,
-                                                            const std::unordered_map<std::string, std::string>& headers,
-                                                            const std::unordered_map<std::string,
-                                                                                     std::string>& request_parameters,
+                                                            const HeaderFields& headers,
+                                                            const QueryParameters& request_parameters,
                                                             const std::vector<uint8_t>& content,
                                                             MIMEParser& mime)
     {
@@ -372,15 +634,15 @@ namespace smooth::application::network::http
 
             try
             {
-                const auto& upgrade = headers.at(UPGRADE);
-                const auto& connection = headers.at(CONNECTION);
-                const auto version = headers.at(SEC_WEBSOCKET_VERSION);
+                const std::string upgrade{ headers.get(UPGRADE) };
+                const std::string connection{ headers.get(CONNECTION) };
+                const std::string version{ headers.get(SEC_WEBSOCKET_VERSION) };
 
                 if (string_util::iequals(upgrade, "websocket")
                     && string_util::icontains(connection, "upgrade")
                     && string_util::equals(version, "13"))
                 {
-                    const auto& key = headers.at(SEC_WEBSOCKET_KEY);
+                    const std::string key{ headers.get(SEC_WEBSOCKET_KEY) };
                     const char* websocket_key_constant = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
 
                     const auto concat = string_util::trim(key) + websocket_key_constant;
@@ -20,6 +20,8 @@ limitations under the License.
 #include <iostream>
 #include <fstream>
 #include <deque>
+#include <optional>
+#include <utility>
 #include "smooth/core/network/ServerClient.h"
 #include "smooth/application/network/http/HTTPProtocol.h"
 #include "smooth/application/network/http/regular/responses/StringResponse.h"
@@ -89,6 +91,8 @@ namespace smooth::application::network::http
 
             void reply_error(std::unique_ptr<IResponseOperation> response) override;
 
+            void set_route(std::size_t route) override;
+
             void set_receive_timeout(const std::chrono::milliseconds& timeout) override
             {
                 socket->set_receive_timeout(timeout);
@@ -102,9 +106,12 @@ namespace smooth::application::network::http
 
             void upgrade_to_websocket_internal() override
             {
-                // Don't clear TX buffer - the upgrade response is being sent.
+                // Don't clear TX buffer - the upgrade response is being sent. Clearing the RX buffer resets
+                // the protocol, so take the data received after the upgrade request first.
+                auto& protocol = container->get_protocol();
+                auto leftover = protocol.take_all_buffered();
                 container->get_rx_buffer().clear();
-                container->get_protocol().upgrade_to_websocket();
+                protocol.upgrade_to_websocket(std::move(leftover));
                 mode = Mode::Websocket;
             }
 
@@ -123,19 +130,36 @@ namespace smooth::application::network::http
 
             void send_first_part();
 
+            void add_bytes_out(std::size_t count);
+
+            void complete_request();
+
             bool translate_method(const HTTPPacket& packet, HTTPMethod& method) const;
 
             const std::size_t content_chunk_size;
             smooth::core::Task& task;
-            std::unordered_map<std::string, std::string> request_parameters{};
-            std::unordered_map<std::string, std::string> request_headers{};
+            QueryParameters request_parameters{};
+            HeaderFields request_headers{};
             std::string requested_url{};
             URLEncoding encoding{};
             std::deque<std::unique_ptr<IResponseOperation>> operations{};
             std::unique_ptr<IResponseOperation> current_operation{};
+
+            // The request being received, until its response is enqueued. The records of the enqueued
+            // responses are kept alongside the operations, to be reported once the responses are sent.
+            std::optional<RequestRecord> current_request{};
+            std::deque<std::optional<RequestRecord>> operation_records{};
+            std::optional<RequestRecord> current_record{};
             MIMEParser mime{};
             const std::size_t max_enqueued_responses;
 
             void set_keep_alive();
+
+            void update_idle_state();
+
+            bool request_in_progress{ false };
+
+            // Set while sending a response with "Connection: close"; the connection is closed once it is sent.
+            bool close_when_sent{ false };
     };
 }
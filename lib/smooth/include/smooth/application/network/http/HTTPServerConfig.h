@@ -1,7 +1,11 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
+#include "smooth/core/network/SocketOptions.h"
+#include "smooth/application/network/http/HTTPMetrics.h"
+#include "smooth/application/network/http/regular/responses/CompressedResponse.h"
 
 namespace smooth::application::network::http
 {
@@ -33,20 +37,40 @@ namespace smooth::application::network::http
             /// data). To prevent an out-of-memory situation when there is a steady stream of incoming data, and the
             /// device can't send out the responses fast enough, this threshold protects the device by closing the
             /// connection if it is reached.
+            /// \arg socket_options Tuning options for the server's sockets. Enable SocketOptions::cork to have
+            /// the headers and body of multi-packet responses coalesced into full segments.
+            /// \arg asset_cache_size Number of bytes of static files (and their precompressed .gz/.br siblings) to
+            /// keep in memory, see StaticAssetCache. 0 disables the cache, serving every file from the file system.
+            /// \arg response_compression When set, template output is compressed on the fly for clients accepting
+            /// gzip or deflate, as are the responses passed through HTTPServer::compress(). See CompressedResponse;
+            /// ignored unless CONFIG_SMOOTH_HTTP_COMPRESSION is set.
+            /// \arg request_metrics When set, requests are counted per route and method and the most recent ones
+            /// are kept in an access log, see HTTPServer::get_metrics() and HTTPServer::get_access_log().
+            /// \arg request_logging When true, each request for a file and each reply is logged at info level.
             HTTPServerConfig(smooth::core::filesystem::Path web_root,
                              std::vector<std::string> index_files,
                              std::set<std::string> template_files,
                              std::shared_ptr<ITemplateDataRetriever> template_data_retriever,
                              std::size_t max_header_size,
                              std::size_t content_chunk_size,
-                             std::size_t max_enqueued_responses)
+                             std::size_t max_enqueued_responses,
+                             smooth::core::network::SocketOptions socket_options = {},
+                             std::size_t asset_cache_size = 0,
+                             std::optional<regular::responses::CompressionOptions> response_compression = std::nullopt,
+                             std::optional<MetricsOptions> request_metrics = std::nullopt,
+                             bool request_logging = true)
                     : root_path(std::move(web_root)),
                       index(std::move(index_files)),
                       template_files(std::move(template_files)),
                       template_data_retriever(std::move(template_data_retriever)),
                       maximum_header_size(max_header_size),
                       content_chunk_size(content_chunk_size),
-                      max_enqueued_responses(max_enqueued_responses)
+                      max_enqueued_responses(max_enqueued_responses),
+                      options(socket_options),
+                      cache_size(asset_cache_size),
+                      compression_options(std::move(response_compression)),
+                      metrics_options(request_metrics),
+                      log_requests(request_logging)
             {
             }
 
@@ -85,6 +109,31 @@ namespace smooth::application::network::http
                 return max_enqueued_responses;
             }
 
+            [[nodiscard]] const smooth::core::network::SocketOptions& socket_options() const
+            {
+                return options;
+            }
+
+            [[nodiscard]] std::size_t asset_cache_size() const
+            {
+                return cache_size;
+            }
+
+            [[nodiscard]] const std::optional<regular::responses::CompressionOptions>& compression() const
+            {
+                return compression_options;
+            }
+
+            [[nodiscard]] const std::optional<MetricsOptions>& metrics() const
+            {
+                return metrics_options;
+            }
+
+            [[nodiscard]] bool request_logging() const
+            {
+                return log_requests;
+            }
+
         private:
             smooth::core::filesystem::Path root_path{};
             std::vector<std::string> index{};
@@ -93,5 +142,10 @@ namespace smooth::application::network::http
             std::size_t maximum_header_size{};
             std::size_t content_chunk_size{};
             std::size_t max_enqueued_responses{};
+            smooth::core::network::SocketOptions options{};
+            std::size_t cache_size{};
+            std::optional<regular::responses::CompressionOptions> compression_options{};
+            std::optional<MetricsOptions> metrics_options{};
+            bool log_requests{ true };
     };
 }
@@ -19,6 +19,7 @@ limitations under the License.
 
 #include <unordered_map>
 #include "smooth/core/network/BufferContainer.h"
+#include "smooth/core/network/FileRegion.h"
 #include "smooth/application/network/http/regular/ResponseCodes.h"
 
 namespace smooth::application::network::http
@@ -51,6 +52,23 @@ namespace smooth::application::network::http
             // Called at least once when sending a response and until ResponseStatus::AllSent is returned
             virtual ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) = 0;
 
+            /// Called before the first call to get_data(). A response whose entire content is (part of) a file
+            /// may return it here, to have it sent straight from the file instead of via get_data().
+            /// get_data() must then return ResponseStatus::NoData.
+            virtual bool get_file_region(smooth::core::network::FileRegion& /*region*/)
+            {
+                return false;
+            }
+
+            /// Called before the first call to get_data() when the client doesn't understand chunked transfer
+            /// coding, i.e. HTTP/1.0. A response using it must then send its body as is.
+            /// \return true if the response uses chunked transfer coding, in which case the connection is
+            /// closed to mark the end of the body.
+            virtual bool disable_chunked_coding()
+            {
+                return false;
+            }
+
             /// Sets a header, replacing any existing value
             virtual void set_header(const std::string& /*key*/, const std::string& /*value*/)
             {}
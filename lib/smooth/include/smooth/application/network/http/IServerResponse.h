@@ -32,6 +32,11 @@ namespace smooth::application::network::http
 
             virtual void reply_error(std::unique_ptr<IResponseOperation> response) = 0;
 
+            /// Tells which route handles the current request, for the request metrics. See Router::get_route().
+            virtual void set_route(std::size_t /*route*/)
+            {
+            }
+
             template<typename WSServerType>
             void upgrade_to_websocket()
             {
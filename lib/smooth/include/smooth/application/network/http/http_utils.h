@@ -18,16 +18,33 @@ limitations under the License.
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <chrono>
+#include <vector>
 #include "smooth/core/filesystem/Path.h"
 #include "regular/HTTPMethod.h"
 
 namespace smooth::application::network::http::utils
 {
+    /// A range of bytes of a representation, first and last inclusive.
+    struct ByteRange
+    {
+        std::size_t first;
+        std::size_t last;
+
+        [[nodiscard]] std::size_t length() const
+        {
+            return last - first + 1;
+        }
+    };
+
     std::string make_http_time(const std::chrono::system_clock::time_point& t);
 
     std::string make_http_time(const time_t& t);
 
+    /// Gets the current time formatted as a HTTP date, reformatted at most once per second.
+    const std::string& http_time_now();
+
     std::chrono::system_clock::time_point parse_http_time(const std::string& t);
 
     std::string get_content_type(const smooth::core::filesystem::Path& path);
@@ -35,4 +52,15 @@ namespace smooth::application::network::http::utils
     time_t timegm(tm& tm);
 
     std::string http_method_to_string(regular::HTTPMethod m);
+
+    /// Parses the value of a Range header, https://tools.ietf.org/html/rfc7233#section-3.1
+    /// \param value The header value, e.g. "bytes=0-499,-500".
+    /// \param size The size of the representation the ranges apply to.
+    /// \param ranges Receives the satisfiable ranges, clamped to the size, in the requested order.
+    /// \return false if the header is invalid, or asks for more than 16 ranges, and must be ignored.
+    /// Otherwise true, where an empty set of ranges means that none of them can be satisfied.
+    bool parse_byte_ranges(std::string_view value, std::size_t size, std::vector<ByteRange>& ranges);
+
+    /// Returns true if the value of an Accept-Encoding header allows the given content coding.
+    bool is_encoding_acceptable(const std::string& accept_encoding, const char* coding);
 }
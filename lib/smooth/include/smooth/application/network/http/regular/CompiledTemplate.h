@@ -0,0 +1,49 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <ctime>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace smooth::application::network::http::regular
+{
+    /// A template file split into literal text and tokens, see TemplateProcessor.
+    struct CompiledTemplate
+    {
+        /// Token index of segments holding literal text.
+        static constexpr std::size_t Literal = std::numeric_limits<std::size_t>::max();
+
+        struct Segment
+        {
+            /// Position of the segment in the text.
+            std::size_t offset;
+            std::size_t length;
+            /// Index into tokens, or Literal.
+            std::size_t token;
+        };
+
+        std::string text{};
+        std::vector<Segment> segments{};
+        /// The distinct tokens of the template, including the surrounding braces.
+        std::vector<std::string> tokens{};
+        time_t modified{};
+        std::size_t file_size{ 0 };
+    };
+}
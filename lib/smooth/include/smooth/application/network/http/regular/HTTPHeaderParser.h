@@ -0,0 +1,93 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace smooth::application::network::http::regular
+{
+    /// Incremental parser for the header block of an HTTP request or response.
+    /// Each call to parse() continues where the previous one left off, so data already looked at
+    /// is never scanned again. Nothing is copied; the start line and the header fields are recorded
+    /// as spans into the caller's buffer, which must therefore be kept intact until the headers are consumed.
+    class HTTPHeaderParser
+    {
+        public:
+            struct Span
+            {
+                std::size_t offset{ 0 };
+                std::size_t length{ 0 };
+            };
+
+            struct Field
+            {
+                Span name{};
+                Span value{};
+
+                // The value continues the previous field's value (obsolete line folding).
+                bool folded{ false };
+            };
+
+            /// Parses the lines in buffer that have not yet been parsed.
+            /// \param buffer The buffer, holding the header block from its start.
+            /// \param available The number of valid bytes in the buffer.
+            /// \return true once the empty line ending the header block has been found.
+            bool parse(const uint8_t* buffer, std::size_t available);
+
+            [[nodiscard]] bool is_complete() const
+            {
+                return complete;
+            }
+
+            /// The size of the header block, including the final empty line. Only valid once complete.
+            [[nodiscard]] std::size_t get_header_size() const
+            {
+                return header_size;
+            }
+
+            /// The request or response line, without line ending.
+            [[nodiscard]] const Span& get_start_line() const
+            {
+                return start_line;
+            }
+
+            [[nodiscard]] const std::vector<Field>& get_fields() const
+            {
+                return fields;
+            }
+
+            /// Prepares the parser for the next header block. Allocated memory is kept for reuse.
+            void reset();
+
+        private:
+            void parse_line(const uint8_t* buffer, std::size_t begin, std::size_t end);
+
+            static bool is_whitespace(uint8_t c)
+            {
+                return c == ' ' || c == '\t';
+            }
+
+            std::size_t line_start{ 0 };
+            std::size_t header_size{ 0 };
+            bool start_line_found{ false };
+            bool complete{ false };
+            Span start_line{};
+            std::vector<Field> fields{};
+    };
+}
@@ -0,0 +1,99 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace smooth::application::network::http::regular
+{
+    /// Flat, case-insensitive list of the header fields of a received message.
+    /// All names and values are stored back to back in a single buffer that is reused between messages,
+    /// so parsing the headers of a request doesn't allocate a string per field. Names are stored in lower case.
+    /// Views returned are valid until the instance is modified.
+    class HeaderFields
+    {
+        public:
+            /// Adds a field. If the last field has the same name, the value is appended to it, separated by ", ".
+            void add(std::string_view name, std::string_view value);
+
+            /// Appends to the value of the last field, used for obsolete line folding and repeated fields.
+            void append(std::string_view separator, std::string_view value);
+
+            /// Gets the value of the named field.
+            /// \param name Name of the field, compared case-insensitively.
+            /// \return The value, or an empty view if there is no such field.
+            [[nodiscard]] std::string_view get(std::string_view name) const;
+
+            [[nodiscard]] bool contains(std::string_view name) const;
+
+            [[nodiscard]] std::size_t size() const
+            {
+                return fields.size();
+            }
+
+            [[nodiscard]] bool empty() const
+            {
+                return fields.empty();
+            }
+
+            [[nodiscard]] std::string_view name(std::size_t index) const
+            {
+                const auto& f = fields[index];
+
+                return std::string_view{ buffer }.substr(f.name_offset, f.name_length);
+            }
+
+            [[nodiscard]] std::string_view value(std::size_t index) const
+            {
+                const auto& f = fields[index];
+
+                return std::string_view{ buffer }.substr(f.value_offset, f.value_length);
+            }
+
+            /// Gets the fields as a map, for handlers using the RequestHandlerSignature.
+            /// The map is built on the first call and kept until the instance is modified.
+            [[nodiscard]] const std::unordered_map<std::string, std::string>& as_map() const;
+
+            /// Removes all fields, keeping the allocated storage.
+            void clear();
+
+            void reserve(std::size_t bytes, std::size_t count);
+
+            /// Compares two field names, case-insensitively.
+            static bool equal_names(std::string_view a, std::string_view b);
+        private:
+            struct Field
+            {
+                uint32_t name_offset;
+                uint32_t name_length;
+                uint32_t value_offset;
+                uint32_t value_length;
+            };
+
+            [[nodiscard]] const Field* find(std::string_view name) const;
+
+            std::string buffer{};
+            std::vector<Field> fields{};
+            mutable std::unordered_map<std::string, std::string> map{};
+            mutable bool map_valid{ false };
+    };
+}
@@ -20,6 +20,7 @@ limitations under the License.
 #include <unordered_map>
 #include <memory>
 #include "RequestHandlerSignature.h"
+#include "RequestRecord.h"
 #include "smooth/application/network/http/IServerResponse.h"
 #include "smooth/application/network/http/IConnectionTimeoutModifier.h"
 
@@ -36,11 +37,16 @@ namespace smooth::application::network::http::regular
                                 IServerResponse& response,
                                 IConnectionTimeoutModifier& timeout_modifier,
                                 const std::string& requested_url,
-                                const std::unordered_map<std::string, std::string>& request_headers,
-                                const std::unordered_map<std::string, std::string>& request_parameters,
+                                const HeaderFields& request_headers,
+                                const QueryParameters& request_parameters,
                                 const std::vector<uint8_t>& data,
                                 MIMEParser& mime,
                                 bool fist_part,
                                 bool last_part) = 0;
+
+            /// Called when the last part of the response to a request has been handed to the socket.
+            virtual void request_completed(const RequestRecord& /*record*/)
+            {
+            }
     };
 }
@@ -18,6 +18,7 @@ limitations under the License.
 #pragma once
 
 #include <string>
+#include <vector>
 
 namespace smooth::application::network::http::regular
 {
@@ -27,5 +28,20 @@ namespace smooth::application::network::http::regular
             virtual ~ITemplateDataRetriever() = default;
 
             virtual std::string get(const std::string& key) const = 0;
+
+            /// Gets the values of all tokens of a template at once. Override this to resolve them in one go,
+            /// e.g. while holding a lock only once, instead of per token.
+            /// \param keys The tokens, in the form "{{name}}".
+            /// \param values Receives the value of each key, in the same order as the keys.
+            virtual void get_all(const std::vector<std::string>& keys, std::vector<std::string>& values) const
+            {
+                values.clear();
+                values.reserve(keys.size());
+
+                for (const auto& key : keys)
+                {
+                    values.push_back(get(key));
+                }
+            }
     };
 }
@@ -17,24 +17,34 @@ limitations under the License.
 
 #pragma once
 
+#include <array>
 #include <cstdint>
+#include <functional>
 #include <regex>
+#include <string>
 #include <vector>
-#include <tuple>
 #include <unordered_map>
 
 namespace smooth::application::network::http::regular
 {
+    /// Parses multipart/form-data and application/x-www-form-urlencoded request bodies.
+    /// Multipart data is parsed as it arrives; part data is passed on without being accumulated, only
+    /// a tail shorter than the boundary delimiter and the headers of the current part are buffered.
     class MIMEParser
     {
         public:
             using MimeData = std::vector<uint8_t>;
-            using BoundaryIterator = MimeData::const_iterator;
-            using Boundaries = std::vector<BoundaryIterator>;
+            using BoundaryIterator = const uint8_t*;
+
+            /// Called with the data of a part as it arrives, normally several times for large parts.
+            /// first_chunk is set on the first call for a part and last_chunk on the last, which may be
+            /// given an empty range when all data was passed in earlier calls.
             using FormDataCallback = std::function<void (const std::string& field_name,
                                                          const std::string& actual_file_name,
                                                          const BoundaryIterator& begin,
-                                                         const BoundaryIterator& end)>;
+                                                         const BoundaryIterator& end,
+                                                         bool first_chunk,
+                                                         bool last_chunk)>;
             using URLEncodedDataCallback = std::function<void (std::unordered_map<std::string, std::string>& data)>;
 
             bool detect_mode(const std::string& content_type, std::size_t content_length);
@@ -58,35 +68,51 @@ namespace smooth::application::network::http::regular
                 FormURLEncoded
             };
 
-            auto find_boundaries() const;
+            enum class State
+            {
+                Preamble,
+                AfterDelimiter,
+                Headers,
+                Content,
+                Done
+            };
+
+            void parse_form_data(const uint8_t* begin, const uint8_t* end, const FormDataCallback& content_callback);
 
-            BoundaryIterator get_end_of_boundary(BoundaryIterator begin);
+            void parse_url_encoded(const URLEncodedDataCallback& url_data);
 
-            void
-            parse_content(BoundaryIterator start_of_content, BoundaryIterator end_of_content,
-                          const FormDataCallback& content_callback) const;
+            const uint8_t* scan_for_delimiter(const uint8_t* begin, const uint8_t* end,
+                                              const FormDataCallback& content_callback);
 
-            void adjust_boundary_beginning_for_crlf(BoundaryIterator start_of_data, Boundaries& found_boundaries) const;
+            const uint8_t* parse_after_delimiter(const uint8_t* begin, const uint8_t* end);
 
-            bool is_crlf(BoundaryIterator start) const;
+            const uint8_t* parse_headers(const uint8_t* begin, const uint8_t* end);
 
-            std::tuple<BoundaryIterator,
-                       std::unordered_map<std::string, std::string>,
-                       std::unordered_map<std::string, std::string>>
-            consume_headers(BoundaryIterator begin, BoundaryIterator end) const;
+            [[nodiscard]] const uint8_t* find_delimiter(const uint8_t* begin, const uint8_t* end) const;
 
-            std::vector<uint8_t> boundary{};
-            std::vector<uint8_t> end_boundary{};
+            [[nodiscard]] const uint8_t* possible_delimiter_start(const uint8_t* begin, const uint8_t* end) const;
+
+            void emit(const uint8_t* begin, const uint8_t* end, bool last, const FormDataCallback& content_callback);
+
+            void parse_content_disposition(const std::string& content_disposition);
+
+            // Delimiter between parts, i.e. CRLF followed by "--" and the boundary.
+            std::vector<uint8_t> delimiter{};
+            std::array<std::size_t, 256> skip{};
+            std::vector<uint8_t> tail{};
+            std::vector<uint8_t> window{};
+            std::vector<uint8_t> part_headers{};
+            std::string field_name{};
+            std::string file_name{};
+            bool first_chunk{ true };
+            uint8_t delimiter_suffix{ 0 };
             std::vector<uint8_t> data{};
             std::unordered_map<std::string, std::string> form_url_encoded_data{};
             const std::regex form_data_pattern{ R"!(multipart\/form-data;.*boundary=(.+?)( |$))!" };
             const std::regex url_encoded_pattern{ R"!(application\/x-www-form-urlencoded)!" };
-            const std::vector<uint8_t> crlf{ '\r', '\n' };
-            const std::vector<uint8_t> crlf_double{ '\r', '\n', '\r', '\n' };
             Mode mode{ Mode::None };
+            State state{ State::Preamble };
             std::size_t expected_content_length{ 0 };
-
-            void parse_content_disposition(const std::unordered_map<std::string, std::string>& headers,
-                                           std::unordered_map<std::string, std::string>& content_disposition) const;
+            static constexpr std::size_t max_part_header_size = 2048;
     };
 }
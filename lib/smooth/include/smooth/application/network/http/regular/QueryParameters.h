@@ -0,0 +1,77 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace smooth::application::network::http::regular
+{
+    /// The key=value pairs of the query part of a requested URL.
+    /// Only the query string is stored when the request arrives; it is split into pairs the first time
+    /// a parameter is looked up. Views returned are valid until the next request on the connection.
+    class QueryParameters
+    {
+        public:
+            /// Sets the query, i.e. the decoded part of the URL following the '?'.
+            void assign(std::string_view query);
+
+            /// Gets the value of the named parameter.
+            /// \return The value, or an empty view if there is no such parameter.
+            [[nodiscard]] std::string_view get(std::string_view key) const;
+
+            [[nodiscard]] bool contains(std::string_view key) const;
+
+            [[nodiscard]] std::size_t size() const;
+
+            [[nodiscard]] bool empty() const
+            {
+                return size() == 0;
+            }
+
+            [[nodiscard]] std::string_view key(std::size_t index) const;
+
+            [[nodiscard]] std::string_view value(std::size_t index) const;
+
+            /// Gets the parameters as a map, for handlers using the RequestHandlerSignature.
+            /// The map is built on the first call and kept until the next request.
+            [[nodiscard]] const std::unordered_map<std::string, std::string>& as_map() const;
+
+            void clear();
+        private:
+            struct Pair
+            {
+                std::size_t key_offset;
+                std::size_t key_length;
+                std::size_t value_offset;
+                std::size_t value_length;
+            };
+
+            void split() const;
+
+            [[nodiscard]] const Pair* find(std::string_view key) const;
+
+            std::string query{};
+            mutable std::vector<Pair> pairs{};
+            mutable bool split_done{ false };
+            mutable std::unordered_map<std::string, std::string> map{};
+            mutable bool map_valid{ false };
+    };
+}
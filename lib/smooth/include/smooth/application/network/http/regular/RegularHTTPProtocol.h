@@ -17,11 +17,12 @@ limitations under the License.
 
 #pragma once
 
-#include <regex>
+#include <string_view>
 #include "smooth/core/network/IPacketAssembly.h"
 #include "smooth/application/network/http/HTTPPacket.h"
 #include "smooth/application/network/http/IServerResponse.h"
 #include "IUpgradeToWebsocket.h"
+#include "HTTPHeaderParser.h"
 
 namespace smooth::application::network::http::regular
 {
@@ -56,8 +57,28 @@ namespace smooth::application::network::http::regular
 
             void reset() override;
 
+            int get_buffered_amount() const override
+            {
+                return static_cast<int>(buffered.size());
+            }
+
+            int take_buffered(uint8_t* target, int length) override;
+
         private:
-            int consume_headers(HTTPPacket& packet, std::vector<uint8_t>::const_iterator header_ending);
+            void buffer_surplus(HTTPPacket& packet);
+
+            /// Returns true for response codes of responses that never have content. Requests have no response code.
+            static bool is_without_content(ResponseCode code);
+
+            bool detect_transfer_coding(HTTPPacket& packet);
+
+            void decode_chunked(HTTPPacket& packet, std::size_t raw_start, std::size_t raw_length);
+
+            bool is_request_complete() const;
+
+            int consume_headers(HTTPPacket& packet);
+
+            void parse_start_line(HTTPPacket& packet, std::string_view line);
 
             enum class State
             {
@@ -65,6 +86,18 @@ namespace smooth::application::network::http::regular
                 reading_content
             };
 
+            // States of the chunked transfer coding decoder, https://tools.ietf.org/html/rfc7230#section-4.1
+            enum class ChunkState
+            {
+                size,
+                size_end,
+                extension,
+                data,
+                data_end,
+                trailer,
+                done
+            };
+
             const int max_header_size;
             const int content_chunk_size;
             IServerResponse& response;
@@ -75,8 +108,25 @@ namespace smooth::application::network::http::regular
             int incoming_content_length{ 0 };
             int actual_header_size{ 0 };
 
-            const std::regex response_line{ R"!(HTTP\/(\d.\d)\ (\d+)\ (.+))!" }; // HTTP/1.1 200 OK
-            const std::regex request_line{ R"!((.+)\ (.+)\ HTTP\/(\d\.\d))!" }; // "GET / HTTP/1.1"
+            // When the first byte of the current message was received.
+            std::chrono::steady_clock::time_point message_start{};
+
+            HTTPHeaderParser header_parser{};
+
+            bool chunked{ false };
+
+            // Set for a response whose content ends when the connection is closed.
+            bool until_close{ false };
+            ChunkState chunk_state{ ChunkState::size };
+            std::size_t chunk_remaining{ 0 };
+            std::size_t chunk_size_digits{ 0 };
+
+            // Set when the last character outside of chunk data was a CR, which must be followed by LF.
+            bool chunk_cr{ false };
+            std::size_t trailer_line_length{ 0 };
+
+            // Bytes received beyond the end of the current request, i.e. the start of pipelined requests.
+            std::vector<uint8_t> buffered{};
 
             bool error = false;
             State state = State::reading_headers;
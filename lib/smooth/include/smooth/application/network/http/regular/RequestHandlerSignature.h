@@ -17,15 +17,21 @@ limitations under the License.
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include "smooth/application/network/http/IResponseOperation.h"
 #include "smooth/application/network/http/IConnectionTimeoutModifier.h"
 #include "smooth/application/network/http/IServerResponse.h"
+#include "HeaderFields.h"
+#include "QueryParameters.h"
+#include "RouteParameters.h"
 
 namespace smooth::application::network::http::regular
 {
     class MIMEParser;
 
+    /// Handler receiving the headers and request parameters as maps. The maps are only built for
+    /// requests routed to such handlers; prefer the RouteHandlerSignature which avoids that.
     using RequestHandlerSignature = std::function<void (
                                                       IServerResponse& response,
                                                       IConnectionTimeoutModifier& timeout_modifier,
@@ -38,4 +44,19 @@ namespace smooth::application::network::http::regular
                                                       const std::vector<uint8_t>& content,
                                                       MIMEParser& mime
                                                       )>;
+
+    /// Handler receiving the headers and request parameters as views into the received request, as well as
+    /// the values captured by the :param or *wildcard segments of the route.
+    using RouteHandlerSignature = std::function<void (
+                                                    IServerResponse& response,
+                                                    IConnectionTimeoutModifier& timeout_modifier,
+                                                    const std::string& url,
+                                                    bool first_part,
+                                                    bool last_part,
+                                                    const HeaderFields& headers,
+                                                    const QueryParameters& request_parameters,
+                                                    const RouteParameters& route_parameters,
+                                                    const std::vector<uint8_t>& content,
+                                                    MIMEParser& mime
+                                                    )>;
 }
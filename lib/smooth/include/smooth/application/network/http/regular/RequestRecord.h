@@ -0,0 +1,50 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include "HTTPMethod.h"
+#include "ResponseCodes.h"
+
+namespace smooth::application::network::http::regular
+{
+    /// What is known about a request once its response has been sent, see IRequestHandler::request_completed().
+    struct RequestRecord
+    {
+        /// Route id of requests not handled by a route, such as those for files.
+        static constexpr std::size_t NoRoute = std::numeric_limits<std::size_t>::max();
+
+        /// When the first byte of the request headers was received.
+        std::chrono::steady_clock::time_point start{};
+        HTTPMethod method{ HTTPMethod::GET };
+
+        /// HTTP version of the request, e.g. "1.1".
+        std::string version{ "1.1" };
+
+        /// The route handling the request, see Router::get_route().
+        std::size_t route{ NoRoute };
+        ResponseCode code{};
+
+        /// Size of the request and of the response, headers included.
+        std::size_t bytes_in{ 0 };
+        std::size_t bytes_out{ 0 };
+    };
+}
@@ -0,0 +1,77 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace smooth::application::network::http::regular
+{
+    /// Values captured from a requested URL by the :param and *wildcard segments of a route.
+    /// Names refer to the registered route and values to the requested URL, so no copies are made;
+    /// the instance is only valid during the call to the request handler.
+    class RouteParameters
+    {
+        public:
+            /// Maximum number of parameters in a single route.
+            static constexpr std::size_t MaxCount = 8;
+
+            /// Gets the value of the named parameter.
+            /// \param name The name of the parameter, without the leading ':' or '*'.
+            /// \return The value, or an empty view if there is no such parameter.
+            [[nodiscard]] std::string_view get(std::string_view name) const
+            {
+                std::string_view res{};
+
+                for (std::size_t i = 0; names != nullptr && i < count; ++i)
+                {
+                    if ((*names)[i] == name)
+                    {
+                        res = values[i];
+                    }
+                }
+
+                return res;
+            }
+
+            [[nodiscard]] std::size_t size() const
+            {
+                return count;
+            }
+
+            [[nodiscard]] bool empty() const
+            {
+                return count == 0;
+            }
+
+            /// Gets the value at the given position, in the order the parameters appear in the route.
+            [[nodiscard]] std::string_view operator[](std::size_t index) const
+            {
+                return values[index];
+            }
+
+        private:
+            friend class Router;
+
+            const std::vector<std::string>* names{ nullptr };
+            std::array<std::string_view, MaxCount> values{};
+            std::size_t count{ 0 };
+    };
+}
@@ -0,0 +1,103 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "HTTPMethod.h"
+#include "RequestHandlerSignature.h"
+#include "RouteParameters.h"
+
+namespace smooth::application::network::http::regular
+{
+    /// Compressed radix tree mapping URLs to request handlers, with one handler per HTTP method in each leaf.
+    /// Routes consist of static text and segments in the form:
+    /// - ":name", matching a single path segment, e.g. "/users/:id"
+    /// - "*name", matching the remainder of the URL, only allowed last, e.g. "/static/*file"
+    /// When several routes match, static text is preferred over a :param which is preferred over a *wildcard.
+    /// Resolving a URL is proportional to its length and does not allocate any memory.
+    class Router
+    {
+        public:
+            /// Adds a route, replacing any existing handler for the same method and route.
+            /// \param method The method to handle
+            /// \param route The route, e.g. "/api/users/:id"
+            /// \param handler The handler to call
+            /// \return true on success, false if the route is invalid.
+            bool add(HTTPMethod method, const std::string& route, RouteHandlerSignature handler);
+
+            /// Finds the handler for a request.
+            /// \param method The method of the request
+            /// \param url The requested URL
+            /// \param parameters Receives the values captured from the URL
+            /// \param route Receives the id of the matching route, see get_route().
+            /// \return The handler, or nullptr if there is no matching route.
+            const RouteHandlerSignature* find(HTTPMethod method,
+                                              std::string_view url,
+                                              RouteParameters& parameters,
+                                              std::size_t& route) const;
+
+            /// Gets a route as it was added.
+            /// \param route The id of the route, numbered from 0 in the order the routes were first added.
+            /// \return The route, or an empty string for an unknown id.
+            [[nodiscard]] const std::string& get_route(std::size_t route) const;
+
+            /// \return The number of distinct routes added.
+            [[nodiscard]] std::size_t get_route_count() const
+            {
+                return routes.size();
+            }
+
+        private:
+            static constexpr std::size_t MethodCount = static_cast<std::size_t>(HTTPMethod::POST) + 1;
+
+            struct Route
+            {
+                RouteHandlerSignature handler{};
+                std::vector<std::string> parameter_names{};
+                std::size_t id{ 0 };
+            };
+
+            struct Node
+            {
+                std::string prefix{};
+
+                // Static children, each starting with a unique character.
+                std::vector<std::unique_ptr<Node>> children{};
+                std::unique_ptr<Node> parameter{};
+                std::unique_ptr<Node> wildcard{};
+                std::array<Route, MethodCount> routes{};
+            };
+
+            static Node* insert_static(Node& node, std::string_view text);
+
+            static bool match(const Node& node,
+                              std::string_view remaining,
+                              std::size_t method,
+                              RouteParameters& parameters,
+                              const Route*& found);
+
+            static bool match_leaf(const Node& node, std::size_t method, const Route*& found);
+
+            Node root{};
+            std::vector<std::string> routes{};
+    };
+}
@@ -0,0 +1,120 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <array>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "smooth/core/filesystem/Fileinfo.h"
+#include "smooth/core/filesystem/Path.h"
+#include "smooth/application/network/http/IResponseOperation.h"
+#include "HeaderFields.h"
+
+namespace smooth::application::network::http::regular
+{
+    /// In-memory cache of static files served by the HTTPServer.
+    /// Each cached file holds its content along with precompressed siblings found on disk
+    /// ("file.js.gz", "file.js.br"), which are selected according to the request's Accept-Encoding.
+    /// A strong ETag is computed once per file when it is loaded. Entries are reloaded when the file's
+    /// modification time or size changes and the least recently used entries are evicted to stay within
+    /// the byte budget.
+    /// Not thread safe; only to be used from the HTTPServer's task.
+    class StaticAssetCache
+    {
+        public:
+            /// \param max_size The maximum number of bytes to hold, 0 disables the cache.
+            explicit StaticAssetCache(std::size_t max_size);
+
+            [[nodiscard]] bool is_enabled() const
+            {
+                return max_size > 0;
+            }
+
+            /// Creates a response for the file, answering conditional requests with 304 Not Modified.
+            /// \param info The file to serve
+            /// \param request_headers The headers of the request
+            /// \param with_content false for a response with the headers only, e.g. to a HEAD request. Only a
+            /// file already in the cache is used then.
+            /// \return The response, or an empty pointer if the file can't be cached.
+            std::unique_ptr<IResponseOperation>
+            get_response(const smooth::core::filesystem::FileInfo& info,
+                         const HeaderFields& request_headers,
+                         bool with_content = true);
+
+            [[nodiscard]] std::size_t get_cached_size() const
+            {
+                return cached_size;
+            }
+
+            void clear();
+
+        private:
+            enum Encoding : std::size_t
+            {
+                Identity = 0,
+                Gzip,
+                Brotli,
+                EncodingCount
+            };
+
+            struct Variant
+            {
+                std::shared_ptr<const std::vector<uint8_t>> content{};
+                std::string etag{};
+            };
+
+            struct Asset
+            {
+                std::string path{};
+                time_t modified{};
+                std::size_t file_size{};
+                std::string content_type{};
+                std::string last_modified{};
+                std::array<Variant, EncodingCount> variants{};
+
+                [[nodiscard]] std::size_t memory_usage() const;
+            };
+
+            using AssetList = std::list<Asset>;
+
+            const Asset* find(const smooth::core::filesystem::FileInfo& info, bool load_missing);
+
+            bool load(const smooth::core::filesystem::FileInfo& info, Asset& asset) const;
+
+            static bool load_sibling(const smooth::core::filesystem::FileInfo& info,
+                                     const char* extension,
+                                     Variant& variant);
+
+            void remove(AssetList::iterator pos);
+
+            static Encoding select_encoding(const Asset& asset,
+                                            const HeaderFields& request_headers);
+
+            static bool matches(const std::string& if_none_match, const std::string& etag);
+
+            std::size_t max_size;
+            std::size_t cached_size{ 0 };
+
+            // Most recently used first.
+            AssetList assets{};
+            std::unordered_map<std::string, AssetList::iterator> by_path{};
+    };
+}
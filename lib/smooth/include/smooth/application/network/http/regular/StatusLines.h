@@ -0,0 +1,226 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <string_view>
+#include "ResponseCodes.h"
+
+namespace smooth::application::network::http::regular
+{
+    /// Gets the complete HTTP/1.1 status line, including the ending CRLF, for the given response code.
+    /// \return The status line, or an empty view for codes without a reason phrase.
+    constexpr std::string_view status_line(ResponseCode code)
+    {
+        std::string_view res{};
+
+        switch (code)
+        {
+            case ResponseCode::Continue:
+                res = "HTTP/1.1 100 Continue\r\n";
+                break;
+            case ResponseCode::SwitchingProtocols:
+                res = "HTTP/1.1 101 Switching Protocols\r\n";
+                break;
+            case ResponseCode::Processing:
+                res = "HTTP/1.1 102 Processing\r\n";
+                break;
+            case ResponseCode::OK:
+                res = "HTTP/1.1 200 OK\r\n";
+                break;
+            case ResponseCode::Created:
+                res = "HTTP/1.1 201 Created\r\n";
+                break;
+            case ResponseCode::Accepted:
+                res = "HTTP/1.1 202 Accepted\r\n";
+                break;
+            case ResponseCode::Non_authoritativeInformation:
+                res = "HTTP/1.1 203 Non-Authoritative Information\r\n";
+                break;
+            case ResponseCode::No_Content:
+                res = "HTTP/1.1 204 No Content\r\n";
+                break;
+            case ResponseCode::Reset_Content:
+                res = "HTTP/1.1 205 Reset Content\r\n";
+                break;
+            case ResponseCode::Partial_Content:
+                res = "HTTP/1.1 206 Partial Content\r\n";
+                break;
+            case ResponseCode::Multi_Status:
+                res = "HTTP/1.1 207 Multi Status\r\n";
+                break;
+            case ResponseCode::Already_Reported:
+                res = "HTTP/1.1 208 Already Reported\r\n";
+                break;
+            case ResponseCode::IM_Used:
+                res = "HTTP/1.1 226 IM Used\r\n";
+                break;
+            case ResponseCode::Multiple_Choices:
+                res = "HTTP/1.1 300 Multiple Choices\r\n";
+                break;
+            case ResponseCode::Moved_Permanently:
+                res = "HTTP/1.1 301 Moved Permanently\r\n";
+                break;
+            case ResponseCode::Found:
+                res = "HTTP/1.1 302 Found\r\n";
+                break;
+            case ResponseCode::See_Other:
+                res = "HTTP/1.1 303 See Other\r\n";
+                break;
+            case ResponseCode::Not_Modified:
+                res = "HTTP/1.1 304 Not Modified\r\n";
+                break;
+            case ResponseCode::Use_Proxy:
+                res = "HTTP/1.1 305 Use Proxy\r\n";
+                break;
+            case ResponseCode::Temporary_Redirect:
+                res = "HTTP/1.1 307 Temporary Redirect\r\n";
+                break;
+            case ResponseCode::Permanent_Redirect:
+                res = "HTTP/1.1 308 Permanent Redirect\r\n";
+                break;
+            case ResponseCode::Bad_Request:
+                res = "HTTP/1.1 400 Bad Request\r\n";
+                break;
+            case ResponseCode::Unauthorized:
+                res = "HTTP/1.1 401 Unauthorized\r\n";
+                break;
+            case ResponseCode::Payment_Required:
+                res = "HTTP/1.1 402 Payment Required\r\n";
+                break;
+            case ResponseCode::Forbidden:
+                res = "HTTP/1.1 403 Forbidden\r\n";
+                break;
+            case ResponseCode::Not_Found:
+                res = "HTTP/1.1 404 Not Found\r\n";
+                break;
+            case ResponseCode::Method_Not_Allowed:
+                res = "HTTP/1.1 405 Method Not Allowed\r\n";
+                break;
+            case ResponseCode::Not_Acceptable:
+                res = "HTTP/1.1 406 Not Acceptable\r\n";
+                break;
+            case ResponseCode::Proxy_Authentication_Required:
+                res = "HTTP/1.1 407 Proxy Authentication Required\r\n";
+                break;
+            case ResponseCode::Request_Timeout:
+                res = "HTTP/1.1 408 Request Timeout\r\n";
+                break;
+            case ResponseCode::Conflict:
+                res = "HTTP/1.1 409 Conflict\r\n";
+                break;
+            case ResponseCode::Gone:
+                res = "HTTP/1.1 410 Gone\r\n";
+                break;
+            case ResponseCode::Length_Required:
+                res = "HTTP/1.1 411 Length Required\r\n";
+                break;
+            case ResponseCode::Precondition_Failed:
+                res = "HTTP/1.1 412 Precondition Failed\r\n";
+                break;
+            case ResponseCode::Payload_Too_Large:
+                res = "HTTP/1.1 413 Payload Too Large\r\n";
+                break;
+            case ResponseCode::Request_URI_Too_Long:
+                res = "HTTP/1.1 414 Request URI Too Long\r\n";
+                break;
+            case ResponseCode::Unsupported_Media_Type:
+                res = "HTTP/1.1 415 Unsupported Media Type\r\n";
+                break;
+            case ResponseCode::Requested_Range_Not_Satisfiable:
+                res = "HTTP/1.1 416 Requested Range Not Satisfiable\r\n";
+                break;
+            case ResponseCode::Expectation_Failed:
+                res = "HTTP/1.1 417 Expectation Failed\r\n";
+                break;
+            case ResponseCode::Im_a_teapot:
+                res = "HTTP/1.1 418 I'm a teapot\r\n";
+                break;
+            case ResponseCode::Misdirected_Request:
+                res = "HTTP/1.1 421 Misdirected Request\r\n";
+                break;
+            case ResponseCode::Unprocessable_Entity:
+                res = "HTTP/1.1 422 Unprocessable Entity\r\n";
+                break;
+            case ResponseCode::Locked:
+                res = "HTTP/1.1 423 Locked\r\n";
+                break;
+            case ResponseCode::Failed_Dependency:
+                res = "HTTP/1.1 424 Failed Dependency\r\n";
+                break;
+            case ResponseCode::Upgrade_Required:
+                res = "HTTP/1.1 426 Upgrade Required\r\n";
+                break;
+            case ResponseCode::Precondition_Required:
+                res = "HTTP/1.1 428 Precondition Required\r\n";
+                break;
+            case ResponseCode::Too_Many_Requests:
+                res = "HTTP/1.1 429 Too Many Requests\r\n";
+                break;
+            case ResponseCode::Request_Header_Fields_Too_Large:
+                res = "HTTP/1.1 431 Request Header Fields Too Large\r\n";
+                break;
+            case ResponseCode::Connection_Closed_Without_Response:
+                res = "HTTP/1.1 444 Connection Closed Without Response\r\n";
+                break;
+            case ResponseCode::Unavailable_For_Legal_Reasons:
+                res = "HTTP/1.1 451 Unavailable For Legal Reasons\r\n";
+                break;
+            case ResponseCode::Client_Closed_Request:
+                res = "HTTP/1.1 499 Client Closed Request\r\n";
+                break;
+            case ResponseCode::Internal_Server_Error:
+                res = "HTTP/1.1 500 Internal Server Error\r\n";
+                break;
+            case ResponseCode::Not_Implemented:
+                res = "HTTP/1.1 501 Not Implemented\r\n";
+                break;
+            case ResponseCode::Bad_Gateway:
+                res = "HTTP/1.1 502 Bad Gateway\r\n";
+                break;
+            case ResponseCode::Service_Unavailable:
+                res = "HTTP/1.1 503 Service Unavailable\r\n";
+                break;
+            case ResponseCode::Gateway_Timeout:
+                res = "HTTP/1.1 504 Gateway Timeout\r\n";
+                break;
+            case ResponseCode::HTTP_Version_Not_Supported:
+                res = "HTTP/1.1 505 HTTP Version Not Supported\r\n";
+                break;
+            case ResponseCode::Variant_Also_Negotiates:
+                res = "HTTP/1.1 506 Variant Also Negotiates\r\n";
+                break;
+            case ResponseCode::Insufficient_Storage:
+                res = "HTTP/1.1 507 Insufficient Storage\r\n";
+                break;
+            case ResponseCode::Loop_Detected:
+                res = "HTTP/1.1 508 Loop Detected\r\n";
+                break;
+            case ResponseCode::Not_Extended:
+                res = "HTTP/1.1 510 Not Extended\r\n";
+                break;
+            case ResponseCode::Network_Authentication_Required:
+                res = "HTTP/1.1 511 Network Authentication Required\r\n";
+                break;
+            case ResponseCode::Network_Connect_Timeout_Error:
+                res = "HTTP/1.1 599 Network Connect Timeout Error\r\n";
+                break;
+        }
+
+        return res;
+    }
+}
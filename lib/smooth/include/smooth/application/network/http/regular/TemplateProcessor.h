@@ -19,14 +19,18 @@ limitations under the License.
 
 #include <memory>
 #include <set>
-#include <regex>
 #include <string>
+#include <unordered_map>
 #include "smooth/core/filesystem/Path.h"
-#include "smooth/application/network/http/regular/responses/StringResponse.h"
+#include "smooth/application/network/http/IResponseOperation.h"
+#include "CompiledTemplate.h"
 #include "ITemplateDataRetriever.h"
 
 namespace smooth::application::network::http::regular
 {
+    /// Replaces tokens in the form "{{name}}" in template files with values from the ITemplateDataRetriever.
+    /// Each template is parsed once into literal and token segments and kept until the file changes;
+    /// the response then streams the segments and the token values without building the whole page.
     class TemplateProcessor
     {
         public:
@@ -36,14 +40,21 @@ namespace smooth::application::network::http::regular
             std::unique_ptr<smooth::application::network::http::IResponseOperation>
             process_template(const smooth::core::filesystem::Path& path);
 
+            /// \return true if the file is processed as a template, by its extension.
+            [[nodiscard]] bool is_template(const smooth::core::filesystem::Path& path) const;
+
 #ifndef EXPOSE_PRIVATE_PARTS_FOR_TEST
         private:
 #endif
 
-            void process_template(std::string& template_data) const;
+            std::shared_ptr<const CompiledTemplate> get_compiled(const smooth::core::filesystem::Path& path);
+
+            static void compile(CompiledTemplate& t);
+
+            static bool is_token_char(char c);
 
             std::set<std::string> template_files;
             std::shared_ptr<ITemplateDataRetriever> data_retriever;
-            const std::regex token{ R"!(\{\{[\d\_\-a-zA-Z]+\}\})!", std::regex::ECMAScript };
+            std::unordered_map<std::string, std::shared_ptr<const CompiledTemplate>> compiled{};
     };
 }
@@ -0,0 +1,52 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "HeaderOnlyResponse.h"
+
+namespace smooth::application::network::http::regular::responses
+{
+    /// Response sending content shared with the StaticAssetCache, without copying it up front.
+    class CachedAssetResponse
+        : public HeaderOnlyResponse
+    {
+        public:
+            explicit CachedAssetResponse(std::shared_ptr<const std::vector<uint8_t>> content);
+
+            CachedAssetResponse& operator=(CachedAssetResponse&&) = default;
+
+            CachedAssetResponse(CachedAssetResponse&&) = default;
+
+            CachedAssetResponse& operator=(const CachedAssetResponse&) = delete;
+
+            CachedAssetResponse(const CachedAssetResponse&) = delete;
+
+            ~CachedAssetResponse() override = default;
+
+            // Called at least once when sending a response and until ResponseStatus::NoData is returned
+            ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) override;
+
+            void dump() const override;
+
+        private:
+            std::shared_ptr<const std::vector<uint8_t>> content;
+            std::size_t sent{ 0 };
+    };
+}
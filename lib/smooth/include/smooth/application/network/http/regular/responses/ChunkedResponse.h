@@ -0,0 +1,71 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "HeaderOnlyResponse.h"
+
+namespace smooth::application::network::http::regular::responses
+{
+    /// Response with a body of unknown length, generated while it is being sent and transferred using
+    /// chunked transfer coding (https://tools.ietf.org/html/rfc7230#section-4.1). At most one chunk
+    /// of data is held in memory at any time. For HTTP/1.0 clients the body is sent as is instead, and
+    /// its end is marked by closing the connection.
+    class ChunkedResponse
+        : public HeaderOnlyResponse
+    {
+        public:
+            /// Called each time more data can be sent.
+            /// \param max_amount The maximum number of bytes to append to target. Any excess is kept and
+            /// sent before the generator is called again.
+            /// \param target The container to append the data to
+            /// \return true if there is more data to come, false when all data has been generated.
+            using Generator = std::function<bool (std::size_t max_amount, std::vector<uint8_t>& target)>;
+
+            ChunkedResponse(ResponseCode code, const std::string& content_type, Generator generator);
+
+            ChunkedResponse& operator=(ChunkedResponse&&) = default;
+
+            ChunkedResponse(ChunkedResponse&&) = default;
+
+            ChunkedResponse& operator=(const ChunkedResponse&) = delete;
+
+            ChunkedResponse(const ChunkedResponse&) = delete;
+
+            ~ChunkedResponse() override = default;
+
+            // Called at least once when sending a response and until ResponseStatus::NoData is returned
+            ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) override;
+
+            bool disable_chunked_coding() override;
+
+            void dump() const override;
+
+        private:
+            static void append_chunk_size(std::size_t size, std::vector<uint8_t>& target);
+
+            Generator generator;
+            std::vector<uint8_t> pending{};
+            std::size_t sent{ 0 };
+            bool chunked{ true };
+            bool more_to_generate{ true };
+            bool complete{ false };
+    };
+}
@@ -0,0 +1,146 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "ChunkedResponse.h"
+#include "smooth/application/network/http/regular/HeaderFields.h"
+#include "smooth/config_constants.h"
+
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#endif
+
+#ifdef CONFIG_SMOOTH_HTTP_COMPRESSION
+#include <zlib.h>
+#endif
+
+namespace smooth::application::network::http::regular::responses
+{
+    /// Settings for compressing responses on the fly, see CompressedResponse::compress().
+    struct CompressionOptions
+    {
+        /// Responses with less content than this are sent as is.
+        std::size_t min_size{ 512 };
+
+        /// Media types of the responses to compress.
+        std::set<std::string> content_types{ "text/html",
+                                             "text/plain",
+                                             "text/css",
+                                             "text/javascript",
+                                             "application/javascript",
+                                             "application/json",
+                                             "application/xml",
+                                             "image/svg+xml" };
+
+        /// zlib compression level, 1 (fastest) - 9 (best).
+        int level{ 6 };
+
+        /// zlib window size (9 - 15) and memory level (1 - 9). The compressor uses about
+        /// 2^(window_bits + 2) + 2^(mem_level + 9) bytes of memory, 16kB with the defaults.
+        int window_bits{ 11 };
+        int mem_level{ 4 };
+    };
+
+#ifdef CONFIG_SMOOTH_HTTP_COMPRESSION
+
+    /// Sends the content of another response compressed with gzip or deflate. The compressed length isn't
+    /// known until everything is sent, so the content is sent using chunked transfer coding. The content
+    /// of the wrapped response is compressed as it is sent, one chunk at a time. HTTP/1.0 clients, which don't
+    /// understand chunked transfer coding, get the wrapped response as is.
+    class CompressedResponse
+        : public ChunkedResponse
+    {
+        public:
+            enum class Coding
+            {
+                Gzip,
+                Deflate
+            };
+
+            CompressedResponse(std::unique_ptr<IResponseOperation> response,
+                               Coding coding,
+                               const CompressionOptions& options);
+
+            CompressedResponse& operator=(CompressedResponse&&) = delete;
+
+            CompressedResponse(CompressedResponse&&) = delete;
+
+            CompressedResponse& operator=(const CompressedResponse&) = delete;
+
+            CompressedResponse(const CompressedResponse&) = delete;
+
+            ~CompressedResponse() override;
+
+            /// Wraps the response in a CompressedResponse if the client accepts a supported coding and the
+            /// response is eligible: of a listed media type, with at least options.min_size bytes of content
+            /// of known length and not already encoded. Otherwise the response is returned unchanged.
+            static std::unique_ptr<IResponseOperation> compress(std::unique_ptr<IResponseOperation> response,
+                                                                const HeaderFields& request_headers,
+                                                                const CompressionOptions& options);
+
+            // Called at least once when sending a response and until ResponseStatus::NoData is returned
+            ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) override;
+
+            bool get_file_region(smooth::core::network::FileRegion& region) override;
+
+            bool disable_chunked_coding() override;
+
+            void dump() const override;
+
+        private:
+            void initialize();
+
+            bool generate(std::size_t max_amount, std::vector<uint8_t>& target);
+
+            static bool is_eligible(const std::unordered_map<std::string, std::string>& response_headers,
+                                    ResponseCode code,
+                                    const CompressionOptions& options);
+
+            std::unique_ptr<IResponseOperation> response;
+            const Coding coding;
+            const int level;
+            const int window_bits;
+            const int mem_level;
+            z_stream stream{};
+            std::vector<uint8_t> input{};
+            std::size_t consumed{ 0 };
+            bool initialized{ false };
+            bool input_complete{ false };
+            bool failed{ false };
+            bool pass_through{ false };
+    };
+
+#else
+
+    /// Compression requires zlib and is disabled (CONFIG_SMOOTH_HTTP_COMPRESSION); responses are sent as is.
+    class CompressedResponse
+    {
+        public:
+            static std::unique_ptr<IResponseOperation> compress(std::unique_ptr<IResponseOperation> response,
+                                                                const HeaderFields& /*request_headers*/,
+                                                                const CompressionOptions& /*options*/)
+            {
+                return response;
+            }
+    };
+
+#endif
+}
@@ -17,9 +17,13 @@ limitations under the License.
 
 #pragma once
 
+#include <string>
+#include <vector>
 #include "StringResponse.h"
+#include "smooth/application/network/http/http_utils.h"
 #include "smooth/core/filesystem/Path.h"
 #include "smooth/core/filesystem/Fileinfo.h"
+#include "smooth/core/filesystem/OpenFile.h"
 
 namespace smooth::application::network::http::regular::responses
 {
@@ -29,14 +33,45 @@ namespace smooth::application::network::http::regular::responses
         public:
             explicit FileContentResponse(smooth::core::filesystem::Path full_path);
 
+            /// Responds with 206 Partial Content, holding the given ranges of the file. A single range is sent
+            /// as is, several as a multipart/byteranges body. Without ranges, the entire file is sent.
+            /// \param file_info The file.
+            /// \param ranges The ranges to send, all satisfiable for the size of file_info.
+            FileContentResponse(smooth::core::filesystem::FileInfo file_info,
+                                const std::vector<utils::ByteRange>& ranges);
+
             // Called at least once when sending a response and until ResponseStatus::AllSent is returned
             ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) override;
 
+            /// Hands over the open file so that it is sent without being read chunk by chunk.
+            bool get_file_region(smooth::core::network::FileRegion& region) override;
+
             void dump() const override;
 
         private:
+            // A part of the body; the text when set, otherwise a range of the file.
+            struct Segment
+            {
+                std::string text;
+                std::size_t offset;
+                std::size_t length;
+            };
+
+            void open_file();
+
+            bool read_file(std::size_t offset, std::size_t length, std::vector<uint8_t>& target) const;
+
             smooth::core::filesystem::Path path;
             smooth::core::filesystem::FileInfo info;
+
+            // Opened when the response is first sent and kept open until it is done. Without it (e.g. when
+            // too many files are open) the content is read chunk by chunk instead.
+            std::shared_ptr<smooth::core::filesystem::OpenFile> file{};
+            bool open_attempted{ false };
+            std::vector<Segment> segments{};
+            std::size_t current_segment{ 0 };
+            std::size_t sent_of_segment{ 0 };
+            std::size_t content_length{ 0 };
             std::size_t sent{ 0 };
     };
 }
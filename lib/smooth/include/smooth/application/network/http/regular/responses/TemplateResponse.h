@@ -0,0 +1,61 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "HeaderOnlyResponse.h"
+#include "smooth/application/network/http/regular/CompiledTemplate.h"
+
+namespace smooth::application::network::http::regular::responses
+{
+    /// Response rendering a compiled template, writing the literal text and the token values
+    /// directly into the outgoing chunks.
+    class TemplateResponse
+        : public HeaderOnlyResponse
+    {
+        public:
+            /// \param compiled The template
+            /// \param values The value of each of the template's tokens.
+            TemplateResponse(std::shared_ptr<const CompiledTemplate> compiled, std::vector<std::string> values);
+
+            TemplateResponse& operator=(TemplateResponse&&) = default;
+
+            TemplateResponse(TemplateResponse&&) = default;
+
+            TemplateResponse& operator=(const TemplateResponse&) = delete;
+
+            TemplateResponse(const TemplateResponse&) = delete;
+
+            ~TemplateResponse() override = default;
+
+            // Called at least once when sending a response and until ResponseStatus::NoData is returned
+            ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) override;
+
+            void dump() const override;
+
+        private:
+            [[nodiscard]] std::string_view segment_data(const CompiledTemplate::Segment& segment) const;
+
+            std::shared_ptr<const CompiledTemplate> compiled;
+            std::vector<std::string> values;
+            std::size_t segment{ 0 };
+            std::size_t segment_offset{ 0 };
+    };
+}
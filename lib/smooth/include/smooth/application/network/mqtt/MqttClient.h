@@ -136,6 +136,12 @@ namespace smooth::application::network::mqtt
 
             bool load_certificate(const std::vector<unsigned char> ca_cert);
 
+            /// Gets the TLS session resumption counters for reconnects to the broker.
+            smooth::core::network::TLSSessionStatistics get_tls_session_statistics() const
+            {
+                return tls_session->get_statistics();
+            }
+
         private:
             void event(const core::network::event::TransmitBufferEmptyEvent& event) override;
 
@@ -218,5 +224,7 @@ namespace smooth::application::network::mqtt
             
             bool is_mqtts = false;
             std::unique_ptr<smooth::core::network::MBedTLSContext> tls_context{};
+            std::shared_ptr<smooth::core::network::TLSSession> tls_session{
+                std::make_shared<smooth::core::network::TLSSession>() };
     };
 }
@@ -8,5 +8,9 @@ const int CONFIG_SMOOTH_MAX_MQTT_OUTGOING_MESSAGES = 10;
 const int SMOOTH_MQTT_LOGGING_LEVEL = 1;
 const int CONFIG_SMOOTH_SOCKET_DISPATCHER_STACK_SIZE = 20480;
 const int CONFIG_SMOOTH_TIMER_SERVICE_STACK_SIZE = 3072;
+const int CONFIG_SMOOTH_CRYPTO_WORKER_STACK_SIZE = 8192;
 const int CONFIG_LWIP_MAX_SOCKETS = 10;
+
+// Response compression with zlib, which the host build links against.
+#define CONFIG_SMOOTH_HTTP_COMPRESSION 1
 #endif
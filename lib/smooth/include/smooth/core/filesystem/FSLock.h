@@ -17,6 +17,7 @@ limitations under the License.
 
 #pragma once
 
+#include <memory>
 #include <mutex>
 #include <condition_variable>
 
@@ -33,6 +34,11 @@ namespace smooth::core::filesystem
 
             FSLock();
 
+            /// Acquires a lock without waiting, for files kept open for a longer time. One lock is always
+            /// left for the blocking constructor, so that files kept open can't hold up short-lived users.
+            /// \return The lock, or nullptr if all but one of the allowed files are already open.
+            static std::unique_ptr<FSLock> try_acquire();
+
             virtual ~FSLock() final;
 
             FSLock(const FSLock&) = delete;
@@ -44,6 +50,9 @@ namespace smooth::core::filesystem
             FSLock& operator=(const FSLock&&) = delete;
 
         private:
+            /// Used by try_acquire(), which has already counted the lock.
+            explicit FSLock(std::adopt_lock_t);
+
             static std::mutex lock;
             static std::condition_variable cv;
             static int max;
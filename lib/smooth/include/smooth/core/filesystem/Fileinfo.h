@@ -59,7 +59,7 @@ namespace smooth::core::filesystem
                 return modified;
             }
 
-            const std::chrono::system_clock::time_point last_modified_point()
+            const std::chrono::system_clock::time_point last_modified_point() const
             {
                 return std::chrono::system_clock::from_time_t(modified);
             }
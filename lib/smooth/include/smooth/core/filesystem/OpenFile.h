@@ -0,0 +1,77 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <sys/types.h>
+#include "smooth/core/filesystem/Path.h"
+#include "smooth/core/filesystem/FSLock.h"
+
+namespace smooth::core::filesystem
+{
+    /// A read-only file that is kept open and read by position, e.g. to stream its content
+    /// without reopening it for each chunk. Counts towards the FSLock limit for as long as it is open.
+    class OpenFile
+    {
+        public:
+            /// Opens a file, provided the limit of concurrently open files has not been reached.
+            /// \return The file, or nullptr if it could not be opened.
+            static std::shared_ptr<OpenFile> open(const Path& path);
+
+            ~OpenFile();
+
+            OpenFile(const OpenFile&) = delete;
+
+            OpenFile& operator=(const OpenFile&) = delete;
+
+            int get_descriptor() const
+            {
+                return fd;
+            }
+
+            std::size_t size() const
+            {
+                return file_size;
+            }
+
+            /// Gets the size of the file as it is now, which is less than size() if the file
+            /// has been truncated since it was opened.
+            std::size_t current_size() const;
+
+            /// Reads up to length bytes, starting at offset.
+            /// \return The number of bytes read, or -1 on error.
+            ssize_t read(std::size_t offset, uint8_t* target, std::size_t length) const;
+
+            /// Maps the entire file into memory, allowing it to be read without copying. Reading mapped
+            /// memory beyond the end of a file raises SIGBUS, so check current_size() before reading.
+            /// \return The start of the file, or nullptr when the file cannot be mapped, has been truncated
+            /// or memory mapping is not supported (ESP).
+            const uint8_t* map();
+
+        private:
+            OpenFile(int fd, std::size_t size, std::unique_ptr<FSLock> lock);
+
+            int fd;
+            std::size_t file_size;
+            std::unique_ptr<FSLock> lock;
+            void* mapping{ nullptr };
+            bool map_attempted{ false };
+    };
+}
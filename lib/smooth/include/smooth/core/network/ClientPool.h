@@ -17,10 +17,13 @@ limitations under the License.
 
 #pragma once
 
-#include <deque>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <vector>
-#include <algorithm>
 
 namespace smooth::core
 {
@@ -29,77 +32,301 @@ namespace smooth::core
 
 namespace smooth::core::network
 {
+    /// Snapshot of the state of a ClientPool, used to monitor pool pressure.
+    struct ClientPoolStatistics
+    {
+        /// Number of clients currently allocated, idle or in use.
+        std::size_t allocated{ 0 };
+        /// Number of clients waiting in the pool.
+        std::size_t idle{ 0 };
+        /// Number of clients currently serving a connection.
+        std::size_t in_use{ 0 };
+        /// Highest number of clients simultaneously in use.
+        std::size_t peak_in_use{ 0 };
+        /// Estimated number of bytes used by the allocated clients.
+        std::size_t memory_used{ 0 };
+        /// Number of clients created beyond the initial minimum.
+        uint32_t grown{ 0 };
+        /// Number of clients released to get back towards the minimum.
+        uint32_t shrunk{ 0 };
+        /// Number of times a client was requested when none was available.
+        uint32_t exhausted{ 0 };
+        /// Number of idle connections closed to make room for new ones.
+        uint32_t evicted{ 0 };
+    };
+
     /// ClientPool holds a number of client instances which are requested by the
     /// owning ServerSocket. When a client is done, i.e. connection closed, it
     /// is returned to the pool for reuse at a later time.
+    /// Both checkout and return are O(1); each client remembers its slot in the
+    /// in-use list so it can be swap-removed without searching. Idle clients are
+    /// handed out in LIFO order to favour recently used (cache-warm) buffers.
+    ///
+    /// The pool is elastic; it starts with a minimum number of clients and grows on
+    /// demand up to a maximum, as long as the estimated memory use stays within the
+    /// memory budget. Returned clients exceeding the minimum are released. When the pool
+    /// is exhausted, the client which has been idle (see ServerClient::set_idle()) for
+    /// the longest time can be evicted to make room for a new connection.
     /// \tparam Client The client type held by the pool.
     template<typename Client>
     class ClientPool
     {
         public:
+            /// Creates a pool of fixed size, i.e. with the minimum and maximum client count
+            /// both set to count and no memory limit.
             ClientPool(smooth::core::Task& task, int count);
 
+            /// Changes the limits of the pool. Idle clients above the new minimum are released.
+            /// \param min_count The number of clients kept allocated at all times.
+            /// \param max_count The maximum number of clients.
+            /// \param memory_budget The maximum number of bytes the clients may use, 0 for no limit.
+            /// \param client_size The estimated number of bytes used by each client.
+            void set_limits(int min_count, int max_count, std::size_t memory_budget, std::size_t client_size);
+
+            /// Returns true when there is no idle client and the pool can't grow.
             bool empty() const
             {
-                return clients.empty();
+                std::lock_guard<std::mutex> lock(guard);
+
+                return clients.empty() && !can_grow();
             }
 
             std::shared_ptr<Client> get();
 
             void return_client(std::shared_ptr<Client> client);
 
+            /// Sets the arguments the clients are created with. No clients are created until fill()
+            /// is called, allowing the limits to be set first.
             template<typename... Args>
-            void create_clients(Args ... args);
+            void set_client_arguments(Args ... args);
+
+            /// Creates clients until the minimum number of clients are allocated.
+            void fill();
+
+            /// Closes the connection of the client which has been idle the longest. The client
+            /// is returned to the pool once the disconnect has been processed.
+            /// \return true if a client was evicted, false if no client is idle.
+            bool evict_idle_client();
+
+            /// Called by clients when they become idle or busy.
+            void set_idle(Client& client, bool idle);
+
+            ClientPoolStatistics get_statistics() const;
 
         private:
+            bool can_grow() const
+            {
+                auto allocated = clients.size() + in_use.size();
+
+                return allocated < max_count
+                       && (memory_budget == 0 || (allocated + 1) * client_size <= memory_budget);
+            }
+
+            void update_statistics()
+            {
+                stats.idle = clients.size();
+                stats.in_use = in_use.size();
+                stats.allocated = stats.idle + stats.in_use;
+                stats.peak_in_use = std::max(stats.peak_in_use, stats.in_use);
+                stats.memory_used = stats.allocated * client_size;
+            }
+
             smooth::core::Task& task;
-            std::deque<std::shared_ptr<Client>> clients{};
+            std::size_t min_count;
+            std::size_t max_count;
+            std::size_t memory_budget{ 0 };
+            std::size_t client_size{ 0 };
+            std::function<std::shared_ptr<Client>()> factory{};
+            std::vector<std::shared_ptr<Client>> clients{};
             std::vector<std::shared_ptr<Client>> in_use{};
+
+            // Released clients are kept until the next pool operation since the release
+            // typically happens from within the client's own event handler.
+            std::vector<std::shared_ptr<Client>> retired{};
+            ClientPoolStatistics stats{};
+            mutable std::mutex guard{};
     };
 
     template<typename Client>
     std::shared_ptr<Client> ClientPool<Client>::get()
     {
+        std::lock_guard<std::mutex> lock(guard);
+        retired.clear();
+
         std::shared_ptr<Client> c{};
 
         if (!clients.empty())
         {
-            c = *clients.begin();
+            c = std::move(clients.back());
+            clients.pop_back();
+        }
+        else if (factory && can_grow())
+        {
+            c = factory();
+            stats.grown++;
+        }
+        else
+        {
+            stats.exhausted++;
+        }
+
+        if (c)
+        {
+            c->pool_slot = in_use.size();
+            c->idle = false;
+            c->evicting = false;
             in_use.push_back(c);
-            clients.pop_front();
         }
 
+        update_statistics();
+
         return c;
     }
 
     template<typename Client>
     void ClientPool<Client>::return_client(std::shared_ptr<Client> client)
     {
-        client->reset();
-        auto found = std::find(in_use.begin(), in_use.end(), client);
+        std::lock_guard<std::mutex> lock(guard);
+        retired.clear();
+
+        auto slot = client->pool_slot;
 
-        if (found != in_use.end())
+        // Only clients currently checked out may be returned, otherwise the same client
+        // could end up in the idle list twice.
+        if (slot < in_use.size() && in_use[slot] == client)
         {
-            in_use.erase(found);
+            client->reset();
+            client->idle = false;
+            client->evicting = false;
+
+            if (slot != in_use.size() - 1)
+            {
+                in_use[slot] = std::move(in_use.back());
+                in_use[slot]->pool_slot = slot;
+            }
+
+            in_use.pop_back();
+
+            if (clients.size() + in_use.size() >= min_count && !clients.empty())
+            {
+                // Enough clients are kept around already, let this one go.
+                retired.push_back(std::move(client));
+                stats.shrunk++;
+            }
+            else
+            {
+                clients.push_back(std::move(client));
+            }
         }
 
-        clients.push_back(std::move(client));
+        update_statistics();
+    }
+
+    template<typename Client>
+    bool ClientPool<Client>::evict_idle_client()
+    {
+        std::shared_ptr<Client> candidate{};
+
+        {
+            std::lock_guard<std::mutex> lock(guard);
+
+            for (const auto& c : in_use)
+            {
+                if (c->idle && !c->evicting
+                    && (!candidate || c->idle_since < candidate->idle_since))
+                {
+                    candidate = c;
+                }
+            }
+
+            if (candidate)
+            {
+                candidate->evicting = true;
+                stats.evicted++;
+            }
+        }
+
+        if (candidate)
+        {
+            candidate->evict();
+        }
+
+        return static_cast<bool>(candidate);
+    }
+
+    template<typename Client>
+    void ClientPool<Client>::set_idle(Client& client, bool idle)
+    {
+        std::lock_guard<std::mutex> lock(guard);
+
+        if (idle && !client.idle)
+        {
+            client.idle_since = std::chrono::steady_clock::now();
+        }
+
+        client.idle = idle;
+    }
+
+    template<typename Client>
+    ClientPoolStatistics ClientPool<Client>::get_statistics() const
+    {
+        std::lock_guard<std::mutex> lock(guard);
+
+        return stats;
     }
 
     template<typename Client>
     ClientPool<Client>::ClientPool(smooth::core::Task& task, int count)
-            : task(task)
+            : task(task),
+              min_count(static_cast<std::size_t>(count)),
+              max_count(static_cast<std::size_t>(count))
     {
-        in_use.reserve(static_cast<typename decltype(in_use)::size_type>(count));
+        clients.reserve(max_count);
+        in_use.reserve(max_count);
+    }
+
+    template<typename Client>
+    void ClientPool<Client>::set_limits(int min, int max, std::size_t budget, std::size_t size)
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        max_count = static_cast<std::size_t>(std::max(1, max));
+        min_count = std::min(static_cast<std::size_t>(std::max(0, min)), max_count);
+        memory_budget = budget;
+        client_size = size;
+
+        while (!clients.empty() && clients.size() + in_use.size() > min_count)
+        {
+            retired.push_back(std::move(clients.back()));
+            clients.pop_back();
+            stats.shrunk++;
+        }
+
+        clients.reserve(max_count);
+        in_use.reserve(max_count);
+        update_statistics();
     }
 
     template<typename Client>
     template<typename... ProtocolArguments>
-    void ClientPool<Client>::create_clients(ProtocolArguments... args)
+    void ClientPool<Client>::set_client_arguments(ProtocolArguments... args)
+    {
+        std::lock_guard<std::mutex> lock(guard);
+
+        factory = [this, args...]() {
+                      return std::make_shared<Client>(task, *this, args...);
+                  };
+    }
+
+    template<typename Client>
+    void ClientPool<Client>::fill()
     {
-        for (std::size_t i = 0; i < in_use.capacity(); ++i)
+        std::lock_guard<std::mutex> lock(guard);
+
+        while (factory && clients.size() + in_use.size() < min_count)
         {
-            clients.emplace_back(std::make_shared<Client>(task, *this, args...));
+            clients.emplace_back(factory());
         }
+
+        update_statistics();
     }
 }
@@ -26,6 +26,7 @@ limitations under the License.
 #include <netinet/in.h>
 #endif
 
+#include <atomic>
 #include <chrono>
 #include "smooth/core/timer/ElapsedTime.h"
 
@@ -72,6 +73,11 @@ namespace smooth::core::network
                 return receive_timeout;
             }
 
+            void set_cork(bool corked) override
+            {
+                cork_requested = corked;
+            }
+
         protected:
             bool set_non_blocking();
 
@@ -81,6 +87,16 @@ namespace smooth::core::network
 
             bool is_connected() const override;
 
+            bool has_pending_data() const override
+            {
+                return false;
+            }
+
+            bool is_offloaded() const override
+            {
+                return false;
+            }
+
             bool has_send_expired() const override
             {
                 return send_timeout.count() > 0
@@ -103,5 +119,6 @@ namespace smooth::core::network
             std::chrono::milliseconds receive_timeout{ 0 };
             smooth::core::timer::ElapsedTime elapsed_send_time{};
             smooth::core::timer::ElapsedTime elapsed_receive_time{};
+            std::atomic<bool> cork_requested{ false };
     };
 }
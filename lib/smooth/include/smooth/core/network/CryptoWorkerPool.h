@@ -0,0 +1,75 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "smooth/config_constants.h"
+
+namespace smooth::core::network
+{
+    /// A pool of worker threads for CPU heavy cryptographic work, such as the public key operations
+    /// of a TLS handshake, which would otherwise stall the SocketDispatcher and thereby all other sockets.
+    /// The number of jobs queued or running at any one time is bounded, which also bounds the memory held
+    /// by connections in the middle of a handshake. TLS handshakes using the same MBedTLSContext are
+    /// serialized by it, so more than one worker only helps when several contexts are in use.
+    class CryptoWorkerPool
+    {
+        public:
+            /// \param worker_count Number of worker threads.
+            /// \param max_concurrent Maximum number of jobs queued or running at the same time.
+            /// \param stack_size Stack size of each worker (only used on ESP).
+            CryptoWorkerPool(std::size_t worker_count, std::size_t max_concurrent, uint32_t stack_size = CONFIG_SMOOTH_CRYPTO_WORKER_STACK_SIZE);
+
+            ~CryptoWorkerPool();
+
+            CryptoWorkerPool(const CryptoWorkerPool&) = delete;
+
+            CryptoWorkerPool& operator=(const CryptoWorkerPool&) = delete;
+
+            /// Queues a job for execution on a worker thread.
+            /// \return false if the pool is at its concurrency limit, in which case the job is not queued
+            /// and the caller should try again later.
+            bool try_submit(std::function<void()> job);
+
+            /// Gets the number of jobs currently queued or running.
+            std::size_t get_in_flight() const;
+
+            std::size_t get_max_concurrent() const
+            {
+                return max_concurrent;
+            }
+
+        private:
+            void run();
+
+            mutable std::mutex guard{};
+            std::condition_variable work_available{};
+            std::deque<std::function<void()>> jobs{};
+            std::vector<std::thread> workers{};
+            std::size_t in_flight{ 0 };
+            std::size_t max_concurrent;
+            bool stopping{ false };
+    };
+}
@@ -0,0 +1,155 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#include <sys/socket.h>
+#pragma GCC diagnostic pop
+#include "IPacketDisassembly.h"
+#include "InetAddress.h"
+#include "IPv4.h"
+#include "IPv6.h"
+
+namespace smooth::core::network
+{
+    /// A single datagram with room for up to Size bytes of payload. The payload is stored inline
+    /// so that datagrams can be pooled and copied without heap allocations.
+    /// When received, the address is the source of the datagram; when sent it is the destination
+    /// (if not set, the default destination of the DatagramSocket is used).
+    /// \tparam Size Maximum payload size, in bytes.
+    template<int Size>
+    class Datagram
+        : public IPacketDisassembly
+    {
+        public:
+            static constexpr int max_size = Size;
+
+            Datagram() = default;
+
+            Datagram(const uint8_t* payload, int length)
+            {
+                set_payload(payload, length);
+            }
+
+            int get_send_length() override
+            {
+                return length;
+            }
+
+            const uint8_t* get_data() override
+            {
+                return buffer.data();
+            }
+
+            uint8_t* data()
+            {
+                return buffer.data();
+            }
+
+            [[nodiscard]] const uint8_t* data() const
+            {
+                return buffer.data();
+            }
+
+            [[nodiscard]] int size() const
+            {
+                return length;
+            }
+
+            void set_size(int new_size)
+            {
+                length = std::max(0, std::min(new_size, Size));
+            }
+
+            /// Copies the payload into the datagram, truncating it to max_size bytes.
+            void set_payload(const uint8_t* payload, int payload_length)
+            {
+                set_size(payload_length);
+                std::copy(payload, payload + length, buffer.begin());
+            }
+
+            [[nodiscard]] bool has_address() const
+            {
+                return address_length > 0;
+            }
+
+            void set_address(const sockaddr_storage& addr, socklen_t len)
+            {
+                address = addr;
+                address_length = len;
+            }
+
+            void set_address(InetAddress& addr)
+            {
+                address_length = std::min(addr.get_socket_address_length(),
+                                          static_cast<socklen_t>(sizeof(address)));
+                memcpy(&address, addr.get_socket_address(), address_length);
+            }
+
+            sockaddr* get_socket_address()
+            {
+                return reinterpret_cast<sockaddr*>(&address);
+            }
+
+            [[nodiscard]] const sockaddr_storage& get_address() const
+            {
+                return address;
+            }
+
+            [[nodiscard]] socklen_t get_address_length() const
+            {
+                return address_length;
+            }
+
+            /// Creates an InetAddress from the address of the datagram.
+            /// \return The address, or nullptr if the datagram has no address.
+            [[nodiscard]] std::shared_ptr<InetAddress> get_source() const
+            {
+                std::shared_ptr<InetAddress> res{};
+
+                if (has_address())
+                {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-align"
+                    if (address.ss_family == AF_INET)
+                    {
+                        res = std::make_shared<IPv4>(*reinterpret_cast<const sockaddr_in*>(&address));
+                    }
+                    else
+                    {
+                        res = std::make_shared<IPv6>(*reinterpret_cast<const sockaddr_in6*>(&address));
+                    }
+#pragma GCC diagnostic pop
+                }
+
+                return res;
+            }
+
+        private:
+            std::array<uint8_t, static_cast<std::size_t>(Size)> buffer{};
+            int length{ 0 };
+            sockaddr_storage address{};
+            socklen_t address_length{ 0 };
+    };
+}
@@ -0,0 +1,74 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include "IPacketAssembly.h"
+#include "Datagram.h"
+
+namespace smooth::core::network
+{
+    /// Protocol for message oriented communication via DatagramSocket; every datagram is a complete packet.
+    /// \tparam Size Maximum payload size of each datagram, e.g. 1472 bytes to stay within a
+    /// 1500 byte Ethernet MTU on IPv4.
+    template<int Size>
+    class DatagramProtocol
+        : public IPacketAssembly<DatagramProtocol<Size>, Datagram<Size>>
+    {
+        public:
+            using packet_type = Datagram<Size>;
+
+            int get_wanted_amount(packet_type& packet) override
+            {
+                return Size - packet.size();
+            }
+
+            void data_received(packet_type& packet, int length) override
+            {
+                packet.set_size(packet.size() + length);
+                complete = true;
+            }
+
+            uint8_t* get_write_pos(packet_type& packet) override
+            {
+                return packet.data() + packet.size();
+            }
+
+            bool is_complete(packet_type& /*packet*/) const override
+            {
+                return complete;
+            }
+
+            bool is_error() override
+            {
+                return false;
+            }
+
+            void packet_consumed() override
+            {
+                complete = false;
+            }
+
+            void reset() override
+            {
+                complete = false;
+            }
+
+        private:
+            bool complete{ false };
+    };
+}
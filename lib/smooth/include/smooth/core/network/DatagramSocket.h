@@ -0,0 +1,549 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <chrono>
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#include <sys/socket.h>
+#pragma GCC diagnostic pop
+#include <sys/uio.h>
+#include "CommonSocket.h"
+#include "BufferContainer.h"
+#include "Socket.h"
+#include "smooth/core/network/SocketDispatcher.h"
+#include "smooth/core/network/event/TransmitBufferEmptyEvent.h"
+#include "smooth/core/network/event/DataAvailableEvent.h"
+#include "smooth/core/network/event/ConnectionStatusEvent.h"
+#include "smooth/core/logging/log.h"
+#include "smooth/core/util/create_protected.h"
+
+namespace smooth::core::network
+{
+    /// DatagramSocket is used to perform UDP communication. Each packet put in the transmit buffer is
+    /// sent as a single datagram and each received datagram is delivered as a single packet.
+    /// On Linux, up to BufferSize datagrams are received and sent per system call (recvmmsg/sendmmsg);
+    /// on other platforms one datagram per call is used.
+    /// The socket is considered connected as soon as it is bound, i.e. the application gets a
+    /// ConnectionStatusEvent followed by a TransmitBufferEmptyEvent once it is ready for use.
+    /// \tparam Protocol The protocol, typically DatagramProtocol<Size>.
+    /// \tparam BufferSize Number of datagrams that the receive and transmit buffers can hold, also
+    /// the maximum number of datagrams per batch. The BufferContainer must be created with the same size.
+    /// \tparam Packet The packet type, typically Datagram<Size>.
+    template<typename Protocol, int BufferSize = 8, typename Packet = typename Protocol::packet_type>
+    class DatagramSocket
+        : public CommonSocket
+    {
+        public:
+            using Container = BufferContainer<Protocol, BufferSize>;
+
+            /// Creates a socket for datagram communication.
+            /// \param buffer_container The buffers and queues used by the socket.
+            /// \param send_timeout The amount of time outgoing datagrams may wait to be sent.
+            /// \param receive_timeout The maximum amount of time between received datagrams. If exceeded, the socket
+            /// is closed. Zero means no limit, which is the normal case for datagram sockets.
+            /// \return a std::shared_ptr pointing to the new socket.
+            static std::shared_ptr<DatagramSocket<Protocol, BufferSize, Packet>>
+            create(std::weak_ptr<Container> buffer_container,
+                   std::chrono::milliseconds send_timeout = DefaultSendTimeout,
+                   std::chrono::milliseconds receive_timeout = std::chrono::milliseconds{ 0 });
+
+            ~DatagramSocket() override = default;
+
+            /// Binds the socket to the given local address and starts it.
+            /// \param bind_to The local address and port to receive datagrams on. Use port 0 for an ephemeral port.
+            /// \return true if the socket could be started.
+            bool start(std::shared_ptr<InetAddress> bind_to) override;
+
+            /// Sets the destination used for datagrams that don't have an address of their own.
+            /// Must be called before start().
+            /// \param destination The remote address.
+            /// \return true if the address could be resolved.
+            bool set_default_destination(std::shared_ptr<InetAddress> destination);
+
+            bool send(const Packet& packet);
+
+            bool is_server() const override
+            {
+                return false;
+            }
+
+        protected:
+            explicit DatagramSocket(std::weak_ptr<Container> buffer_container);
+
+            void readable(ISocketBackOff& ops) override;
+
+            void writable() override;
+
+            bool internal_start() override;
+
+            bool has_data_to_transmit() override
+            {
+                bool res = connected;
+
+                if (res)
+                {
+                    res = tx_sent < tx_count;
+
+                    if (!res)
+                    {
+                        auto cont = get_container_or_close();
+                        res = cont && !cont->get_tx_buffer().is_empty();
+                    }
+                }
+
+                return res;
+            }
+
+            void publish_connected_status() override;
+
+            void stop_internal() override;
+
+            std::shared_ptr<Container> get_container_or_close();
+
+            std::weak_ptr<Container> buffers{};
+        private:
+            bool create_socket();
+
+            void receive(const std::shared_ptr<Container>& container, int count);
+
+            void transmit();
+
+            void deliver(const std::shared_ptr<Container>& container, Packet& packet);
+
+            std::shared_ptr<InetAddress> destination{};
+            std::array<Packet, static_cast<std::size_t>(BufferSize)> rx_batch{};
+            std::array<Packet, static_cast<std::size_t>(BufferSize)> tx_batch{};
+            std::array<sockaddr_storage, static_cast<std::size_t>(BufferSize)> rx_addresses{};
+            int tx_count{ 0 };
+            int tx_sent{ 0 };
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+            std::array<mmsghdr, static_cast<std::size_t>(BufferSize)> messages{};
+            std::array<iovec, static_cast<std::size_t>(BufferSize)> vectors{};
+#endif
+    };
+
+    template<typename Protocol, int BufferSize, typename Packet>
+    std::shared_ptr<DatagramSocket<Protocol, BufferSize, Packet>> DatagramSocket<Protocol, BufferSize, Packet>::create(
+        std::weak_ptr<Container> buffer_container,
+        std::chrono::milliseconds send_timeout,
+        std::chrono::milliseconds receive_timeout)
+    {
+        auto s = smooth::core::util::create_protected_shared<DatagramSocket<Protocol, BufferSize, Packet>>(
+            buffer_container);
+        s->set_send_timeout(send_timeout);
+        s->set_receive_timeout(receive_timeout);
+
+        return s;
+    }
+
+    template<typename Protocol, int BufferSize, typename Packet>
+    DatagramSocket<Protocol, BufferSize, Packet>::DatagramSocket(std::weak_ptr<Container> buffer_container)
+            : CommonSocket(),
+              buffers(std::move(buffer_container))
+    {
+        auto cont = buffers.lock();
+
+        if (cont)
+        {
+            cont->clear();
+        }
+    }
+
+    template<typename Protocol, int BufferSize, typename Packet>
+    bool DatagramSocket<Protocol, BufferSize, Packet>::start(std::shared_ptr<InetAddress> bind_to)
+    {
+        bool res = false;
+
+        if (!active)
+        {
+            elapsed_send_time.stop_and_zero();
+            this->ip = bind_to;
+
+            res = ip->resolve_ip() && ip->is_valid();
+
+            if (res)
+            {
+                SocketDispatcher::instance().perform_op(SocketOperation::Op::Start, shared_from_this());
+            }
+        }
+
+        return res;
+    }
+
+    template<typename Protocol, int BufferSize, typename Packet>
+    bool DatagramSocket<Protocol, BufferSize, Packet>::set_default_destination(
+        std::shared_ptr<InetAddress> remote)
+    {
+        auto res = remote->resolve_ip() && remote->is_valid();
+
+        if (res)
+        {
+            destination = std::move(remote);
+        }
+
+        return res;
+    }
+
+    template<typename Protocol, int BufferSize, typename Packet>
+    bool DatagramSocket<Protocol, BufferSize, Packet>::create_socket()
+    {
+        bool res = false;
+
+        if (socket_id < 0)
+        {
+            socket_id = socket(ip->get_protocol_family(), SOCK_DGRAM, 0);
+
+            if (socket_id == INVALID_SOCKET)
+            {
+                loge("Failed to create socket");
+            }
+            else
+            {
+                int reuse = 1;
+                res = set_non_blocking()
+                      && setsockopt(socket_id, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) == 0;
+
+                if (!res)
+                {
+                    loge("Failed to set socket options");
+                }
+            }
+        }
+        else
+        {
+            res = true;
+        }
+
+        return res;
+    }
+
+    template<typename Protocol, int BufferSize, typename Packet>
+    bool DatagramSocket<Protocol, BufferSize, Packet>::internal_start()
+    {
+        if (!is_active())
+        {
+            if (create_socket())
+            {
+                if (bind(socket_id, ip->get_socket_address(), ip->get_socket_address_length()) == 0)
+                {
+                    // Not yet connected; the first writable() publishes the connection status.
+                    active = true;
+                }
+                else
+                {
+                    loge("Failed to bind socket");
+                }
+            }
+
+            if (!active)
+            {
+                stop("Not active");
+            }
+        }
+
+        return active;
+    }
+
+    template<typename Protocol, int BufferSize, typename Packet>
+    void DatagramSocket<Protocol, BufferSize, Packet>::readable(ISocketBackOff& ops)
+    {
+        if (is_active())
+        {
+            auto cont = get_container_or_close();
+
+            if (cont)
+            {
+                // Datagrams beyond the budget stay queued in the kernel until the next iteration.
+                auto budget = static_cast<int>(std::min(ops.get_io_budget().packets,
+                                                        static_cast<std::size_t>(BufferSize)));
+                auto count = std::min(cont->get_rx_buffer().available_slots(), budget);
+
+                if (count > 0)
+                {
+                    receive(cont, count);
+                }
+            }
+        }
+    }
+
+    template<typename Protocol, int BufferSize, typename Packet>
+    void DatagramSocket<Protocol, BufferSize, Packet>::receive(const std::shared_ptr<Container>& container,
+                                                               int count)
+    {
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+        for (std::size_t i = 0; i < static_cast<std::size_t>(count); ++i)
+        {
+            vectors[i].iov_base = rx_batch[i].data();
+            vectors[i].iov_len = static_cast<size_t>(Packet::max_size);
+            messages[i].msg_hdr = msghdr{};
+            messages[i].msg_hdr.msg_name = &rx_addresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        auto received = recvmmsg(socket_id, messages.data(), static_cast<unsigned int>(count), 0, nullptr);
+
+        if (received < 0)
+        {
+            if (errno != EWOULDBLOCK)
+            {
+                stop("Error during receive");
+            }
+        }
+        else
+        {
+            for (std::size_t i = 0; i < static_cast<std::size_t>(received); ++i)
+            {
+                auto& hdr = messages[i].msg_hdr;
+
+                if (hdr.msg_flags & MSG_TRUNC)
+                {
+                    Log::warning("DatagramSocket", "Dropping truncated datagram, larger than {} bytes",
+                                 Packet::max_size);
+                }
+                else
+                {
+                    rx_batch[i].set_size(static_cast<int>(messages[i].msg_len));
+                    rx_batch[i].set_address(rx_addresses[i], hdr.msg_namelen);
+                    deliver(container, rx_batch[i]);
+                }
+            }
+        }
+#else
+        bool more = true;
+
+        for (std::size_t i = 0; more && i < static_cast<std::size_t>(count); ++i)
+        {
+            auto& packet = rx_batch[i];
+            socklen_t address_length = sizeof(sockaddr_storage);
+            auto read_count = recvfrom(socket_id,
+                                       packet.data(),
+                                       static_cast<size_t>(Packet::max_size),
+                                       0,
+                                       reinterpret_cast<sockaddr*>(&rx_addresses[i]),
+                                       &address_length);
+
+            more = read_count >= 0;
+
+            if (more)
+            {
+                packet.set_size(socket_cast(read_count));
+                packet.set_address(rx_addresses[i], address_length);
+                deliver(container, packet);
+            }
+            else if (errno != EWOULDBLOCK)
+            {
+                stop("Error during receive");
+            }
+        }
+#endif
+
+        elapsed_receive_time.start();
+    }
+
+    template<typename Protocol, int BufferSize, typename Packet>
+    void DatagramSocket<Protocol, BufferSize, Packet>::deliver(const std::shared_ptr<Container>& container,
+                                                               Packet& packet)
+    {
+        auto& rx = container->get_rx_buffer();
+
+        if (rx.put(packet))
+        {
+            event::DataAvailableEvent<Protocol> d(&rx);
+            container->get_data_available()->push(d);
+        }
+    }
+
+    template<typename Protocol, int BufferSize, typename Packet>
+    void DatagramSocket<Protocol, BufferSize, Packet>::writable()
+    {
+        if (is_active())
+        {
+            if (!connected && socket_id >= 0)
+            {
+                // Bound and ready for use
+                connected = true;
+                publish_connected_status();
+            }
+
+            auto cont = get_container_or_close();
+
+            if (connected && cont)
+            {
+                elapsed_send_time.stop_and_zero();
+
+                if (tx_sent == tx_count)
+                {
+                    auto& tx = cont->get_tx_buffer();
+                    tx_sent = 0;
+                    tx_count = 0;
+
+                    while (tx_count < BufferSize && tx.take(tx_batch[static_cast<std::size_t>(tx_count)]))
+                    {
+                        ++tx_count;
+                    }
+                }
+
+                if (tx_count > 0)
+                {
+                    transmit();
+                }
+
+                if (tx_sent < tx_count)
+                {
+                    elapsed_send_time.start();
+                }
+                else
+                {
+                    // Let the application know it may send more datagrams.
+                    smooth::core::network::event::TransmitBufferEmptyEvent event(shared_from_this());
+                    cont->get_tx_empty()->push(event);
+                }
+            }
+        }
+    }
+
+    template<typename Protocol, int BufferSize, typename Packet>
+    void DatagramSocket<Protocol, BufferSize, Packet>::transmit()
+    {
+        auto address_of = [this](Packet& packet, socklen_t& length) -> sockaddr* {
+                              sockaddr* addr = nullptr;
+                              length = 0;
+
+                              if (packet.has_address())
+                              {
+                                  addr = packet.get_socket_address();
+                                  length = packet.get_address_length();
+                              }
+                              else if (destination)
+                              {
+                                  addr = destination->get_socket_address();
+                                  length = destination->get_socket_address_length();
+                              }
+
+                              return addr;
+                          };
+
+        int sent = -1;
+
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+        auto pending = static_cast<std::size_t>(tx_count - tx_sent);
+
+        for (std::size_t i = 0; i < pending; ++i)
+        {
+            auto& packet = tx_batch[static_cast<std::size_t>(tx_sent) + i];
+            vectors[i].iov_base = packet.data();
+            vectors[i].iov_len = static_cast<size_t>(packet.size());
+            messages[i].msg_hdr = msghdr{};
+            messages[i].msg_hdr.msg_name = address_of(packet, messages[i].msg_hdr.msg_namelen);
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        sent = sendmmsg(socket_id, messages.data(), static_cast<unsigned int>(pending), SEND_FLAGS);
+#else
+        auto& packet = tx_batch[static_cast<std::size_t>(tx_sent)];
+        socklen_t length = 0;
+        auto addr = address_of(packet, length);
+
+        sent = ::sendto(socket_id, packet.data(), static_cast<size_t>(packet.size()), SEND_FLAGS, addr, length) < 0
+               ? -1 : 1;
+#endif
+
+        if (sent < 0)
+        {
+            if (errno != EWOULDBLOCK)
+            {
+                // Unlike a stream, a datagram socket remains usable after a failed send (e.g. unreachable
+                // destination), so drop the offending datagram and carry on.
+                loge("Failure during send, dropping datagram");
+                ++tx_sent;
+            }
+        }
+        else
+        {
+            tx_sent += sent;
+        }
+    }
+
+    template<typename Protocol, int BufferSize, typename Packet>
+    void DatagramSocket<Protocol, BufferSize, Packet>::stop_internal()
+    {
+        if (active)
+        {
+            log("Socket stopping");
+            active = false;
+            connected = false;
+            tx_sent = 0;
+            tx_count = 0;
+            elapsed_send_time.stop_and_zero();
+        }
+    }
+
+    template<typename Protocol, int BufferSize, typename Packet>
+    void DatagramSocket<Protocol, BufferSize, Packet>::publish_connected_status()
+    {
+        if (is_connected())
+        {
+            log("Bound");
+        }
+        else
+        {
+            log("Unbound");
+        }
+
+        auto cont = get_container_or_close();
+
+        if (cont)
+        {
+            cont->get_connection_status()->push(event::ConnectionStatusEvent(shared_from_this(), is_connected()));
+        }
+    }
+
+    template<typename Protocol, int BufferSize, typename Packet>
+    std::shared_ptr<typename DatagramSocket<Protocol, BufferSize, Packet>::Container>
+    DatagramSocket<Protocol, BufferSize, Packet>::get_container_or_close()
+    {
+        auto cont = buffers.lock();
+
+        if (!cont)
+        {
+            stop("Could not get buffer container");
+        }
+
+        return cont;
+    }
+
+    template<typename Protocol, int BufferSize, typename Packet>
+    bool DatagramSocket<Protocol, BufferSize, Packet>::send(const Packet& packet)
+    {
+        bool res = false;
+        auto cont = buffers.lock();
+
+        if (cont)
+        {
+            res = cont->get_tx_buffer().put(packet);
+        }
+
+        return res;
+    }
+}
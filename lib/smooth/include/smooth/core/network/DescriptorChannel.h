@@ -0,0 +1,78 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#ifndef ESP_PLATFORM
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+namespace smooth::core::network
+{
+    /// Holds file descriptors being passed over a Unix domain socket (SCM_RIGHTS), e.g. memfds
+    /// with large buffers that are cheaper to hand over than to copy through the socket.
+    /// The application and the socket are on different threads; all methods are thread safe.
+    class DescriptorChannel
+    {
+        public:
+            /// Maximum number of descriptors attached to a single message.
+            static constexpr std::size_t MaxPerMessage = 16;
+
+            /// \param max_queued Maximum number of descriptors queued in each direction.
+            explicit DescriptorChannel(std::size_t max_queued = 32);
+
+            ~DescriptorChannel();
+
+            DescriptorChannel(const DescriptorChannel&) = delete;
+
+            DescriptorChannel& operator=(const DescriptorChannel&) = delete;
+
+            /// Queues a descriptor for sending. The descriptor is duplicated so the caller keeps
+            /// ownership of its own copy. Descriptors are attached to the next outgoing data, i.e.
+            /// they are delivered along with the first byte of the next packet sent.
+            /// \param fd The descriptor to send.
+            /// \return true if queued, false if the queue is full or the descriptor could not be duplicated.
+            bool send(int fd);
+
+            /// Takes the next received descriptor, in the order they were received.
+            /// \return The descriptor, now owned by the caller, or -1 if there is none.
+            int receive();
+
+            /// Closes all queued descriptors.
+            void clear();
+
+            /// Copies up to MaxPerMessage outgoing descriptors to target, without removing them.
+            /// \return The number of descriptors copied.
+            std::size_t peek_outgoing(int* target);
+
+            /// Removes and closes the given number of outgoing descriptors once they have been sent.
+            void outgoing_sent(std::size_t count);
+
+            /// Queues a received descriptor, taking ownership of it.
+            void add_incoming(int fd);
+
+        private:
+            std::size_t max_queued;
+            std::deque<int> outgoing{};
+            std::deque<int> incoming{};
+            std::mutex guard{};
+    };
+}
+
+#endif
@@ -0,0 +1,39 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include "smooth/core/filesystem/OpenFile.h"
+
+namespace smooth::core::network
+{
+    /// A part of an open file that is sent as-is after a packet's own data, without first being
+    /// copied into the packet. See IPacketDisassembly::get_file_region().
+    struct FileRegion
+    {
+        std::shared_ptr<smooth::core::filesystem::OpenFile> file{};
+        std::size_t offset{ 0 };
+        std::size_t length{ 0 };
+
+        bool is_empty() const
+        {
+            return !file || length == 0;
+        }
+    };
+}
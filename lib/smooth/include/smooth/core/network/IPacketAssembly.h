@@ -64,6 +64,24 @@ namespace smooth::core::network
             /// Resets the protocol
             virtual void reset() = 0;
 
+            /// Must return the number of bytes received as part of an earlier packet that belong
+            /// to the packets that follow it, such as pipelined requests.
+            /// \return Number of buffered bytes
+            virtual int get_buffered_amount() const
+            {
+                return 0;
+            }
+
+            /// Moves buffered bytes, in the order they were received, to the write position of the
+            /// current packet. data_received() is then called with the returned number of bytes.
+            /// \param target Where to write the data
+            /// \param length The maximum number of bytes to write, see get_wanted_amount()
+            /// \return The number of bytes written
+            virtual int take_buffered(uint8_t* /*target*/, int /*length*/)
+            {
+                return 0;
+            }
+
             virtual ~IPacketAssembly() = default;
     };
 }
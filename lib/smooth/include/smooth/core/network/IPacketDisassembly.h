@@ -19,6 +19,8 @@ limitations under the License.
 
 namespace smooth::core::network
 {
+    struct FileRegion;
+
     /// Interface for packets that can be disassembled into a series of bytes
     class IPacketDisassembly
     {
@@ -31,6 +33,15 @@ namespace smooth::core::network
             /// \return The read position
             virtual const uint8_t* get_data() = 0;
 
+            /// May return a region of an open file to send after the data returned by get_data(), e.g. the
+            /// body of a file response. The socket sends it straight from the file (using sendfile() where
+            /// available), so the file content is never copied into the packet.
+            /// \return The region, or nullptr if there is none.
+            virtual const FileRegion* get_file_region()
+            {
+                return nullptr;
+            }
+
             virtual ~IPacketDisassembly() = default;
     };
 }
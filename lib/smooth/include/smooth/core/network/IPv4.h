@@ -37,6 +37,10 @@ namespace smooth::core::network
 
             explicit IPv4(const sockaddr_in& addr);
 
+            /// Replaces the address, allowing an instance to be reused for a new peer.
+            /// \param addr The new address
+            void set_address(const sockaddr_in& addr);
+
             bool resolve_ip() override;
 
             sockaddr* get_socket_address() override;
@@ -41,6 +41,10 @@ namespace smooth::core::network
 
             explicit IPv6(const sockaddr_in6& address);
 
+            /// Replaces the address, allowing an instance to be reused for a new peer.
+            /// \param address The new address
+            void set_address(const sockaddr_in6& address);
+
             sockaddr* get_socket_address() override;
 
             socklen_t get_socket_address_length() const override;
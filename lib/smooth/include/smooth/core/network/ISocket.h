@@ -88,11 +88,28 @@ namespace smooth::core::network
 
             [[nodiscard]] virtual std::chrono::milliseconds get_send_timeout() const = 0;
 
+            /// Requests that partial segments are held back (corked) until released, so that data sent
+            /// as several packets leaves as full segments. Only has an effect on sockets whose options
+            /// enable corking, see SocketOptions::cork.
+            /// \param corked true to hold back partial segments, false to release them.
+            virtual void set_cork(bool corked) = 0;
+
         protected:
             [[nodiscard]] virtual bool is_connected() const = 0;
 
             virtual void readable(ISocketBackOff& ops) = 0;
 
+            /// Must return true when the socket holds received data that it has not yet been able to deliver
+            /// to the application, and which the underlying socket will not signal as readable since it
+            /// has already been read from it (e.g. decrypted TLS data). The socket is then considered
+            /// readable regardless of the state of the underlying socket.
+            [[nodiscard]] virtual bool has_pending_data() const = 0;
+
+            /// Must return true while another thread works on the socket (e.g. a TLS handshake step running
+            /// on a CryptoWorkerPool). The socket is then neither polled nor serviced, and its timeouts are
+            /// not checked, until the work is done.
+            [[nodiscard]] virtual bool is_offloaded() const = 0;
+
             virtual void writable() = 0;
 
             [[nodiscard]] virtual bool has_data_to_transmit() = 0;
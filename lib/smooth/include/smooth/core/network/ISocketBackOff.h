@@ -18,9 +18,22 @@ limitations under the License.
 #pragma once
 
 #include <chrono>
+#include <cstddef>
 
 namespace smooth::core::network
 {
+    /// Limits how much a socket may read each time it is serviced, so that a busy socket cannot monopolise
+    /// the SocketDispatcher. A socket that stops because of its budget while it still has data available
+    /// is serviced again on the next iteration, after the other ready sockets have had their turn.
+    struct IOBudget
+    {
+        /// Maximum number of bytes read.
+        std::size_t bytes{ 16 * 1024 };
+
+        /// Maximum number of complete packets delivered to the application.
+        std::size_t packets{ 8 };
+    };
+
     class ISocketBackOff
     {
         public:
@@ -29,5 +42,8 @@ namespace smooth::core::network
             // When called, tells the socket dispatcher to hold off all events for the
             // given socket id for the specified duration.
             virtual void back_off(int socket_id, std::chrono::milliseconds duration) = 0;
+
+            // Gets the amount of data a socket may read in its current turn.
+            [[nodiscard]] virtual IOBudget get_io_budget() const = 0;
     };
 }
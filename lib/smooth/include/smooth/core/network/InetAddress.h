@@ -51,7 +51,46 @@ namespace smooth::core::network
             /// \return Protocol family
             int get_protocol_family() const
             {
-                return get_address_family() == AF_INET ? PF_INET : PF_INET6;
+                auto family = get_address_family();
+                auto res = family == AF_INET ? PF_INET : PF_INET6;
+#ifndef ESP_PLATFORM
+
+                if (family == AF_UNIX)
+                {
+                    res = PF_UNIX;
+                }
+#endif
+
+                return res;
+            }
+
+            /// Gets the socket type to use for this address, e.g. SOCK_STREAM
+            /// \return Socket type
+            virtual int get_socket_type() const
+            {
+                return SOCK_STREAM;
+            }
+
+            /// Returns a value indicating if the address is a local (Unix domain) address,
+            /// i.e. one for which TCP specific options do not apply.
+            /// \return true or false
+            bool is_local() const
+            {
+#ifdef ESP_PLATFORM
+
+                return false;
+#else
+
+                return get_address_family() == AF_UNIX;
+#endif
+            }
+
+            /// Called by server sockets before binding to the address, allowing the address
+            /// to clean up any leftovers from a previous instance.
+            /// \return false if the address must not be bound to.
+            virtual bool prepare_bind()
+            {
+                return true;
             }
 
             /// Gets the socket address
@@ -17,13 +17,23 @@ limitations under the License.
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <mbedtls/net_sockets.h>
 #include <mbedtls/ssl.h>
 #include <mbedtls/entropy.h>
 #include <mbedtls/ctr_drbg.h>
 #include <mbedtls/debug.h>
+#if defined(MBEDTLS_SSL_CACHE_C)
+#include <mbedtls/ssl_cache.h>
+#endif
+#if defined(MBEDTLS_SSL_TICKET_C)
+#include <mbedtls/ssl_ticket.h>
+#endif
 
 namespace smooth::core::network
 {
@@ -32,6 +42,14 @@ namespace smooth::core::network
     class SSLContext
     {
         public:
+            /// Outcome of a client's attempt to resume a session, as seen by a server.
+            enum class Resumption
+            {
+                None,
+                Hit,
+                Miss
+            };
+
             SSLContext()
             {
                 mbedtls_ssl_init(&ssl);
@@ -52,29 +70,204 @@ namespace smooth::core::network
                 return static_cast<mbedtls_ssl_states>(ssl.state);
             }
 
+            /// Runs a single handshake step, see mbedtls_ssl_handshake_step().
+            int handshake_step()
+            {
+                if (get_state() == MBEDTLS_SSL_HELLO_REQUEST)
+                {
+                    resumption = Resumption::None;
+                }
+
+                std::unique_lock<std::mutex> lock{};
+
+                if (key_guard)
+                {
+                    lock = std::unique_lock<std::mutex>(*key_guard);
+                }
+
+                // The session cache and ticket callbacks run on this thread, within the step.
+                in_handshake = this;
+                auto res = mbedtls_ssl_handshake_step(&ssl);
+                in_handshake = nullptr;
+
+                return res;
+            }
+
+            /// Sets the mutex held during each handshake step, which serializes the use of keys shared
+            /// with other contexts, see MBedTLSContext.
+            void set_key_guard(std::mutex& guard)
+            {
+                key_guard = &guard;
+            }
+
+            [[nodiscard]] Resumption get_resumption() const
+            {
+                return resumption;
+            }
+
+            /// Records the outcome of a session lookup for the handshake step running on the calling thread.
+            /// A handshake may look up both a ticket and a cached session; it is a hit if either is found.
+            static void note_resumption(bool hit)
+            {
+                if (in_handshake && in_handshake->resumption != Resumption::Hit)
+                {
+                    in_handshake->resumption = hit ? Resumption::Hit : Resumption::Miss;
+                }
+            }
+
         private:
+            static inline thread_local SSLContext* in_handshake{ nullptr };
             mbedtls_ssl_context ssl{};
+            std::mutex* key_guard{ nullptr };
+            Resumption resumption{ Resumption::None };
+    };
+
+    /// Counters for TLS session resumption; a hit is a resumed session, a miss an offered
+    /// session that could not be resumed and so required a full handshake.
+    struct TLSSessionStatistics
+    {
+        uint32_t hits{ 0 };
+        uint32_t misses{ 0 };
+    };
+
+    /// Server side session resumption settings.
+    struct TLSSessionOptions
+    {
+        /// Number of sessions kept in the server's session cache, 0 disables the cache.
+        int cache_size{ 16 };
+
+        /// How long a session may be resumed, via either the cache or a ticket.
+        std::chrono::seconds lifetime{ std::chrono::hours{ 1 } };
+
+        /// Issue session tickets (RFC 5077), which lets clients resume without the server keeping state.
+        bool tickets{ true };
     };
 
+    /// Holds a client's TLS session between connections so that a reconnect can resume it
+    /// instead of doing a full handshake. Keep one instance per server being connected to.
+    class TLSSession
+    {
+        public:
+            TLSSession();
+
+            ~TLSSession();
+
+            TLSSession(const TLSSession&) = delete;
+
+            TLSSession& operator=(const TLSSession&) = delete;
+
+            /// Offers the saved session, if any, to the server. Must be called before the handshake.
+            void restore(SSLContext& context);
+
+            /// Saves the session of a completed handshake and records whether it was resumed.
+            void save(SSLContext& context);
+
+            /// Forgets the saved session.
+            void clear();
+
+            TLSSessionStatistics get_statistics() const
+            {
+                return TLSSessionStatistics{ hits, misses };
+            }
+
+        private:
+            std::mutex guard{};
+            mbedtls_ssl_session session{};
+            bool valid{ false };
+            bool offered{ false };
+            std::atomic<uint32_t> hits{ 0 };
+            std::atomic<uint32_t> misses{ 0 };
+    };
+
+    /// Holds a parsed TLS configuration (certificates, keys, RNG) and creates the per-connection
+    /// SSLContexts from it. One instance can be shared by all connections of one or more servers.
+    /// Released contexts are reset and kept for reuse, which avoids reallocating their large
+    /// record buffers for each connection. The shared state (RNG, session cache and tickets) is
+    /// guarded so that handshakes may run on several threads, see CryptoWorkerPool. The keys are
+    /// shared too, and mbedTLS doesn't protect them against concurrent use: the private key's RSA
+    /// blinding values and the lazily built ECP tables of both the private key and the CA certificates
+    /// are updated while in use. The handshake steps of the contexts created from one instance
+    /// therefore run one at a time; handshakes of different instances may still run in parallel.
     class MBedTLSContext
     {
         public:
+#ifdef ESP_PLATFORM
+            // An idle context keeps its record buffers, tens of kB each; pooling is opt-in on devices.
+            static constexpr std::size_t DefaultContextPoolSize = 0;
+#else
+            static constexpr std::size_t DefaultContextPoolSize = 4;
+#endif
+
             MBedTLSContext();
 
             ~MBedTLSContext();
 
             bool init_client(const std::vector<unsigned char>& ca_certificates);
 
+            /// Initializes the context for server use.
+            /// \param session_options Settings for the session cache and session tickets that allow clients
+            /// to resume previous sessions with an abbreviated handshake.
             bool init_server(const std::vector<unsigned char>& ca_certificates,
                              const std::vector<unsigned char>& server_certificate,
                              const std::vector<unsigned char>& private_key,
-                             const std::vector<unsigned char>& password);
+                             const std::vector<unsigned char>& password,
+                             const TLSSessionOptions& session_options = TLSSessionOptions{});
 
+            /// Gets an SSLContext set up with this configuration, reusing a pooled context when available.
             std::unique_ptr<SSLContext> create_context();
 
+            /// Returns a context to the pool. The context is reset (mbedtls_ssl_session_reset) so that it
+            /// is ready for a new connection; if the pool is full or the reset fails it is freed.
+            void recycle_context(std::unique_ptr<SSLContext> context);
+
+            /// Sets the maximum number of idle contexts kept for reuse, see DefaultContextPoolSize.
+            /// For a server, use SecureServerSocket::get_tls_context() to reach its configuration.
+            void set_context_pool_size(std::size_t size);
+
+            /// Limits the TLS record size via the max_fragment_length extension (RFC 6066), requested by
+            /// clients and honoured by servers. Together with MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH this reduces
+            /// the per-connection RAM use; the maximum buffer sizes themselves are set at compile time
+            /// (MBEDTLS_SSL_IN_CONTENT_LEN/MBEDTLS_SSL_OUT_CONTENT_LEN).
+            /// Must be called before any contexts are created.
+            /// \param length 512, 1024, 2048 or 4096 bytes; any other value removes the limit.
+            /// \return true if the limit was applied.
+            bool set_max_fragment_length(int length);
+
+            /// Gets the server's session resumption counters, covering both the session cache and tickets.
+            TLSSessionStatistics get_session_statistics() const
+            {
+                return TLSSessionStatistics{ session_hits, session_misses };
+            }
+
+            /// Counts the session resumption outcome of a completed server handshake.
+            void count_resumption(const SSLContext& context)
+            {
+                if (context.get_resumption() != SSLContext::Resumption::None)
+                {
+                    ++(context.get_resumption() == SSLContext::Resumption::Hit ? session_hits : session_misses);
+                }
+            }
+
         private:
             int common_init(bool server);
 
+            int init_session_resumption(const TLSSessionOptions& options);
+
+            static int random(void* ctx, unsigned char* output, size_t length);
+
+            static int cache_get(void* ctx, mbedtls_ssl_session* session);
+
+            static int cache_set(void* ctx, const mbedtls_ssl_session* session);
+
+            static int ticket_write(void* ctx,
+                                    const mbedtls_ssl_session* session,
+                                    unsigned char* start,
+                                    const unsigned char* end,
+                                    size_t* length,
+                                    uint32_t* lifetime);
+
+            static int ticket_parse(void* ctx, mbedtls_ssl_session* session, unsigned char* buf, size_t length);
+
             int load_certificate(const std::vector<unsigned char>& cert, mbedtls_x509_crt& target);
 
             mbedtls_entropy_context entropy{};
@@ -84,5 +277,19 @@ namespace smooth::core::network
             mbedtls_x509_crt ca_chain{};
             mbedtls_x509_crt server_cert{};
             mbedtls_pk_context pk_key{};
+#if defined(MBEDTLS_SSL_CACHE_C)
+            mbedtls_ssl_cache_context cache{};
+#endif
+#if defined(MBEDTLS_SSL_TICKET_C)
+            mbedtls_ssl_ticket_context ticket{};
+#endif
+            std::atomic<uint32_t> session_hits{ 0 };
+            std::atomic<uint32_t> session_misses{ 0 };
+            std::mutex rng_guard{};
+            std::mutex resumption_guard{};
+            std::mutex pool_guard{};
+            std::mutex key_guard{};
+            std::vector<std::unique_ptr<SSLContext>> context_pool{};
+            std::size_t context_pool_size{ DefaultContextPoolSize };
     };
 }
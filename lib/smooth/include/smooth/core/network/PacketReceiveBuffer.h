@@ -76,6 +76,39 @@ namespace smooth::core::network
                 }
             }
 
+            /// Returns a value indicating if the protocol holds data from an earlier read that is yet
+            /// to be assembled, see assemble_buffered().
+            bool has_buffered_data()
+            {
+                std::unique_lock<std::mutex> lock(guard);
+
+                return proto->get_buffered_amount() > 0;
+            }
+
+            /// Continues assembly of the current packet using data buffered by the protocol instead of
+            /// data read from the socket.
+            /// \return The number of bytes assembled.
+            int assemble_buffered()
+            {
+                std::unique_lock<std::mutex> lock(guard);
+
+                auto wanted = proto->get_wanted_amount(current_item);
+                auto length = proto->take_buffered(proto->get_write_pos(current_item), wanted);
+
+                if (length > 0)
+                {
+                    proto->data_received(current_item, length);
+
+                    if (proto->is_complete(current_item))
+                    {
+                        buffer.put(current_item);
+                        in_progress = false;
+                    }
+                }
+
+                return length;
+            }
+
             bool is_packet_complete() override
             {
                 std::unique_lock<std::mutex> lock(guard);
@@ -90,6 +123,30 @@ namespace smooth::core::network
                 return buffer.get(target);
             }
 
+            /// Puts a complete packet directly into the buffer, bypassing assembly. Used by
+            /// message oriented sockets where each read yields exactly one packet.
+            /// \return true if the packet could be stored, false if the buffer is full.
+            bool put(const Packet& item)
+            {
+                std::unique_lock<std::mutex> lock(guard);
+                bool res = !buffer.is_full();
+
+                if (res)
+                {
+                    buffer.put(item);
+                }
+
+                return res;
+            }
+
+            /// Returns the number of packets that can be stored before the buffer is full.
+            int available_slots()
+            {
+                std::unique_lock<std::mutex> lock(guard);
+
+                return buffer.available_slots();
+            }
+
             void clear() override
             {
                 std::unique_lock<std::mutex> lock(guard);
@@ -19,6 +19,7 @@ limitations under the License.
 
 #include "smooth/core/util/CircularBuffer.h"
 #include "IPacketSendBuffer.h"
+#include "FileRegion.h"
 #include <mutex>
 
 namespace smooth::core::network
@@ -74,19 +75,55 @@ namespace smooth::core::network
             void data_has_been_sent(int length) override
             {
                 std::lock_guard<std::mutex> lock(guard);
-                bytes_sent += length;
 
-                if (bytes_sent >= current_item.get_send_length())
+                if (bytes_sent < current_item.get_send_length())
+                {
+                    bytes_sent += length;
+                }
+                else
+                {
+                    file_bytes_sent += static_cast<std::size_t>(length);
+                }
+
+                if (bytes_sent >= current_item.get_send_length() && remaining_file_length() == 0)
                 {
                     in_progress = false;
                 }
             }
 
+            /// Returns true when the packet's own data has been sent and what remains is its file region.
+            bool is_sending_file_region()
+            {
+                std::lock_guard<std::mutex> lock(guard);
+
+                return in_progress
+                       && bytes_sent >= current_item.get_send_length()
+                       && remaining_file_length() > 0;
+            }
+
+            /// Gets the part of the current packet's file region that is yet to be sent.
+            FileRegion get_file_region_to_send()
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                FileRegion res{};
+                auto region = current_item.get_file_region();
+
+                if (region)
+                {
+                    res.file = region->file;
+                    res.offset = region->offset + file_bytes_sent;
+                    res.length = region->length - file_bytes_sent;
+                }
+
+                return res;
+            }
+
             void prepare_next_packet() override
             {
                 std::lock_guard<std::mutex> lock(guard);
                 in_progress = buffer.get(current_item);
                 bytes_sent = 0;
+                file_bytes_sent = 0;
             }
 
             void clear() override
@@ -95,6 +132,7 @@ namespace smooth::core::network
                 buffer.clear();
                 in_progress = false;
                 bytes_sent = 0;
+                file_bytes_sent = 0;
             }
 
             bool is_empty() override
@@ -104,10 +142,36 @@ namespace smooth::core::network
                 return !in_progress && buffer.is_empty();
             }
 
+            /// Gets the number of packets waiting to be sent, including the one in progress.
+            int get_queued_count()
+            {
+                std::lock_guard<std::mutex> lock(guard);
+
+                return buffer.available_items() + (in_progress ? 1 : 0);
+            }
+
+            /// Takes the next whole packet out of the buffer, bypassing the byte-wise
+            /// send progress. Used by message oriented sockets which send each packet in one go.
+            /// \return true if a packet was retrieved.
+            bool take(Packet& target)
+            {
+                std::lock_guard<std::mutex> lock(guard);
+
+                return !in_progress && buffer.get(target);
+            }
+
         private:
+            std::size_t remaining_file_length()
+            {
+                auto region = current_item.get_file_region();
+
+                return region && region->file ? region->length - file_bytes_sent : 0;
+            }
+
             Packet current_item{};
             std::mutex guard{};
             int bytes_sent = 0;
+            std::size_t file_bytes_sent = 0;
             bool in_progress = false;
             smooth::core::util::CircularBuffer<Packet, Size> buffer{};
     };
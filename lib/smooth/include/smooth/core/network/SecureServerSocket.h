@@ -22,6 +22,7 @@ limitations under the License.
 #include <vector>
 #include "smooth/core/network/SecureSocket.h"
 #include "smooth/core/network/MbedTLSContext.h"
+#include "smooth/core/network/CryptoWorkerPool.h"
 #include "smooth/core/util/create_protected.h"
 
 namespace smooth::core::network
@@ -42,6 +43,36 @@ namespace smooth::core::network
                    const std::vector<unsigned char>& password,
                    ProtocolArguments... proto_args);
 
+            /// Creates a server using an existing TLS configuration, which may be shared with other servers.
+            template<typename... ProtocolArguments>
+            static std::shared_ptr<ServerSocket<Client, Protocol, ClientContext>>
+            create(smooth::core::Task& task,
+                   int max_client_count,
+                   int backlog,
+                   std::shared_ptr<MBedTLSContext> tls_context,
+                   ProtocolArguments... proto_args);
+
+            /// Gets the TLS configuration used by the server, e.g. to tune or share it.
+            const std::shared_ptr<MBedTLSContext>& get_tls_context() const
+            {
+                return server_context;
+            }
+
+            /// Runs the TLS handshakes of accepted connections on the given pool instead of on the
+            /// SocketDispatcher. The pool may be shared by several servers; its concurrency limit bounds
+            /// the number of handshake steps, and thereby their memory, in progress at any one time.
+            /// Must be called before the server is started.
+            void set_handshake_pool(std::shared_ptr<CryptoWorkerPool> pool)
+            {
+                handshake_pool = std::move(pool);
+            }
+
+            /// Gets the TLS session resumption counters of the server.
+            TLSSessionStatistics get_session_statistics() const
+            {
+                return server_context->get_session_statistics();
+            }
+
         protected:
             template<typename... ProtocolArguments>
             SecureServerSocket(smooth::core::Task& task,
@@ -57,13 +88,30 @@ namespace smooth::core::network
                                                                     backlog,
                                                                     proto_args...)
             {
-                server_context.init_server(ca_chain, own_cert, private_key, password);
+                server_context->init_server(ca_chain, own_cert, private_key, password);
             }
 
-            void readable(ISocketBackOff& ops) override;
+            template<typename... ProtocolArguments>
+            SecureServerSocket(smooth::core::Task& task,
+                               int max_client_count,
+                               int backlog,
+                               std::shared_ptr<MBedTLSContext> tls_context,
+                               ProtocolArguments... proto_args)
+                    : ServerSocket<Client, Protocol, ClientContext>(task,
+                                                                    max_client_count,
+                                                                    backlog,
+                                                                    proto_args...),
+                      server_context(std::move(tls_context))
+            {
+            }
+
+            void attach_client(const std::shared_ptr<Client>& client,
+                               const std::shared_ptr<InetAddress>& ip,
+                               int accepted_socket_id) override;
 
         private:
-            MBedTLSContext server_context{};
+            std::shared_ptr<MBedTLSContext> server_context{ std::make_shared<MBedTLSContext>() };
+            std::shared_ptr<CryptoWorkerPool> handshake_pool{};
     };
 
     template<typename Client, typename Protocol, typename ClientContext>
@@ -91,21 +139,41 @@ namespace smooth::core::network
     }
 
     template<typename Client, typename Protocol, typename ClientContext>
-    void SecureServerSocket<Client, Protocol, ClientContext>::readable(ISocketBackOff& ops)
+    template<typename... ProtocolArguments>
+    std::shared_ptr<ServerSocket<Client, Protocol, ClientContext>> SecureServerSocket<Client, Protocol,
+                                                                                      ClientContext>::create(
+        smooth::core::Task& task,
+        int max_client_count,
+        int backlog,
+        std::shared_ptr<MBedTLSContext> tls_context,
+        ProtocolArguments... proto_args)
+    {
+        return smooth::core::util::create_protected_shared<SecureServerSocket<Client, Protocol, ClientContext>>(
+                task,
+                max_client_count,
+                backlog,
+                tls_context,
+                proto_args...);
+    }
+
+    template<typename Client, typename Protocol, typename ClientContext>
+    void SecureServerSocket<Client, Protocol, ClientContext>::attach_client(const std::shared_ptr<Client>& client,
+                                                                            const std::shared_ptr<InetAddress>& ip,
+                                                                            int accepted_socket_id)
     {
-        const auto& [ip, accepted_socket_id] = this->accept_request(ops);
-
-        if (ip)
-        {
-            auto client = this->pool.get();
-            auto socket = SecureSocket<Protocol>::create(ip,
-                                                         accepted_socket_id,
-                                                         client->get_buffers(),
-                                                         server_context.create_context(),
-                                                         client->get_send_timeout());
-
-            client->set_client_context(this->client_context);
-            client->set_socket(socket);
-        }
+        auto socket = SecureSocket<Protocol>::create(ip,
+                                                     accepted_socket_id,
+                                                     client->get_buffers(),
+                                                     server_context->create_context(),
+                                                     client->get_send_timeout(),
+                                                     std::chrono::milliseconds{ 0 },
+                                                     this->options);
+
+        // Hand the SSL context back for reuse once the connection is done with it.
+        socket->set_context_owner(server_context);
+        socket->set_handshake_pool(handshake_pool);
+
+        client->set_client_context(this->client_context);
+        client->set_socket(socket);
     }
 }
@@ -17,9 +17,11 @@ limitations under the License.
 
 #pragma once
 
+#include <atomic>
 #include <sys/socket.h>
 #include "Socket.h"
 #include "MbedTLSContext.h"
+#include "CryptoWorkerPool.h"
 #include <mbedtls/error.h>
 
 namespace smooth::core::network
@@ -82,7 +84,8 @@ namespace smooth::core::network
             create(std::weak_ptr<BufferContainer<Protocol>> buffer_container,
                    std::unique_ptr<SSLContext> secure_context,
                    std::chrono::milliseconds send_timeout = std::chrono::milliseconds(5000),
-                   std::chrono::milliseconds receive_timeout = std::chrono::milliseconds{ 0 });
+                   std::chrono::milliseconds receive_timeout = std::chrono::milliseconds{ 0 },
+                   const SocketOptions& options = SocketOptions{});
 
             static std::shared_ptr<SecureSocket<Protocol>>
             create(std::shared_ptr<smooth::core::network::InetAddress> ip,
@@ -90,10 +93,50 @@ namespace smooth::core::network
                    std::weak_ptr<BufferContainer<Protocol>> buffer_container,
                    std::unique_ptr<SSLContext> secure_context,
                    std::chrono::milliseconds timeout = std::chrono::milliseconds(5000),
-                   std::chrono::milliseconds receive_timeout = std::chrono::milliseconds{ 0 });
+                   std::chrono::milliseconds receive_timeout = std::chrono::milliseconds{ 0 },
+                   const SocketOptions& options = SocketOptions{});
+
+            ~SecureSocket() override
+            {
+                auto owner = context_owner.lock();
+
+                if (owner)
+                {
+                    owner->recycle_context(std::move(secure_context));
+                }
+            }
 
             void set_existing_socket(const std::shared_ptr<InetAddress>& address, int socket_id) override;
 
+            /// Sets the configuration the SSLContext was created from; the context is returned to it for reuse
+            /// when the socket is destroyed.
+            void set_context_owner(std::weak_ptr<MBedTLSContext> owner)
+            {
+                context_owner = std::move(owner);
+            }
+
+            /// Runs the handshake steps on the given pool instead of on the SocketDispatcher, so that the
+            /// public key operations of one handshake do not stall all other sockets. When the pool is at its
+            /// concurrency limit, the step is retried on a later dispatcher iteration. Steps of sockets sharing
+            /// an MBedTLSContext run one at a time even on a pool with several workers, see MBedTLSContext.
+            /// Must be called before the socket is started.
+            void set_handshake_pool(std::weak_ptr<CryptoWorkerPool> pool)
+            {
+                handshake_pool = std::move(pool);
+            }
+
+            /// Sets the session to resume and which is updated once the handshake completes, allowing
+            /// a client to reconnect without a full handshake. Must be called before the socket is started.
+            void set_tls_session(std::shared_ptr<TLSSession> session)
+            {
+                tls_session = std::move(session);
+
+                if (tls_session)
+                {
+                    tls_session->restore(*secure_context);
+                }
+            }
+
         protected:
             SecureSocket(std::weak_ptr<BufferContainer<Protocol>> buffer_container,
                          std::unique_ptr<SSLContext> context)
@@ -111,19 +154,52 @@ namespace smooth::core::network
 
             void writable() override;
 
+            /// Reads and decrypts data until mbedTLS has no more available, the receive buffer is full or the
+            /// read budget given by the SocketDispatcher is used up.
             void read_data(const std::shared_ptr<BufferContainer<Protocol>>& container) override;
 
             void write_data(const std::shared_ptr<BufferContainer<Protocol>>& container) override;
 
             bool has_data_to_transmit() override;
 
+            bool has_pending_data() const override
+            {
+                return pending_decrypted_data || Socket<Protocol, Packet>::has_pending_data();
+            }
+
+            bool is_offloaded() const override
+            {
+                return handshake_offloaded.load(std::memory_order_acquire);
+            }
+
+            void stop_internal() override
+            {
+                pending_decrypted_data = false;
+                last_handshake_result = 0;
+                Socket<Protocol, Packet>::stop_internal();
+            }
+
         private:
             static constexpr const char* tag = "SecureSocket";
             std::unique_ptr<SSLContext> secure_context{};
+            bool pending_decrypted_data{ false };
+            IOBudget read_budget{};
+            std::shared_ptr<TLSSession> tls_session{};
+            std::weak_ptr<MBedTLSContext> context_owner{};
+            std::weak_ptr<CryptoWorkerPool> handshake_pool{};
+            std::atomic<bool> handshake_offloaded{ false };
+            bool awaiting_handshake_result{ false };
+            int offloaded_handshake_result{ 0 };
+            int last_handshake_result{ 0 };
 
             bool is_handshake_complete(const SSLContext& ctx) const;
 
-            void do_handshake_step();
+            /// \param data_available true when called because the underlying socket is readable.
+            void do_handshake_step(bool data_available);
+
+            void offload_handshake_step(CryptoWorkerPool& pool);
+
+            void handle_handshake_result(int res);
 
             bool needs_tls_transfer(int code) const
             {
@@ -143,11 +219,10 @@ namespace smooth::core::network
         std::weak_ptr<BufferContainer<Protocol>> buffer_container,
         std::unique_ptr<SSLContext> context,
         std::chrono::milliseconds send_timeout,
-        std::chrono::milliseconds receive_timeout)
+        std::chrono::milliseconds receive_timeout,
+        const SocketOptions& options)
     {
-        auto s = create(buffer_container, std::move(context));
-        s->set_send_timeout(send_timeout);
-        s->set_receive_timeout(receive_timeout);
+        auto s = create(buffer_container, std::move(context), send_timeout, receive_timeout, options);
         s->set_existing_socket(ip, socket_id);
 
         return s;
@@ -158,12 +233,14 @@ namespace smooth::core::network
         std::weak_ptr<BufferContainer<Protocol>> buffer_container,
         std::unique_ptr<SSLContext> context,
         std::chrono::milliseconds send_timeout,
-        std::chrono::milliseconds receive_timeout)
+        std::chrono::milliseconds receive_timeout,
+        const SocketOptions& options)
     {
         auto s = smooth::core::util::create_protected_shared<SecureSocket<Protocol, Packet>>(buffer_container,
         std::move(context));
         s->set_send_timeout(send_timeout);
         s->set_receive_timeout(receive_timeout);
+        s->set_socket_options(options);
 
         return s;
     }
@@ -178,17 +255,18 @@ namespace smooth::core::network
     template<typename Protocol, typename Packet>
     void SecureSocket<Protocol, Packet>::readable(ISocketBackOff& ops)
     {
-        if (this->is_active())
+        if (this->is_active() && !is_offloaded())
         {
             this->elapsed_receive_time.start();
 
             if (is_handshake_complete(*secure_context))
             {
+                read_budget = ops.get_io_budget();
                 Socket<Protocol, Packet>::readable(ops);
             }
             else
             {
-                do_handshake_step();
+                do_handshake_step(true);
             }
         }
     }
@@ -196,7 +274,7 @@ namespace smooth::core::network
     template<typename Protocol, typename Packet>
     void SecureSocket<Protocol, Packet>::writable()
     {
-        if (this->is_active() && this->signal_new_connection())
+        if (this->is_active() && !is_offloaded() && this->signal_new_connection())
         {
             this->elapsed_send_time.start();
 
@@ -206,7 +284,7 @@ namespace smooth::core::network
             }
             else
             {
-                do_handshake_step();
+                do_handshake_step(false);
             }
         }
     }
@@ -217,20 +295,18 @@ namespace smooth::core::network
         // How much data to assemble the current packet?
 
         auto& rx = container->get_rx_buffer();
+        pending_decrypted_data = false;
+        std::size_t bytes_read = 0;
+        std::size_t packets_read = 0;
 
         do
         {
             if (rx.is_full())
             {
                 // Receiver is full. Since mbedtls_ssl_read() moves data from the underlying socket, we get no
-                // no more readable-events on it, which results in the SocketDispatcher no longer calling
-                // readable() on this socket, in turn preventing this function be called again to read the
-                // remaining decrypted data. As such we have to wait a bit so the application consumes at
-                // least one packet.
-                std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
-
-                // Likely better solution: Set an artificial readable-indicator on the socket telling the
-                // SocketDispatcher there are more data to be read, forcing a readable()-call on the socket.
+                // more readable-events on it. Flag the remaining decrypted data as pending so that the
+                // SocketDispatcher keeps calling readable() until the application has consumed a packet.
+                pending_decrypted_data = true;
             }
             else
             {
@@ -260,6 +336,7 @@ namespace smooth::core::network
                 else
                 {
                     rx.data_received(read_amount);
+                    bytes_read += static_cast<std::size_t>(read_amount);
 
                     if (rx.is_error())
                     {
@@ -272,12 +349,23 @@ namespace smooth::core::network
                         event::DataAvailableEvent<Protocol> d(&rx);
                         container->get_data_available()->push(d);
                         rx.prepare_new_packet();
+                        ++packets_read;
                     }
                 }
             }
         }
         while (this->is_active()
+               && !pending_decrypted_data
+               && !rx.has_buffered_data() // Buffered data must be assembled before anything decrypted later.
+               && bytes_read < read_budget.bytes
+               && packets_read < read_budget.packets
                && mbedtls_ssl_get_bytes_avail(*secure_context) > 0);
+
+        if (this->is_active() && mbedtls_ssl_get_bytes_avail(*secure_context) > 0)
+        {
+            // Budget used up; continue on the next iteration once other sockets have been serviced.
+            pending_decrypted_data = true;
+        }
     }
 
     template<typename Protocol, typename Packet>
@@ -286,45 +374,64 @@ namespace smooth::core::network
         this->elapsed_receive_time.start();
 
         auto& tx = container->get_tx_buffer();
-        auto data_to_send = tx.get_data_to_send();
-
-        auto length = tx.get_remaining_data_length();
+        const uint8_t* data_to_send = nullptr;
+        int length = 0;
+        bool file_error = false;
 
-        auto amount_sent = 0;
+        if (tx.is_sending_file_region())
+        {
+            // Encrypted straight from the memory mapped file, or a reused buffer, rather than a copy in the packet.
+            data_to_send = this->get_file_data(tx.get_file_region_to_send(), length);
+            file_error = data_to_send == nullptr;
+        }
+        else
+        {
+            data_to_send = tx.get_data_to_send();
+            length = tx.get_remaining_data_length();
+        }
 
-        do
+        if (file_error)
         {
-            amount_sent = mbedtls_ssl_write(*secure_context,
-                                            data_to_send,
-                                            static_cast<size_t>(length));
+            this->stop("Error reading file");
+        }
+        else
+        {
+            auto amount_sent = 0;
 
-            if (!needs_tls_transfer(amount_sent))
+            do
             {
-                if (amount_sent > 0)
-                {
-                    tx.data_has_been_sent(amount_sent);
+                amount_sent = mbedtls_ssl_write(*secure_context,
+                                                data_to_send,
+                                                static_cast<size_t>(length));
 
-                    // Was a complete packet sent?
-                    if (tx.is_in_progress())
+                if (!needs_tls_transfer(amount_sent))
+                {
+                    if (amount_sent > 0)
                     {
-                        this->elapsed_send_time.start();
+                        tx.data_has_been_sent(amount_sent);
+
+                        // Was a complete packet sent?
+                        if (tx.is_in_progress())
+                        {
+                            this->elapsed_send_time.start();
+                        }
+                        else
+                        {
+                            // Let the application know it may now send another packet.
+                            event::TransmitBufferEmptyEvent event(this->shared_from_this());
+                            container->get_tx_empty()->push(event);
+                        }
                     }
-                    else
+
+                    if (amount_sent < 0 && !needs_tls_transfer(amount_sent))
                     {
-                        // Let the application know it may now send another packet.
-                        event::TransmitBufferEmptyEvent event(this->shared_from_this());
-                        container->get_tx_empty()->push(event);
+                        log_mbedtls_error("SecureSocket", "mbedtls_ssl_write", amount_sent);
+                        this->stop("Error writing");
                     }
                 }
-
-                if (amount_sent < 0 && !needs_tls_transfer(amount_sent))
-                {
-                    log_mbedtls_error("SecureSocket", "mbedtls_ssl_write", amount_sent);
-                    this->stop("Error writing");
-                }
             }
+            while (needs_tls_transfer(amount_sent));
         }
-        while (needs_tls_transfer(amount_sent));
     }
 
     template<typename Protocol, typename Packet>
@@ -334,12 +441,62 @@ namespace smooth::core::network
     }
 
     template<typename Protocol, typename Packet>
-    void SecureSocket<Protocol, Packet>::do_handshake_step()
+    void SecureSocket<Protocol, Packet>::do_handshake_step(bool data_available)
     {
         this->elapsed_receive_time.start();
         this->elapsed_send_time.start();
 
-        auto res = mbedtls_ssl_handshake_step(*secure_context);
+        auto pool = handshake_pool.lock();
+
+        if (pool)
+        {
+            if (awaiting_handshake_result)
+            {
+                awaiting_handshake_result = false;
+                handle_handshake_result(offloaded_handshake_result);
+            }
+
+            // While waiting for the peer there is nothing to do until more data arrives.
+            if (this->is_active()
+                && !is_handshake_complete(*secure_context)
+                && (data_available || last_handshake_result != MBEDTLS_ERR_SSL_WANT_READ))
+            {
+                offload_handshake_step(*pool);
+            }
+        }
+        else
+        {
+            handle_handshake_result(secure_context->handshake_step());
+        }
+    }
+
+    template<typename Protocol, typename Packet>
+    void SecureSocket<Protocol, Packet>::offload_handshake_step(CryptoWorkerPool& pool)
+    {
+        // The SSL context is only touched by the worker until it clears handshake_offloaded, the
+        // dispatcher neither polls nor services the socket in the meantime. The job keeps the socket alive.
+        handshake_offloaded.store(true, std::memory_order_release);
+        awaiting_handshake_result = true;
+
+        auto self = this->shared_from_this();
+
+        auto submitted = pool.try_submit([this, self]() {
+                                             offloaded_handshake_result = secure_context->handshake_step();
+                                             handshake_offloaded.store(false, std::memory_order_release);
+                                         });
+
+        if (!submitted)
+        {
+            // Pool is at its limit, try again on a later iteration.
+            awaiting_handshake_result = false;
+            handshake_offloaded.store(false, std::memory_order_release);
+        }
+    }
+
+    template<typename Protocol, typename Packet>
+    void SecureSocket<Protocol, Packet>::handle_handshake_result(int res)
+    {
+        last_handshake_result = res;
 
         if (needs_tls_transfer(res))
         {
@@ -351,12 +508,38 @@ namespace smooth::core::network
             log_mbedtls_error("SecureSocket", "mbedtls_ssl_handshake_step", res);
             this->stop("Error during handshake");
         }
+        else if (is_handshake_complete(*secure_context))
+        {
+            if (tls_session)
+            {
+                tls_session->save(*secure_context);
+            }
+
+            auto owner = context_owner.lock();
+
+            if (owner)
+            {
+                owner->count_resumption(*secure_context);
+            }
+        }
     }
 
     template<typename Protocol, typename Packet>
     bool SecureSocket<Protocol, Packet>::has_data_to_transmit()
     {
-        return !is_handshake_complete(*secure_context)
-               || Socket<Protocol, Packet>::has_data_to_transmit();
+        bool res;
+
+        if (is_handshake_complete(*secure_context))
+        {
+            res = Socket<Protocol, Packet>::has_data_to_transmit();
+        }
+        else
+        {
+            // A handshake waiting for the peer is continued once the socket is readable, except when the
+            // result of an offloaded step is yet to be handled.
+            res = awaiting_handshake_result || last_handshake_result != MBEDTLS_ERR_SSL_WANT_READ;
+        }
+
+        return res;
     }
 }
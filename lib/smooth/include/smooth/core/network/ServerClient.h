@@ -17,6 +17,8 @@ limitations under the License.
 
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <memory>
 #include "IPacketSendBuffer.h"
 #include "IPacketReceiveBuffer.h"
@@ -26,6 +28,9 @@ limitations under the License.
 #include "smooth/core/ipc/TaskEventQueue.h"
 #include "smooth/core/network/ISocket.h"
 #include "smooth/core/network/BufferContainer.h"
+#include "smooth/core/network/IPv4.h"
+#include "smooth/core/network/IPv6.h"
+#include "smooth/core/network/UnixAddress.h"
 #include "ClientPool.h"
 
 namespace smooth::core::network
@@ -36,6 +41,9 @@ namespace smooth::core::network
     template<typename Client, typename Protocol, typename ClientContext>
     class SecureServerSocket;
 
+    template<typename Client, typename Protocol, typename ClientContext>
+    class UnixServerSocket;
+
     /// ServerClient is the base class for all clients created by the ServerSocket. ServerClient provides
     /// the base functionality to implement a client capable of communicating over the associated socket.
     /// \tparam FinalClientTypeName The complete derived type of the client.
@@ -102,11 +110,20 @@ namespace smooth::core::network
             }
 
         protected:
+            /// Tells the pool whether the client is idle, e.g. a keep-alive connection waiting for
+            /// the next request. When the pool is exhausted, the client that has been idle the
+            /// longest may be evicted to make room for a new connection.
+            void set_idle(bool is_idle)
+            {
+                pool.set_idle(*static_cast<FinalClientTypeName*>(this), is_idle);
+            }
+
             std::shared_ptr<smooth::core::network::ISocket> socket{};
             std::shared_ptr<BufferContainer<Protocol>> container;
         private:
             friend ServerSocket<FinalClientTypeName, Protocol, ClientContext>;
             friend SecureServerSocket<FinalClientTypeName, Protocol, ClientContext>;
+            friend UnixServerSocket<FinalClientTypeName, Protocol, ClientContext>;
 
             friend ClientPool<FinalClientTypeName>;
 
@@ -122,8 +139,31 @@ namespace smooth::core::network
                 container->clear();
             }
 
+            void evict()
+            {
+                auto s = socket;
+
+                if (s)
+                {
+                    s->stop("Evicting idle client");
+                }
+            }
+
+            /// Returns an address instance describing the peer, reusing the one from the previous
+            /// connection when it is no longer referenced by any socket.
+            std::shared_ptr<InetAddress> get_peer_address(const sockaddr_storage& addr);
+
             smooth::core::network::ClientPool<FinalClientTypeName>& pool;
+            std::size_t pool_slot{ 0 };
+            bool idle{ false };
+            bool evicting{ false };
+            std::chrono::steady_clock::time_point idle_since{};
             ClientContext* client_context{ nullptr };
+            std::shared_ptr<IPv4> peer_v4{};
+            std::shared_ptr<IPv6> peer_v6{};
+#ifndef ESP_PLATFORM
+            std::shared_ptr<UnixAddress> peer_local{};
+#endif
     };
 
     template<typename FinalClientTypeName, typename Protocol, typename ClientContext>
@@ -134,4 +174,73 @@ namespace smooth::core::network
               pool(pool)
     {
     }
+
+    template<typename FinalClientTypeName, typename Protocol, typename ClientContext>
+    std::shared_ptr<InetAddress> ServerClient<FinalClientTypeName, Protocol, ClientContext>::get_peer_address(
+        const sockaddr_storage& addr)
+    {
+        std::shared_ptr<InetAddress> res{};
+
+        if (addr.ss_family == AF_INET)
+        {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-align"
+            const auto& ipv4_address = *reinterpret_cast<const sockaddr_in*>(&addr);
+#pragma GCC diagnostic pop
+
+            if (peer_v4 && peer_v4.use_count() == 1)
+            {
+                peer_v4->set_address(ipv4_address);
+            }
+            else
+            {
+                peer_v4 = std::make_shared<IPv4>(ipv4_address);
+            }
+
+            res = peer_v4;
+        }
+#ifndef ESP_PLATFORM
+        else if (addr.ss_family == AF_UNIX)
+        {
+            const auto& local_address = *reinterpret_cast<const sockaddr_un*>(&addr);
+
+            // The address length isn't known here; connecting peers are practically always unnamed,
+            // which is also how an abstract address (leading null) would appear.
+            auto length = static_cast<socklen_t>(local_address.sun_path[0] == '\0'
+                                                 ? offsetof(sockaddr_un, sun_path)
+                                                 : sizeof(local_address));
+
+            if (peer_local && peer_local.use_count() == 1)
+            {
+                peer_local->set_address(local_address, length);
+            }
+            else
+            {
+                peer_local = std::make_shared<UnixAddress>(local_address, length);
+            }
+
+            res = peer_local;
+        }
+#endif
+        else
+        {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-align"
+            const auto& ipv6_address = *reinterpret_cast<const sockaddr_in6*>(&addr);
+#pragma GCC diagnostic pop
+
+            if (peer_v6 && peer_v6.use_count() == 1)
+            {
+                peer_v6->set_address(ipv6_address);
+            }
+            else
+            {
+                peer_v6 = std::make_shared<IPv6>(ipv6_address);
+            }
+
+            res = peer_v6;
+        }
+
+        return res;
+    }
 }
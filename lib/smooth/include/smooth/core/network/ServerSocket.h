@@ -18,6 +18,7 @@ limitations under the License.
 #pragma once
 
 #include <sys/socket.h>
+#include <algorithm>
 #include <cstring>
 #include <memory>
 #include "ClientPool.h"
@@ -44,6 +45,9 @@ limitations under the License.
 
 namespace smooth::core::network
 {
+    static constexpr int DefaultMaxAcceptsPerEvent = 8;
+    static constexpr const std::chrono::milliseconds EvictionBackOff{ 10 };
+
     template<typename Client, typename Protocol, typename ClientContext>
     class ServerSocket
         : public CommonSocket
@@ -53,6 +57,15 @@ namespace smooth::core::network
             static std::shared_ptr<ServerSocket<Client, Protocol, ClientContext>>
             create(smooth::core::Task& task, int max_client_count, int backlog, ProtocolArguments... proto_args);
 
+            /// Creates a server socket whose listening and accepted sockets use the given options.
+            template<typename... ProtocolArguments>
+            static std::shared_ptr<ServerSocket<Client, Protocol, ClientContext>>
+            create(smooth::core::Task& task,
+                   int max_client_count,
+                   int backlog,
+                   const SocketOptions& options,
+                   ProtocolArguments... proto_args);
+
             bool start(std::shared_ptr<InetAddress> bind_to) override;
 
             void set_client_context(ClientContext* ctx)
@@ -65,13 +78,63 @@ namespace smooth::core::network
                 return true;
             }
 
+            /// Sets the maximum number of pending connections accepted per readable-event on the
+            /// listening socket. Draining several connections at once prevents the listen backlog
+            /// from filling during connection bursts.
+            void set_max_accepts_per_event(int count)
+            {
+                max_accepts_per_event = std::max(1, count);
+            }
+
+            /// Makes the client pool elastic. By default all max_client_count clients are created
+            /// up front; with this the pool instead keeps min_client_count clients and grows on
+            /// demand up to max_client_count as long as the estimated memory use stays within
+            /// memory_budget bytes (0 means no limit). Must be called before start() for the limits
+            /// to apply to the clients created at start.
+            /// \param client_size Estimated size of each client, in bytes. When 0, the size of the
+            /// client and its buffers is used.
+            void set_pool_limits(int min_client_count,
+                                 int max_client_count,
+                                 std::size_t memory_budget,
+                                 std::size_t client_size = 0)
+            {
+                pool.set_limits(min_client_count,
+                                max_client_count,
+                                memory_budget,
+                                client_size > 0 ? client_size : sizeof(Client) + sizeof(BufferContainer<Protocol>));
+            }
+
+            ClientPoolStatistics get_pool_statistics() const
+            {
+                return pool.get_statistics();
+            }
+
+            /// Sets the options for the listening socket and accepted connections; must be called before start().
+            void set_socket_options(const SocketOptions& socket_options)
+            {
+                options = socket_options;
+            }
+
+            const SocketOptions& get_socket_options() const
+            {
+                return options;
+            }
+
         protected:
             void readable(ISocketBackOff& ops) override;
 
             void writable() override;
 
-            virtual std::tuple<std::shared_ptr<smooth::core::network::InetAddress>, int>
-            accept_request(ISocketBackOff& ops);
+            /// Accepts a single pending connection.
+            /// \param ops Used to back off the listening socket when there are no clients available.
+            /// \param addr Receives the address of the peer.
+            /// \return The accepted socket, or INVALID_SOCKET if none could be accepted.
+            virtual int accept_request(ISocketBackOff& ops, sockaddr_storage& addr);
+
+            /// Creates the socket for an accepted connection and hands it to the client.
+            virtual void attach_client(const std::shared_ptr<Client>& client,
+                                       const std::shared_ptr<InetAddress>& ip,
+                                       int accepted_socket_id);
 
             bool has_data_to_transmit() override
             {
@@ -96,13 +159,16 @@ namespace smooth::core::network
                     : CommonSocket(),
                       pool(task, max_client_count), backlog(backlog)
             {
-                pool.create_clients(proto_args...);
+                // The clients are created by start(), once the pool limits are known.
+                pool.set_client_arguments(proto_args...);
             }
 
             ClientPool<Client> pool;
             ClientContext* client_context{ nullptr };
+            SocketOptions options{};
         private:
             int backlog{ 0 };
+            int max_accepts_per_event{ DefaultMaxAcceptsPerEvent };
     };
 
     template<typename Client, typename Protocol, typename ClientContext>
@@ -119,6 +185,7 @@ namespace smooth::core::network
 
             if (res)
             {
+                pool.fill();
                 SocketDispatcher::instance().perform_op(SocketOperation::Op::Start, shared_from_this());
             }
         }
@@ -127,77 +194,94 @@ namespace smooth::core::network
     }
 
     template<typename Client, typename Protocol, typename ClientContext>
-    std::tuple<std::shared_ptr<smooth::core::network::InetAddress>, int> ServerSocket<Client, Protocol,
-                                                                                      ClientContext>::accept_request(
-        ISocketBackOff& ops)
+    int ServerSocket<Client, Protocol, ClientContext>::accept_request(ISocketBackOff& ops, sockaddr_storage& addr)
     {
         using namespace smooth::core::logging;
 
-        auto res = std::make_tuple<std::shared_ptr<smooth::core::network::InetAddress>, int>(nullptr, 0);
+        int accepted_socket = INVALID_SOCKET;
 
         if (pool.empty())
         {
-            Log::warning("ServerSocket", "No client available at this time");
-            ops.back_off(socket_id, DefaultReceiveTimeout);
+            if (pool.evict_idle_client())
+            {
+                // The evicted client becomes available once its disconnection has been processed.
+                Log::verbose("ServerSocket", "No client available, evicted an idle client");
+                ops.back_off(socket_id, EvictionBackOff);
+            }
+            else
+            {
+                Log::warning("ServerSocket", "No client available at this time");
+                ops.back_off(socket_id, DefaultReceiveTimeout);
+            }
         }
         else
         {
-            sockaddr addr{};
-            socklen_t len{ AF_INET6 };
+            socklen_t len{ sizeof(addr) };
 
-            auto accepted_socket = accept(socket_id, &addr, &len);
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+
+            // Get a non-blocking socket directly, saving the fcntl()-calls otherwise needed.
+            accepted_socket = accept4(socket_id,
+                                      reinterpret_cast<sockaddr*>(&addr),
+                                      &len,
+                                      SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+            accepted_socket = accept(socket_id, reinterpret_cast<sockaddr*>(&addr), &len);
+#endif
 
             if (accepted_socket == INVALID_SOCKET)
             {
-                std::string msg = "Error accepting: ";
-                msg += strerror(errno);
-                loge(msg.c_str());
+                // Running out of pending connections is the normal way to end an accept-batch.
+                if (errno != EWOULDBLOCK)
+                {
+                    std::string msg = "Error accepting: ";
+                    msg += strerror(errno);
+                    loge(msg.c_str());
+                }
             }
             else
             {
-                std::shared_ptr<smooth::core::network::InetAddress> ip{};
-
-                if (addr.sa_family == AF_INET)
-                {
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wcast-align"
-                    auto ipv4_address = reinterpret_cast<sockaddr_in*>(&addr);
-#pragma GCC diagnostic pop
-                    ip = std::make_shared<smooth::core::network::IPv4>(*ipv4_address);
-                }
-                else
-                {
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wcast-align"
-                    auto ipv6_address = reinterpret_cast<sockaddr_in6*>(&addr);
-#pragma GCC diagnostic pop
-                    ip = std::make_shared<smooth::core::network::IPv6>(*ipv6_address);
-                }
-
-                Log::info("ServerSocket", "Connection accepted");
-                res = std::make_tuple<>(ip, accepted_socket);
+                Log::verbose("ServerSocket", "Connection accepted");
             }
         }
 
-        return res;
+        return accepted_socket;
     }
 
     template<typename Client, typename Protocol, typename ClientContext>
     void ServerSocket<Client, Protocol, ClientContext>::readable(ISocketBackOff& ops)
     {
-        const auto& [ip, accepted_socket_id] = accept_request(ops);
+        auto accepted_socket_id = INVALID_SOCKET;
+        auto count = 0;
 
-        if (ip)
+        do
         {
-            auto client = pool.get();
-            auto socket = Socket<Protocol>::create(ip,
-                                                   accepted_socket_id,
-                                                   client->get_buffers(),
-                                                   client->get_send_timeout());
-
-            client->set_client_context(client_context);
-            client->set_socket(socket);
+            sockaddr_storage addr{};
+            accepted_socket_id = accept_request(ops, addr);
+
+            if (accepted_socket_id != INVALID_SOCKET)
+            {
+                auto client = pool.get();
+                attach_client(client, client->get_peer_address(addr), accepted_socket_id);
+            }
         }
+        while (accepted_socket_id != INVALID_SOCKET && ++count < max_accepts_per_event);
+    }
+
+    template<typename Client, typename Protocol, typename ClientContext>
+    void ServerSocket<Client, Protocol, ClientContext>::attach_client(const std::shared_ptr<Client>& client,
+                                                                      const std::shared_ptr<InetAddress>& ip,
+                                                                      int accepted_socket_id)
+    {
+        auto socket = Socket<Protocol>::create(ip,
+                                               accepted_socket_id,
+                                               client->get_buffers(),
+                                               client->get_send_timeout(),
+                                               DefaultReceiveTimeout,
+                                               options);
+
+        client->set_client_context(client_context);
+        client->set_socket(socket);
     }
 
     template<typename Client, typename Protocol, typename ClientContext>
@@ -227,8 +311,9 @@ namespace smooth::core::network
             {
                 int reuseaddr = 1;
                 setsockopt(socket_id, SOL_SOCKET, SO_REUSEADDR, &reuseaddr, sizeof(reuseaddr));
-
-                auto bind_res = bind(socket_id, ip->get_socket_address(), ip->get_socket_address_length());
+                auto bind_res = ip->prepare_bind()
+                                ? bind(socket_id, ip->get_socket_address(), ip->get_socket_address_length())
+                                : -1;
 
                 if (bind_res == 0)
                 {
@@ -276,6 +361,22 @@ namespace smooth::core::network
                                                                                                           proto_args...);
     }
 
+    template<typename Client, typename Protocol, typename ClientContext>
+    template<typename... ProtocolArguments>
+    std::shared_ptr<ServerSocket<Client, Protocol, ClientContext>> ServerSocket<Client, Protocol,
+                                                                                ClientContext>::create(
+        smooth::core::Task& task,
+        int max_client_count,
+        int backlog,
+        const SocketOptions& options,
+        ProtocolArguments... proto_args)
+    {
+        auto s = create(task, max_client_count, backlog, proto_args...);
+        s->set_socket_options(options);
+
+        return s;
+    }
+
     template<typename Client, typename Protocol, typename ClientContext>
     bool ServerSocket<Client, Protocol, ClientContext>::create_socket()
     {
@@ -283,7 +384,7 @@ namespace smooth::core::network
 
         if (socket_id < 0)
         {
-            socket_id = socket(ip->get_protocol_family(), SOCK_STREAM, 0);
+            socket_id = socket(ip->get_protocol_family(), ip->get_socket_type(), 0);
 
             if (socket_id == INVALID_SOCKET)
             {
@@ -292,8 +393,12 @@ namespace smooth::core::network
             else
             {
                 res = set_non_blocking();
-                int no_delay = 1;
-                res &= setsockopt(socket_id, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay)) == 0;
+
+                if (res)
+                {
+                    // Options set on the listening socket, such as SO_RCVBUF, are inherited by accepted sockets.
+                    options.apply(socket_id, !ip->is_local());
+                }
 
                 if (res)
                 {
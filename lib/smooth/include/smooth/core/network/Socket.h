@@ -19,12 +19,19 @@ limitations under the License.
 
 #include "InetAddress.h"
 #include "ISocket.h"
+#include <algorithm>
 #include <cstring>
 #include <memory>
 #include <chrono>
+#include <vector>
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+#include <sys/sendfile.h>
+#endif
 #include "CommonSocket.h"
+#include "SocketOptions.h"
 #include "ServerClient.h"
 #include "BufferContainer.h"
+#include "FileRegion.h"
 #include "smooth/core/util/CircularBuffer.h"
 #include "smooth/core/ipc/TaskEventQueue.h"
 #include "smooth/core/network/event/TransmitBufferEmptyEvent.h"
@@ -73,19 +80,22 @@ namespace smooth::core::network
             /// \param send_timeout The amount of time to wait for outgoing data to actually be sent to remote
             /// endpoint (i.e. the maximum time between send() being called and the socket being writable again).
             /// If this time is exceeded, the socket will be closed.
+            /// \param options Tuning options applied to the underlying socket.
             /// \return a std::shared_ptr pointing to an instance of a ISocket object, or nullptr if no socket could be
             /// created.
             static std::shared_ptr<Socket<Protocol>>
             create(std::weak_ptr<BufferContainer<Protocol>> buffer_container,
                    std::chrono::milliseconds send_timeout = DefaultSendTimeout,
-                   std::chrono::milliseconds receive_timeout = DefaultReceiveTimeout);
+                   std::chrono::milliseconds receive_timeout = DefaultReceiveTimeout,
+                   const SocketOptions& options = SocketOptions{});
 
             static std::shared_ptr<Socket<Protocol>>
             create(std::shared_ptr<smooth::core::network::InetAddress> ip,
                    int socket_id,
                    std::weak_ptr<BufferContainer<Protocol>> buffer_container,
                    std::chrono::milliseconds send_timeout = DefaultSendTimeout,
-                   std::chrono::milliseconds receive_timeout = DefaultReceiveTimeout);
+                   std::chrono::milliseconds receive_timeout = DefaultReceiveTimeout,
+                   const SocketOptions& options = SocketOptions{});
 
             ~Socket() override = default;
 
@@ -99,6 +109,17 @@ namespace smooth::core::network
 
             bool send(const Packet& packet);
 
+            /// Sets the options to apply to the underlying socket; must be called before the socket is started.
+            void set_socket_options(const SocketOptions& socket_options)
+            {
+                options = socket_options;
+            }
+
+            const SocketOptions& get_socket_options() const
+            {
+                return options;
+            }
+
             bool is_server() const override
             {
                 return false;
@@ -113,8 +134,36 @@ namespace smooth::core::network
 
             virtual void write_data(const std::shared_ptr<BufferContainer<Protocol>>& container);
 
+            /// Receives data from the underlying socket, see recv().
+            virtual ssize_t socket_receive(uint8_t* buffer, size_t length);
+
+            /// Sends data on the underlying socket, see send().
+            virtual ssize_t socket_send(const uint8_t* data, size_t length);
+
+            /// Sends the next part of a file region, with sendfile() on Linux.
+            /// \return The number of bytes sent, or -1 on error.
+            ssize_t send_file_region(const FileRegion& region);
+
+            /// Gets the next part of a file region, either straight from the memory mapped file or
+            /// read into a buffer that is reused for the lifetime of the socket.
+            /// \param length Set to the number of bytes available at the returned position.
+            /// \return The data, or nullptr on error.
+            const uint8_t* get_file_data(const FileRegion& region, int& length);
+
             void send_next_packet();
 
+            /// Assembles packets from data the protocol has buffered from earlier reads.
+            void assemble_buffered(const std::shared_ptr<BufferContainer<Protocol>>& container,
+                                   const IOBudget& budget);
+
+            bool has_pending_data() const override
+            {
+                // Buffered data must be assembled even when the socket itself has nothing more to read.
+                auto cont = buffers.lock();
+
+                return cont && cont->get_rx_buffer().has_buffered_data();
+            }
+
             bool signal_new_connection();
 
             bool internal_start() override;
@@ -131,7 +180,8 @@ namespace smooth::core::network
 
                     if (cont)
                     {
-                        res = !cont->get_tx_buffer().is_empty();
+                        // A released cork must be removed even if there is nothing more to send.
+                        res = !cont->get_tx_buffer().is_empty() || (corked && !cork_requested);
                     }
                 }
 
@@ -144,11 +194,24 @@ namespace smooth::core::network
 
             std::shared_ptr<BufferContainer<Protocol>> get_container_or_close();
 
-            bool set_no_delay();
+            bool apply_socket_options();
+
+            void update_cork(const std::shared_ptr<BufferContainer<Protocol>>& container, bool before_send);
 
             std::weak_ptr<BufferContainer<Protocol>> buffers{};
+            SocketOptions options{};
+
+            /// Largest part of a file region sent at a time.
+#ifdef ESP_PLATFORM
+            static constexpr std::size_t FileChunkSize = 4096;
+#else
+            static constexpr std::size_t FileChunkSize = 64 * 1024;
+#endif
         private:
+            std::vector<uint8_t> file_buffer{};
             void clear_buffers();
+
+            bool corked{ false };
     };
 
     template<typename Protocol, typename Packet>
@@ -157,11 +220,10 @@ namespace smooth::core::network
         int socket_id,
         std::weak_ptr<BufferContainer<Protocol>> buffer_container,
         std::chrono::milliseconds send_timeout,
-        std::chrono::milliseconds receive_timeout)
+        std::chrono::milliseconds receive_timeout,
+        const SocketOptions& options)
     {
-        auto s = create(buffer_container, send_timeout, receive_timeout);
-        s->set_send_timeout(send_timeout);
-        s->set_receive_timeout(receive_timeout);
+        auto s = create(buffer_container, send_timeout, receive_timeout, options);
         s->set_existing_socket(ip, socket_id);
 
         return s;
@@ -171,11 +233,13 @@ namespace smooth::core::network
     std::shared_ptr<Socket<Protocol>> Socket<Protocol, Packet>::create(
         std::weak_ptr<BufferContainer<Protocol>> buffer_container,
         std::chrono::milliseconds send_timeout,
-        std::chrono::milliseconds receive_timeout)
+        std::chrono::milliseconds receive_timeout,
+        const SocketOptions& options)
     {
         auto s = smooth::core::util::create_protected_shared<Socket<Protocol, Packet>>(buffer_container);
         s->set_send_timeout(send_timeout);
         s->set_receive_timeout(receive_timeout);
+        s->set_socket_options(options);
 
         return s;
     }
@@ -219,7 +283,7 @@ namespace smooth::core::network
 
         if (socket_id < 0)
         {
-            socket_id = socket(ip->get_protocol_family(), SOCK_STREAM, 0);
+            socket_id = socket(ip->get_protocol_family(), ip->get_socket_type(), 0);
 
             if (socket_id == INVALID_SOCKET)
             {
@@ -227,7 +291,12 @@ namespace smooth::core::network
             }
             else
             {
-                res = set_non_blocking() && set_no_delay();
+                res = set_non_blocking();
+
+                if (res)
+                {
+                    apply_socket_options();
+                }
             }
         }
         else
@@ -239,21 +308,40 @@ namespace smooth::core::network
     }
 
     template<typename Protocol, typename Packet>
-    bool Socket<Protocol, Packet>::set_no_delay()
+    bool Socket<Protocol, Packet>::apply_socket_options()
     {
-        int no_delay = 1;
-        auto res = setsockopt(socket_id, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay)) == 0;
+        corked = false;
 
-        if (!res)
+        // TCP options are not applicable to local sockets
+        return options.apply(socket_id, !ip->is_local());
+    }
+
+    template<typename Protocol, typename Packet>
+    void Socket<Protocol, Packet>::update_cork(const std::shared_ptr<BufferContainer<Protocol>>& container,
+                                               bool before_send)
+    {
+        if ((options.cork || options.auto_cork) && !ip->is_local() && SocketOptions::is_cork_supported())
         {
-            loge("Failed to set no delay socket option");
-        }
+            auto wanted = options.cork && cork_requested;
 
-        return res;
+            if (!wanted && options.auto_cork)
+            {
+                // Before sending, cork if more than the next packet is waiting. After sending,
+                // stay corked as long as anything remains.
+                wanted = container->get_tx_buffer().get_queued_count() > (before_send ? 1 : 0);
+            }
+
+            // Corking happens before a send and uncorking after it, so that the last packet
+            // is coalesced with what was held back.
+            if (wanted != corked && wanted == before_send && SocketOptions::set_cork(socket_id, wanted))
+            {
+                corked = wanted;
+            }
+        }
     }
 
     template<typename Protocol, typename Packet>
-    void Socket<Protocol, Packet>::readable(ISocketBackOff&)
+    void Socket<Protocol, Packet>::readable(ISocketBackOff& ops)
     {
         if (is_active())
         {
@@ -263,21 +351,76 @@ namespace smooth::core::network
 
             if (cont)
             {
-                if (!cont->get_rx_buffer().is_full())
+                auto& rx = cont->get_rx_buffer();
+
+                if (!rx.is_full())
                 {
-                    read_data(cont);
+                    // Data left over from earlier reads precedes anything still to be read from the socket.
+                    if (rx.has_buffered_data())
+                    {
+                        assemble_buffered(cont, ops.get_io_budget());
+                    }
+                    else
+                    {
+                        read_data(cont);
+                    }
                 }
             }
         }
     }
 
+    template<typename Protocol, typename Packet>
+    void Socket<Protocol, Packet>::assemble_buffered(const std::shared_ptr<BufferContainer<Protocol>>& container,
+                                                     const IOBudget& budget)
+    {
+        auto& rx = container->get_rx_buffer();
+        std::size_t packets_assembled = 0;
+
+        while (is_active()
+               && packets_assembled < budget.packets
+               && !rx.is_full()
+               && rx.assemble_buffered() > 0)
+        {
+            if (rx.is_error())
+            {
+                rx.prepare_new_packet();
+                stop("Assembly error");
+            }
+            else if (rx.is_packet_complete())
+            {
+                event::DataAvailableEvent<Protocol> d(&rx);
+                container->get_data_available()->push(d);
+                rx.prepare_new_packet();
+                ++packets_assembled;
+            }
+        }
+    }
+
     template<typename Protocol, typename Packet>
     void Socket<Protocol, Packet>::writable()
     {
         if (is_active() && signal_new_connection())
         {
             elapsed_send_time.stop_and_zero();
-            send_next_packet();
+
+            auto cont = buffers.lock();
+
+            if (cont)
+            {
+                update_cork(cont, true);
+            }
+
+            // Don't report an empty buffer again when only releasing a cork.
+            if (!corked || !cont || !cont->get_tx_buffer().is_empty())
+            {
+                send_next_packet();
+            }
+
+            if (cont && corked)
+            {
+                // Uncorking flushes any partial segment held back.
+                update_cork(cont, false);
+            }
         }
     }
 
@@ -340,7 +483,7 @@ namespace smooth::core::network
         ssize_t read_count = 0;
         {
             auto write_pos = rx.get_write_pos();
-            read_count = recv(socket_id, static_cast<void*>(write_pos), static_cast<size_t>(wanted_length), 0);
+            read_count = socket_receive(static_cast<uint8_t*>(write_pos), static_cast<size_t>(wanted_length));
         }
 
         if (read_count == 0)
@@ -383,12 +526,18 @@ namespace smooth::core::network
         // is that send( id, some_data, some_length ) will be >= 1 and may or may not send the entire
         // packet.
         auto& tx = container->get_tx_buffer();
-        auto data_to_send = tx.get_data_to_send();
-        auto length = tx.get_remaining_data_length();
-        auto amount_sent = ::send(socket_id,
-                                  data_to_send,
-                                  static_cast<size_t>(length),
-                                  SEND_FLAGS);
+        ssize_t amount_sent;
+
+        if (tx.is_sending_file_region())
+        {
+            amount_sent = send_file_region(tx.get_file_region_to_send());
+        }
+        else
+        {
+            auto data_to_send = tx.get_data_to_send();
+            auto length = tx.get_remaining_data_length();
+            amount_sent = socket_send(data_to_send, static_cast<size_t>(length));
+        }
 
         if (amount_sent == -1)
         {
@@ -412,6 +561,79 @@ namespace smooth::core::network
         }
     }
 
+    template<typename Protocol, typename Packet>
+    ssize_t Socket<Protocol, Packet>::socket_receive(uint8_t* buffer, size_t length)
+    {
+        return recv(socket_id, static_cast<void*>(buffer), length, 0);
+    }
+
+    template<typename Protocol, typename Packet>
+    ssize_t Socket<Protocol, Packet>::socket_send(const uint8_t* data, size_t length)
+    {
+        return ::send(socket_id, data, length, SEND_FLAGS);
+    }
+
+    template<typename Protocol, typename Packet>
+    ssize_t Socket<Protocol, Packet>::send_file_region(const FileRegion& region)
+    {
+        ssize_t res;
+
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+
+        // The kernel copies straight from the page cache to the socket.
+        auto offset = static_cast<off_t>(region.offset);
+        res = sendfile(socket_id, region.file->get_descriptor(), &offset, std::min(region.length, FileChunkSize));
+
+        if (res == 0)
+        {
+            // The end of the file was reached before the end of the region; the file has been truncated.
+            res = -1;
+        }
+        else if (res == -1 && errno == EWOULDBLOCK)
+        {
+            res = 0;
+        }
+#else
+        int length = 0;
+        auto data = get_file_data(region, length);
+        res = data ? socket_send(data, static_cast<size_t>(length)) : -1;
+#endif
+
+        return res;
+    }
+
+    template<typename Protocol, typename Packet>
+    const uint8_t* Socket<Protocol, Packet>::get_file_data(const FileRegion& region, int& length)
+    {
+        const uint8_t* res = nullptr;
+        auto wanted = std::min(region.length, FileChunkSize);
+        auto mapped = region.file->map();
+
+        if (mapped)
+        {
+            // Reading beyond the end of a truncated file would raise SIGBUS.
+            if (region.file->current_size() >= region.offset + wanted)
+            {
+                res = mapped + region.offset;
+                length = static_cast<int>(wanted);
+            }
+        }
+        else
+        {
+            // A partially sent chunk is simply read again from its new offset next time.
+            file_buffer.resize(FileChunkSize);
+            auto read = region.file->read(region.offset, file_buffer.data(), wanted);
+
+            if (read > 0)
+            {
+                res = file_buffer.data();
+                length = static_cast<int>(read);
+            }
+        }
+
+        return res;
+    }
+
     template<typename Protocol, typename Packet>
     bool Socket<Protocol, Packet>::internal_start()
     {
@@ -484,7 +706,7 @@ namespace smooth::core::network
         active = true;
         connected = true;
         set_non_blocking();
-        set_no_delay();
+        apply_socket_options();
 
         SocketDispatcher::instance().perform_op(SocketOperation::Op::AddActiveSocket, shared_from_this());
     }
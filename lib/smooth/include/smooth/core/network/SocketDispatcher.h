@@ -17,6 +17,7 @@ limitations under the License.
 
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <map>
 #include <vector>
@@ -36,6 +37,26 @@ limitations under the License.
 
 namespace smooth::core::network
 {
+    /// Figures on how the SocketDispatcher shares its time between sockets.
+    struct DispatcherStatistics
+    {
+        /// Number of dispatcher iterations.
+        uint64_t iterations{ 0 };
+
+        /// Number of times a socket has been serviced.
+        uint64_t services{ 0 };
+
+        /// Number of times a socket still had received data left after its turn, e.g. because its IOBudget
+        /// was used up, and was rescheduled for the next iteration.
+        uint64_t rescheduled{ 0 };
+
+        /// Longest time a ready socket has waited for the sockets ahead of it to be serviced.
+        std::chrono::microseconds max_service_delay{ 0 };
+
+        /// Longest time spent servicing the ready sockets of one iteration.
+        std::chrono::microseconds max_iteration_time{ 0 };
+    };
+
     /// The SocketDispatcher handles all tasks related to sockets and is responsible for
     /// creating and sending the necessary events to the application. As an application developer
     /// you should never have to care about this class.
@@ -63,6 +84,22 @@ namespace smooth::core::network
 
             void event(const SocketOperation& event) override;
 
+            /// Sets how much each socket may read per turn. Ready sockets are serviced in round-robin order,
+            /// so a smaller budget shortens the time other sockets wait behind a busy one at the cost of
+            /// more iterations for bulk transfers.
+            void set_io_budget(const IOBudget& budget);
+
+            DispatcherStatistics get_statistics() const;
+
+            void reset_statistics();
+
+            /// Gets the CPU time consumed by the dispatcher thread, as of its last iteration.
+            /// Always zero on platforms without per-thread CPU clocks.
+            std::chrono::microseconds get_cpu_time() const
+            {
+                return std::chrono::microseconds{ cpu_time_us.load() };
+            }
+
         protected:
         private:
             SocketDispatcher();
@@ -71,7 +108,13 @@ namespace smooth::core::network
 
             void clear_sets();
 
-            void set_timeout();
+            void set_timeout(bool short_timeout);
+
+            void service_sockets();
+
+            void add_if_ready(const std::shared_ptr<ISocket>& socket);
+
+            bool has_pending_data(const std::shared_ptr<ISocket>& socket);
 
             void restart_inactive_sockets();
 
@@ -84,14 +127,38 @@ namespace smooth::core::network
 
             void shutdown_socket(std::shared_ptr<ISocket> socket);
 
+            void close_socket(std::shared_ptr<ISocket>& socket);
+
+            void close_deferred_sockets();
+
             bool is_backed_off(int socket_id);
 
             void remove_backed_off_socket(int socket_id);
 
             void back_off(int socket_id, std::chrono::milliseconds duration) override;
 
+            IOBudget get_io_budget() const override
+            {
+                return IOBudget{ budget_bytes.load(std::memory_order_relaxed),
+                                 budget_packets.load(std::memory_order_relaxed) };
+            }
+
             std::map<int, std::shared_ptr<ISocket>> active_sockets;
             std::vector<std::shared_ptr<ISocket>> inactive_sockets;
+
+            // Sockets holding data already read from the underlying socket, as of the last build_sets().
+            fd_set pending_set{};
+            std::size_t pending_data_count{ 0 };
+            std::size_t offloaded_socket_count{ 0 };
+
+            // Sockets to close once they are no longer offloaded.
+            std::vector<std::shared_ptr<ISocket>> deferred_close{};
+            std::vector<std::shared_ptr<ISocket>> service_order{};
+            int last_first_serviced{ ISocket::INVALID_SOCKET };
+            std::atomic<std::size_t> budget_bytes{ IOBudget{}.bytes };
+            std::atomic<std::size_t> budget_packets{ IOBudget{}.packets };
+            mutable std::mutex statistics_guard{};
+            DispatcherStatistics statistics{};
             std::mutex socket_guard;
             using NetworkEventQueue = smooth::core::ipc::SubscribingTaskEventQueue<NetworkStatus>;
             std::shared_ptr<NetworkEventQueue> network_events;
@@ -110,5 +177,9 @@ namespace smooth::core::network
             std::unordered_map<int, std::chrono::steady_clock::time_point> backed_off{};
 
             void check_socket_timeouts();
+
+            void update_cpu_time();
+
+            std::atomic<int64_t> cpu_time_us{ 0 };
     };
 }
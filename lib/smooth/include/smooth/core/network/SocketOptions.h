@@ -0,0 +1,73 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <chrono>
+
+namespace smooth::core::network
+{
+    /// Tuning options for TCP sockets. Zero values mean that the system default is kept.
+    /// Options not supported by the platform are ignored.
+    struct SocketOptions
+    {
+        /// Disable Nagle's algorithm (TCP_NODELAY).
+        bool no_delay{ true };
+
+        /// Size of the kernel send buffer (SO_SNDBUF), in bytes.
+        int send_buffer_size{ 0 };
+
+        /// Size of the kernel receive buffer (SO_RCVBUF), in bytes. For server sockets this is applied
+        /// to the listening socket so that accepted connections inherit it along with a matching window scale.
+        int receive_buffer_size{ 0 };
+
+        /// Enable TCP keep-alive probes (SO_KEEPALIVE) with the given timing (TCP_KEEPIDLE, TCP_KEEPINTVL,
+        /// TCP_KEEPCNT).
+        bool keep_alive{ false };
+        std::chrono::seconds keep_alive_idle{ 0 };
+        std::chrono::seconds keep_alive_interval{ 0 };
+        int keep_alive_count{ 0 };
+
+        /// Maximum time transmitted data may remain unacknowledged before the connection is closed
+        /// (TCP_USER_TIMEOUT).
+        std::chrono::milliseconds user_timeout{ 0 };
+
+        /// Time to busy poll the device queue on blocking receives (SO_BUSY_POLL).
+        std::chrono::microseconds busy_poll{ 0 };
+
+        /// Honour cork requests made via ISocket::set_cork(), e.g. around multi-packet HTTP responses,
+        /// so that headers and body are coalesced into full segments.
+        bool cork{ false };
+
+        /// Automatically cork the socket while more than one packet is queued for sending, uncorking
+        /// once the transmit buffer is empty.
+        bool auto_cork{ false };
+
+        /// Applies the options to a socket. Failures are logged; tuning is best effort.
+        /// \param socket_id The socket
+        /// \param is_tcp false for sockets to which TCP specific options do not apply, e.g. Unix domain sockets.
+        /// \return true if all options were applied.
+        bool apply(int socket_id, bool is_tcp) const;
+
+        /// Returns true if the platform supports corking (TCP_CORK).
+        static bool is_cork_supported();
+
+        /// Sets or clears TCP_CORK on the socket.
+        /// \return true on success.
+        static bool set_cork(int socket_id, bool corked);
+    };
+}
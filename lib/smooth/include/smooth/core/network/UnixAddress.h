@@ -0,0 +1,85 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#ifndef ESP_PLATFORM
+
+#include "InetAddress.h"
+#include <sys/un.h>
+
+namespace smooth::core::network
+{
+    /// Represents a Unix domain socket address, for local communication with other processes
+    /// without the overhead of the TCP/IP stack. Can be used wherever an IPv4 or IPv6 address is,
+    /// e.g. with Socket and ServerSocket.
+    /// A path starting with '@' denotes an address in the Linux abstract namespace, which
+    /// has no presence in the file system.
+    class UnixAddress
+        : public InetAddress
+    {
+        public:
+            /// Constructor
+            /// \param path The file system path of the socket, or @name for an abstract address.
+            /// \param socket_type SOCK_STREAM, or SOCK_SEQPACKET for message boundaries to be preserved. Note that
+            /// with SOCK_SEQPACKET each message must be consumed in a single read, i.e. the protocol must ask
+            /// for the whole message at once.
+            explicit UnixAddress(const std::string& path, int socket_type = SOCK_STREAM);
+
+            UnixAddress(const sockaddr_un& addr, socklen_t length);
+
+            /// Replaces the address, allowing an instance to be reused for a new peer.
+            /// \param addr The new address
+            /// \param length The length of the address
+            void set_address(const sockaddr_un& addr, socklen_t length);
+
+            bool resolve_ip() override;
+
+            sockaddr* get_socket_address() override;
+
+            socklen_t get_socket_address_length() const override;
+
+            int get_address_family() const override
+            {
+                return AF_UNIX;
+            }
+
+            int get_socket_type() const override
+            {
+                return socket_type;
+            }
+
+            /// Removes a stale socket file left behind by a previous server. Other kinds of files,
+            /// and sockets a server still accepts connections on, are left in place.
+            /// \return false if the path is taken by such a file or a live server.
+            bool prepare_bind() override;
+
+            bool is_abstract() const
+            {
+                return !host.empty() && host[0] == '@';
+            }
+
+        private:
+            bool is_in_use() const;
+
+            sockaddr_un sock_address{};
+            socklen_t address_length{ 0 };
+            int socket_type;
+    };
+}
+
+#endif
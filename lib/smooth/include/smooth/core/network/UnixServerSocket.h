@@ -0,0 +1,107 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#ifndef ESP_PLATFORM
+
+#include <memory>
+#include <type_traits>
+#include "ServerSocket.h"
+#include "UnixSocket.h"
+#include "smooth/core/util/create_protected.h"
+
+namespace smooth::core::network
+{
+    /// Detects clients that want the DescriptorChannel of their socket, i.e. those
+    /// having a set_descriptor_channel(std::shared_ptr<DescriptorChannel>) method.
+    template<typename Client, typename = void>
+    struct accepts_descriptor_channel
+        : std::false_type
+    {
+    };
+
+    template<typename Client>
+    struct accepts_descriptor_channel<Client,
+                                      std::void_t<decltype(std::declval<Client&>().set_descriptor_channel(
+                                                               std::shared_ptr<DescriptorChannel>{}))>>
+        : std::true_type
+    {
+    };
+
+    /// A ServerSocket for Unix domain addresses whose clients are given UnixSockets, so they
+    /// can exchange file descriptors with their peers. Clients that implement
+    /// set_descriptor_channel() are handed the DescriptorChannel of each new connection.
+    /// A regular ServerSocket also accepts Unix domain connections, but without descriptor passing.
+    template<typename Client, typename Protocol, typename ClientContext>
+    class UnixServerSocket
+        : public ServerSocket<Client, Protocol, ClientContext>
+    {
+        public:
+            template<typename... ProtocolArguments>
+            static std::shared_ptr<ServerSocket<Client, Protocol, ClientContext>>
+            create(smooth::core::Task& task, int max_client_count, int backlog, ProtocolArguments... proto_args)
+            {
+                return smooth::core::util::create_protected_shared<UnixServerSocket<Client, Protocol, ClientContext>>(
+                        task,
+                        max_client_count,
+                        backlog,
+                        proto_args...);
+            }
+
+        protected:
+            template<typename... ProtocolArguments>
+            UnixServerSocket(smooth::core::Task& task,
+                             int max_client_count,
+                             int backlog,
+                             ProtocolArguments... proto_args)
+                    : ServerSocket<Client, Protocol, ClientContext>(task,
+                                                                    max_client_count,
+                                                                    backlog,
+                                                                    proto_args...)
+            {
+            }
+
+            void attach_client(const std::shared_ptr<Client>& client,
+                               const std::shared_ptr<InetAddress>& ip,
+                               int accepted_socket_id) override;
+    };
+
+    template<typename Client, typename Protocol, typename ClientContext>
+    void UnixServerSocket<Client, Protocol, ClientContext>::attach_client(const std::shared_ptr<Client>& client,
+                                                                          const std::shared_ptr<InetAddress>& ip,
+                                                                          int accepted_socket_id)
+    {
+        auto socket = UnixSocket<Protocol>::create(ip,
+                                                   accepted_socket_id,
+                                                   client->get_buffers(),
+                                                   std::make_shared<DescriptorChannel>(),
+                                                   client->get_send_timeout(),
+                                                   DefaultReceiveTimeout,
+                                                   this->options);
+
+        if constexpr (accepts_descriptor_channel<Client>::value)
+        {
+            client->set_descriptor_channel(socket->get_descriptor_channel());
+        }
+
+        client->set_client_context(this->client_context);
+        client->set_socket(socket);
+    }
+}
+
+#endif
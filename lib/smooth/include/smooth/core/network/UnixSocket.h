@@ -0,0 +1,188 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#ifndef ESP_PLATFORM
+
+#include <array>
+#include <memory>
+#include <sys/uio.h>
+#include "Socket.h"
+#include "DescriptorChannel.h"
+#include "UnixAddress.h"
+#include "smooth/core/util/create_protected.h"
+
+namespace smooth::core::network
+{
+    /// UnixSocket is a Socket for Unix domain addresses (see UnixAddress) which in addition to the
+    /// regular data stream can pass file descriptors to and from the peer (SCM_RIGHTS), via its DescriptorChannel.
+    /// Descriptors queued for sending are attached to the next data sent, so the application should send
+    /// a packet announcing them, and the receiver picks them up when that packet arrives.
+    template<typename Protocol, typename Packet = typename Protocol::packet_type>
+    class UnixSocket
+        : public Socket<Protocol, Packet>
+    {
+        public:
+            static std::shared_ptr<UnixSocket<Protocol>>
+            create(std::weak_ptr<BufferContainer<Protocol>> buffer_container,
+                   std::shared_ptr<DescriptorChannel> descriptors = std::make_shared<DescriptorChannel>(),
+                   std::chrono::milliseconds send_timeout = DefaultSendTimeout,
+                   std::chrono::milliseconds receive_timeout = DefaultReceiveTimeout,
+                   const SocketOptions& options = SocketOptions{});
+
+            static std::shared_ptr<UnixSocket<Protocol>>
+            create(std::shared_ptr<smooth::core::network::InetAddress> ip,
+                   int socket_id,
+                   std::weak_ptr<BufferContainer<Protocol>> buffer_container,
+                   std::shared_ptr<DescriptorChannel> descriptors = std::make_shared<DescriptorChannel>(),
+                   std::chrono::milliseconds send_timeout = DefaultSendTimeout,
+                   std::chrono::milliseconds receive_timeout = DefaultReceiveTimeout,
+                   const SocketOptions& options = SocketOptions{});
+
+            /// Gets the channel through which descriptors are sent and received.
+            const std::shared_ptr<DescriptorChannel>& get_descriptor_channel() const
+            {
+                return descriptors;
+            }
+
+        protected:
+            UnixSocket(std::weak_ptr<BufferContainer<Protocol>> buffer_container,
+                       std::shared_ptr<DescriptorChannel> descriptors)
+                    : Socket<Protocol, Packet>(std::move(buffer_container)),
+                      descriptors(std::move(descriptors))
+            {
+            }
+
+            ssize_t socket_receive(uint8_t* buffer, size_t length) override;
+
+            ssize_t socket_send(const uint8_t* data, size_t length) override;
+
+        private:
+            using ControlBuffer = std::array<uint8_t, CMSG_SPACE(sizeof(int) * DescriptorChannel::MaxPerMessage)>;
+
+            std::shared_ptr<DescriptorChannel> descriptors;
+            alignas(cmsghdr) ControlBuffer control{};
+    };
+
+    template<typename Protocol, typename Packet>
+    std::shared_ptr<UnixSocket<Protocol>> UnixSocket<Protocol, Packet>::create(
+        std::weak_ptr<BufferContainer<Protocol>> buffer_container,
+        std::shared_ptr<DescriptorChannel> descriptors,
+        std::chrono::milliseconds send_timeout,
+        std::chrono::milliseconds receive_timeout,
+        const SocketOptions& options)
+    {
+        auto s = smooth::core::util::create_protected_shared<UnixSocket<Protocol, Packet>>(buffer_container,
+                                                                                           descriptors);
+        s->set_send_timeout(send_timeout);
+        s->set_receive_timeout(receive_timeout);
+        s->set_socket_options(options);
+
+        return s;
+    }
+
+    template<typename Protocol, typename Packet>
+    std::shared_ptr<UnixSocket<Protocol>> UnixSocket<Protocol, Packet>::create(
+        std::shared_ptr<smooth::core::network::InetAddress> ip,
+        int socket_id,
+        std::weak_ptr<BufferContainer<Protocol>> buffer_container,
+        std::shared_ptr<DescriptorChannel> descriptors,
+        std::chrono::milliseconds send_timeout,
+        std::chrono::milliseconds receive_timeout,
+        const SocketOptions& options)
+    {
+        auto s = create(buffer_container, descriptors, send_timeout, receive_timeout, options);
+        s->set_existing_socket(ip, socket_id);
+
+        return s;
+    }
+
+    template<typename Protocol, typename Packet>
+    ssize_t UnixSocket<Protocol, Packet>::socket_receive(uint8_t* buffer, size_t length)
+    {
+        iovec vector{ buffer, length };
+        msghdr message{};
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = control.data();
+        message.msg_controllen = control.size();
+
+        auto res = recvmsg(this->socket_id, &message, MSG_CMSG_CLOEXEC);
+
+        if (res > 0)
+        {
+            for (auto cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg))
+            {
+                if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+                {
+                    auto count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        int fd;
+                        memcpy(&fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(fd));
+                        descriptors->add_incoming(fd);
+                    }
+                }
+            }
+
+            if (message.msg_flags & MSG_CTRUNC)
+            {
+                this->log("Too many descriptors in a single message, some were discarded");
+            }
+        }
+
+        return res;
+    }
+
+    template<typename Protocol, typename Packet>
+    ssize_t UnixSocket<Protocol, Packet>::socket_send(const uint8_t* data, size_t length)
+    {
+        std::array<int, DescriptorChannel::MaxPerMessage> fds{};
+        auto count = descriptors->peek_outgoing(fds.data());
+
+        iovec vector{ const_cast<uint8_t*>(data), length };
+        msghdr message{};
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+
+        if (count > 0)
+        {
+            message.msg_control = control.data();
+            message.msg_controllen = CMSG_SPACE(sizeof(int) * count);
+
+            auto cmsg = CMSG_FIRSTHDR(&message);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_RIGHTS;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(int) * count);
+            memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(int) * count);
+        }
+
+        auto res = sendmsg(this->socket_id, &message, Socket<Protocol, Packet>::SEND_FLAGS);
+
+        if (res > 0 && count > 0)
+        {
+            // The descriptors have been duplicated into the peer; our copies can go.
+            descriptors->outgoing_sent(count);
+        }
+
+        return res;
+    }
+}
+
+#endif
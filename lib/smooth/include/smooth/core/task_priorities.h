@@ -29,4 +29,7 @@ namespace smooth::core
 
     const uint32_t TIMER_SERVICE_PRIO = 19;
     const uint32_t SOCKET_DISPATCHER_PRIO = 20;
+
+    // Below the dispatcher so that handshakes do not delay socket I/O.
+    const uint32_t CRYPTO_WORKER_PRIO = 18;
 }